@@ -0,0 +1,248 @@
+//
+// Minimal benchmark harness emitting JSON
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#ifndef BENCH_BENCH_HPP_INCLUDED
+#define BENCH_BENCH_HPP_INCLUDED
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bench
+{
+    // Prevents the compiler from optimizing away the computation of value
+    template<typename T>
+    inline void doNotOptimize(T const& value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static_cast<void>(*static_cast<char const volatile*>(static_cast<void const*>(&value)));
+#endif
+    }
+
+    // Forces all pending memory writes to be considered observable
+    inline void clobberMemory()
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : : "memory");
+#else
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+    }
+
+    // Passed to every benchmark function. The timed region is the range-based for
+    // loop over the state: `for (auto _ : state) { ... }`. Everything before the
+    // loop is setup and is not measured.
+    class State
+    {
+      public:
+        using Clock = std::chrono::steady_clock;
+
+        class Iterator
+        {
+          public:
+            // Type of the loop variable, which is never used by the benchmark
+            struct [[maybe_unused]] Value
+            {
+            };
+
+            Iterator(State* state, std::size_t remaining) noexcept
+                : state_{state}
+                , remaining_{remaining}
+            {
+            }
+
+            Value operator*() const noexcept
+            {
+                return {};
+            }
+
+            Iterator& operator++() noexcept
+            {
+                --remaining_;
+                return *this;
+            }
+
+            bool operator!=(Iterator const&) noexcept
+            {
+                if (remaining_ != 0)
+                {
+                    return true;
+                }
+                state_->stop();
+                return false;
+            }
+
+          private:
+            State* state_;
+            std::size_t remaining_;
+        };
+
+        explicit State(std::size_t iterations) noexcept
+            : iterations_{iterations}
+        {
+        }
+
+        [[nodiscard]] Iterator begin() noexcept
+        {
+            start_ = Clock::now();
+            return Iterator{this, iterations_};
+        }
+
+        [[nodiscard]] Iterator end() noexcept
+        {
+            return Iterator{this, 0};
+        }
+
+        [[nodiscard]] std::size_t iterations() const noexcept
+        {
+            return iterations_;
+        }
+
+        // Excludes the following code from the measurement until resumeTiming() is called
+        void pauseTiming() noexcept
+        {
+            pausedAt_ = Clock::now();
+        }
+
+        void resumeTiming() noexcept
+        {
+            paused_ += Clock::now() - pausedAt_;
+        }
+
+        // Total number of items (elements, messages, ...) processed by all iterations
+        void setItemsProcessed(std::uint64_t items) noexcept
+        {
+            items_ = items;
+        }
+
+        // Total number of bytes processed by all iterations
+        void setBytesProcessed(std::uint64_t bytes) noexcept
+        {
+            bytes_ = bytes;
+        }
+
+        // Attaches a named counter (e.g. a hit rate or a compression ratio) to the result
+        void setCounter(std::string name, double value)
+        {
+            counters_.emplace_back(std::move(name), value);
+        }
+
+        [[nodiscard]] double elapsedNanoseconds() const noexcept
+        {
+            return std::chrono::duration<double, std::nano>(stop_ - start_ - paused_).count();
+        }
+
+        [[nodiscard]] std::uint64_t itemsProcessed() const noexcept
+        {
+            return items_;
+        }
+
+        [[nodiscard]] std::uint64_t bytesProcessed() const noexcept
+        {
+            return bytes_;
+        }
+
+        [[nodiscard]] std::vector<std::pair<std::string, double>> const& counters() const noexcept
+        {
+            return counters_;
+        }
+
+      private:
+        std::size_t iterations_;
+        Clock::time_point start_{};
+        Clock::time_point stop_{};
+        Clock::time_point pausedAt_{};
+        Clock::duration paused_{};
+        std::uint64_t items_{};
+        std::uint64_t bytes_{};
+        std::vector<std::pair<std::string, double>> counters_;
+
+        void stop() noexcept
+        {
+            stop_ = Clock::now();
+        }
+    };
+
+    using Function = std::function<void(State&)>;
+
+    struct Options
+    {
+        std::string filter;              // Only run benchmarks whose name contains this string
+        double minTimeMs{50.0};          // Minimum duration of a single repetition
+        std::size_t repetitions{5};      // The median of all repetitions is reported
+        std::size_t maxIterations{1'000'000'000};
+    };
+
+    struct Result
+    {
+        std::string name;
+        std::string baseline;
+        std::size_t iterations{};
+        double nsPerOpMedian{};
+        double nsPerOpMin{};
+        double nsPerOpMax{};
+        double itemsPerSecond{};
+        double bytesPerSecond{};
+        std::vector<std::pair<std::string, double>> counters;
+    };
+
+    class Registry
+    {
+      public:
+        static Registry& instance()
+        {
+            static Registry registry;
+            return registry;
+        }
+
+        // Registers a benchmark. If baseline names another registered benchmark
+        // the result reports the ratio between both timings.
+        void add(std::string name, Function fn, std::string baseline = {})
+        {
+            benchmarks_.push_back({std::move(name), std::move(baseline), std::move(fn)});
+        }
+
+        [[nodiscard]] std::vector<Result> run(Options const& options) const;
+
+      private:
+        struct Benchmark
+        {
+            std::string name;
+            std::string baseline;
+            Function fn;
+        };
+
+        std::vector<Benchmark> benchmarks_;
+    };
+
+    // Used at namespace scope to register benchmarks during static initialization:
+    //
+    //   static bench::Registration const registration{[](bench::Registry& registry) {
+    //       registry.add("ring_buffer/push", benchPush);
+    //   }};
+    struct Registration
+    {
+        explicit Registration(void (*fn)(Registry&))
+        {
+            fn(Registry::instance());
+        }
+    };
+
+    void writeJson(std::ostream& os, Options const& options, std::vector<Result> const& results);
+} // namespace bench
+
+#endif // BENCH_BENCH_HPP_INCLUDED
@@ -0,0 +1,99 @@
+//
+// Benchmarks for AsyncLogger
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#include "bench.hpp"
+#include "async_logger.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+
+using namespace AL_NAMESPACE_NAME;
+
+namespace
+{
+    constexpr char const* sides[] = {"buy", "sell"};
+
+    // Formatting and writing on the calling thread under a mutex
+    void syncFprintf(bench::State& state)
+    {
+        auto const file = std::fopen("/dev/null", "w");
+        std::mutex mutex;
+        std::uint64_t id = 0;
+        for (auto _ : state)
+        {
+            std::lock_guard lock{mutex};
+            std::fprintf(file, "order %llu %s %d @ %.2f\n", static_cast<unsigned long long>(id), sides[id & 1], 100, 101.25);
+            ++id;
+        }
+        std::fclose(file);
+        state.setItemsProcessed(state.iterations());
+    }
+
+    // Sustained logging, the background thread has to keep up
+    template<AsyncLogFull Full>
+    void asyncLogger(bench::State& state)
+    {
+        auto const fd = ::open("/dev/null", O_WRONLY);
+        std::uint64_t dropped = 0;
+        {
+            auto logger = std::make_unique<AsyncLogger<>>(fd, Full, 1 << 20);
+            AsyncLogger<>::Producer producer{*logger};
+            std::uint64_t id = 0;
+            for (auto _ : state)
+            {
+                producer("order %llu %s %d @ %.2f\n", static_cast<unsigned long long>(id), sides[id & 1], 100, 101.25);
+                ++id;
+            }
+            dropped = producer.dropped();
+        }
+        ::close(fd);
+        state.setItemsProcessed(state.iterations());
+        state.setCounter("dropped", static_cast<double>(dropped) / static_cast<double>(state.iterations()));
+    }
+
+    // Cost on the hot thread alone: bursts which fit into the ring, the
+    // background thread writes them while the timing is paused
+    void asyncLoggerBurst(bench::State& state)
+    {
+        auto const fd = ::open("/dev/null", O_WRONLY);
+        {
+            auto logger = std::make_unique<AsyncLogger<>>(fd, AsyncLogFull::drop, 1 << 20);
+            AsyncLogger<>::Producer producer{*logger};
+            std::uint64_t id = 0;
+            for (auto _ : state)
+            {
+                producer("order %llu %s %d @ %.2f\n", static_cast<unsigned long long>(id), sides[id & 1], 100, 101.25);
+                if (++id % 8192 == 0)
+                {
+                    state.pauseTiming();
+                    logger->flush();
+                    state.resumeTiming();
+                }
+            }
+            if (producer.dropped() != 0)
+            {
+                state.setCounter("dropped", static_cast<double>(producer.dropped()));
+            }
+        }
+        ::close(fd);
+        state.setItemsProcessed(state.iterations());
+    }
+
+    bench::Registration const registration{[](bench::Registry& registry) {
+        registry.add("fprintf_mutex", syncFprintf);
+        registry.add("async_logger/block", asyncLogger<AsyncLogFull::block>, "fprintf_mutex");
+        registry.add("async_logger/drop", asyncLogger<AsyncLogFull::drop>, "fprintf_mutex");
+        registry.add("async_logger/burst", asyncLoggerBurst, "fprintf_mutex");
+    }};
+} // namespace
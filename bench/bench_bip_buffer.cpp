@@ -0,0 +1,120 @@
+//
+// Benchmarks for BipBuffer<T, N>
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#include "bench.hpp"
+#include "bip_buffer.hpp"
+#include "ring_buffer.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+
+using namespace BB_NAMESPACE_NAME;
+
+namespace
+{
+    constexpr std::size_t capacity = 64 * 1024;
+
+    // Stand-ins for an encoder writing into and a decoder reading from a contiguous region
+    void encode(std::byte* out, std::size_t size, std::uint64_t seed) noexcept
+    {
+        for (std::size_t i = 0; i < size; i += sizeof(seed))
+        {
+            std::memcpy(out + i, &seed, sizeof(seed));
+            seed = seed * 6364136223846793005u + 1442695040888963407u;
+        }
+    }
+
+    std::uint64_t decode(std::byte const* in, std::size_t size) noexcept
+    {
+        std::uint64_t sum = 0;
+        for (std::size_t i = 0; i < size; i += sizeof(sum))
+        {
+            std::uint64_t word;
+            std::memcpy(&word, in + i, sizeof(word));
+            sum += word;
+        }
+        return sum;
+    }
+
+    // Frames are encoded in place and decoded in place
+    template<std::size_t FrameSize>
+    void bipBuffer(bench::State& state)
+    {
+        auto bb = std::make_unique<BipBuffer<std::byte, capacity>>();
+        std::uint64_t seed = 0;
+        std::uint64_t checksum = 0;
+        for (auto _ : state)
+        {
+            auto out = bb->reserve(FrameSize);
+            if (out.empty())
+            {
+                auto in = bb->read();
+                checksum += decode(in.data(), in.size());
+                bb->release(in.size());
+                out = bb->reserve(FrameSize);
+            }
+            encode(out.data(), FrameSize, ++seed);
+            bb->commit(FrameSize);
+        }
+        bench::doNotOptimize(checksum);
+        state.setItemsProcessed(state.iterations());
+        state.setBytesProcessed(state.iterations() * FrameSize);
+    }
+
+    // Frames are encoded into a bounce buffer, copied into the ring element by
+    // element and copied out again into a second bounce buffer to be decoded
+    template<std::size_t FrameSize>
+    void ringBuffer(bench::State& state)
+    {
+        auto rb = std::make_unique<RingBuffer<std::byte, capacity>>();
+        std::byte encoded[FrameSize];
+        std::byte decoded[FrameSize];
+        std::uint64_t seed = 0;
+        std::uint64_t checksum = 0;
+        for (auto _ : state)
+        {
+            if (capacity - rb->size() < FrameSize)
+            {
+                while (!rb->empty())
+                {
+                    std::copy_n(rb->begin(), FrameSize, decoded);
+                    for (std::size_t i = 0; i < FrameSize; ++i)
+                    {
+                        rb->pop();
+                    }
+                    checksum += decode(decoded, FrameSize);
+                }
+            }
+            encode(encoded, FrameSize, ++seed);
+            for (auto b : encoded)
+            {
+                rb->push(b);
+            }
+        }
+        bench::doNotOptimize(checksum);
+        state.setItemsProcessed(state.iterations());
+        state.setBytesProcessed(state.iterations() * FrameSize);
+    }
+
+    template<std::size_t FrameSize>
+    void registerFrameSize(bench::Registry& registry)
+    {
+        auto const name = std::to_string(FrameSize) + "B";
+        registry.add("ring_buffer_bounce/" + name, ringBuffer<FrameSize>);
+        registry.add("bip_buffer/" + name, bipBuffer<FrameSize>, "ring_buffer_bounce/" + name);
+    }
+
+    bench::Registration const registration{[](bench::Registry& registry) {
+        registerFrameSize<256>(registry);
+        registerFrameSize<4096>(registry);
+    }};
+} // namespace
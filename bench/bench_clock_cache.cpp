@@ -0,0 +1,178 @@
+//
+// Benchmarks for ClockCache<K, V, N>
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#include "bench.hpp"
+#include "clock_cache.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace CC_NAMESPACE_NAME;
+
+namespace
+{
+    constexpr std::size_t capacity = 1 << 16;
+    constexpr std::size_t keys = 1 << 20;
+
+    // Stream of 4M keys out of 1M drawn from a Zipf distribution with
+    // exponent S / 100, scrambled so popular keys are not adjacent
+    template<int S>
+    std::vector<std::uint64_t> const& stream()
+    {
+        static auto const result = [] {
+            std::vector<double> cumulative(keys);
+            double sum = 0.0;
+            for (std::size_t k = 0; k < keys; ++k)
+            {
+                sum += 1.0 / std::pow(static_cast<double>(k + 1), S / 100.0);
+                cumulative[k] = sum;
+            }
+            std::vector<std::uint64_t> values(1 << 22);
+            std::mt19937_64 gen{42};
+            std::uniform_real_distribution<double> dist{0.0, sum};
+            for (auto& value : values)
+            {
+                auto const rank = std::lower_bound(cumulative.begin(), cumulative.end(), dist(gen)) - cumulative.begin();
+                value = static_cast<std::uint64_t>(rank) * 0x9E3779B97F4A7C15ull;
+            }
+            return values;
+        }();
+        return result;
+    }
+
+    // Classic LRU: a list in recency order and a hash map into the list
+    class LruCache
+    {
+      public:
+        std::uint64_t const* find(std::uint64_t key)
+        {
+            auto const it = map_.find(key);
+            if (it == map_.end())
+            {
+                return nullptr;
+            }
+            list_.splice(list_.begin(), list_, it->second);
+            return &it->second->second;
+        }
+
+        void insert(std::uint64_t key, std::uint64_t value)
+        {
+            if (map_.size() == capacity)
+            {
+                map_.erase(list_.back().first);
+                list_.pop_back();
+            }
+            list_.emplace_front(key, value);
+            map_.emplace(key, list_.begin());
+        }
+
+      private:
+        std::list<std::pair<std::uint64_t, std::uint64_t>> list_;
+        std::unordered_map<std::uint64_t, std::list<std::pair<std::uint64_t, std::uint64_t>>::iterator> map_;
+    };
+
+    struct FindInsert
+    {
+        template<typename Cache>
+        static bool lookup(Cache& cache, std::uint64_t key)
+        {
+            if (auto const value = cache.find(key))
+            {
+                bench::doNotOptimize(*value);
+                return true;
+            }
+            cache.insert(key, key);
+            return false;
+        }
+    };
+
+    struct GetInsert
+    {
+        template<typename Cache>
+        static bool lookup(Cache& cache, std::uint64_t key)
+        {
+            if (auto const value = cache.get(key))
+            {
+                bench::doNotOptimize(*value);
+                return true;
+            }
+            cache.insert_or_assign(key, key);
+            return false;
+        }
+    };
+
+    template<typename Cache, typename Access, int S>
+    void run(bench::State& state, Cache& cache)
+    {
+        auto const& values = stream<S>();
+        std::size_t i = 0;
+        for (; i < values.size() / 4; ++i)
+        {
+            Access::lookup(cache, values[i]);
+        }
+        std::uint64_t hits = 0;
+        for (auto _ : state)
+        {
+            hits += Access::lookup(cache, values[i++ % values.size()]);
+        }
+        state.setItemsProcessed(state.iterations());
+        state.setCounter("hit_rate", static_cast<double>(hits) / static_cast<double>(state.iterations()));
+    }
+
+    template<int S>
+    void lru(bench::State& state)
+    {
+        LruCache cache;
+        run<LruCache, FindInsert, S>(state, cache);
+    }
+
+    template<int S>
+    void clock(bench::State& state)
+    {
+        struct Cache : ClockCache<std::uint64_t, std::uint64_t, capacity>
+        {
+            void insert(std::uint64_t key, std::uint64_t value)
+            {
+                insert_or_assign(key, value);
+            }
+        };
+        auto cache = std::make_unique<Cache>();
+        run<Cache, FindInsert, S>(state, *cache);
+    }
+
+    template<int S>
+    void sharded(bench::State& state)
+    {
+        using Cache = ShardedClockCache<std::uint64_t, std::uint64_t, capacity, 16>;
+        auto cache = std::make_unique<Cache>();
+        run<Cache, GetInsert, S>(state, *cache);
+    }
+
+    template<int S>
+    void registerWorkload(bench::Registry& registry, std::string const& name)
+    {
+        registry.add("lru_list_map/" + name, lru<S>);
+        registry.add("clock_cache/" + name, clock<S>, "lru_list_map/" + name);
+        registry.add("sharded_clock_cache/" + name, sharded<S>, "lru_list_map/" + name);
+    }
+
+    bench::Registration const registration{[](bench::Registry& registry) {
+        registerWorkload<80>(registry, "zipf_0.8");
+        registerWorkload<99>(registry, "zipf_0.99");
+        registerWorkload<120>(registry, "zipf_1.2");
+    }};
+} // namespace
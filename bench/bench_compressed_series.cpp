@@ -0,0 +1,139 @@
+//
+// Benchmarks for CompressedSeries<BlockSize, Blocks>
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#include "bench.hpp"
+#include "compressed_series.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace CS_NAMESPACE_NAME;
+
+namespace
+{
+    // Both hold 1 MB
+    using series_type = CompressedSeries<4096, 256>;
+    using raw_type = RingBuffer<std::pair<std::int64_t, double>, 65536>;
+
+    // One point per second of a gauge which changes every few seconds by a
+    // small step, like CPU load or queue depth, or of random doubles
+    std::vector<CompressedPoint> const& stream(bool gauge)
+    {
+        static std::vector<CompressedPoint> points[2];
+        auto& result = points[gauge];
+        if (result.empty())
+        {
+            std::mt19937_64 gen{42};
+            std::uniform_real_distribution<double> uniform{0.0, 1000.0};
+            std::int64_t time = 1'600'000'000;
+            double value = 50.0;
+            for (std::size_t i = 0; i < (1 << 20); ++i)
+            {
+                time += gen() % 100 == 0 ? 2 : 1;
+                if (gauge && gen() % 4 == 0)
+                {
+                    value = std::round(value + uniform(gen) / 100.0 - 5.0);
+                }
+                result.push_back({time, gauge ? value : uniform(gen)});
+            }
+        }
+        return result;
+    }
+
+    template<bool Gauge>
+    void rawPush(bench::State& state)
+    {
+        auto const& points = stream(Gauge);
+        auto raw = std::make_unique<raw_type>();
+        std::size_t i = 0;
+        for (auto _ : state)
+        {
+            auto const& point = points[i++ % points.size()];
+            raw->push({point.time, point.value});
+        }
+        state.setItemsProcessed(state.iterations());
+        state.setCounter("bytes_per_point", static_cast<double>(sizeof(raw_type::value_type)));
+    }
+
+    template<bool Gauge>
+    void seriesPush(bench::State& state)
+    {
+        auto const& points = stream(Gauge);
+        auto series = std::make_unique<series_type>();
+        std::size_t i = 0;
+        for (auto _ : state)
+        {
+            auto const& point = points[i++ % points.size()];
+            series->push(point.time, point.value);
+        }
+        state.setItemsProcessed(state.iterations());
+        state.setCounter("bytes_per_point", static_cast<double>(series->encoded_bytes()) / static_cast<double>(series->size()));
+        state.setCounter("points", static_cast<double>(series->size()));
+    }
+
+    template<bool Gauge>
+    void rawScan(bench::State& state)
+    {
+        auto const& points = stream(Gauge);
+        auto raw = std::make_unique<raw_type>();
+        for (auto const& point : points)
+        {
+            raw->push({point.time, point.value});
+        }
+        for (auto _ : state)
+        {
+            double sum = 0.0;
+            for (auto const& [time, value] : *raw)
+            {
+                sum += value;
+            }
+            bench::doNotOptimize(sum);
+        }
+        state.setItemsProcessed(state.iterations() * raw->size());
+        state.setCounter("points", static_cast<double>(raw->size()));
+    }
+
+    template<bool Gauge>
+    void seriesScan(bench::State& state)
+    {
+        auto const& points = stream(Gauge);
+        auto series = std::make_unique<series_type>();
+        for (auto const& point : points)
+        {
+            series->push(point.time, point.value);
+        }
+        for (auto _ : state)
+        {
+            double sum = 0.0;
+            for (auto const& [time, value] : *series)
+            {
+                sum += value;
+            }
+            bench::doNotOptimize(sum);
+        }
+        state.setItemsProcessed(state.iterations() * series->size());
+        state.setCounter("points", static_cast<double>(series->size()));
+        state.setCounter("compression", 16.0 * static_cast<double>(series->size()) / static_cast<double>(series->encoded_bytes()));
+    }
+
+    bench::Registration const registration{[](bench::Registry& registry) {
+        registry.add("ring_buffer_points/push_gauge", rawPush<true>);
+        registry.add("compressed_series/push_gauge", seriesPush<true>, "ring_buffer_points/push_gauge");
+        registry.add("ring_buffer_points/push_random", rawPush<false>);
+        registry.add("compressed_series/push_random", seriesPush<false>, "ring_buffer_points/push_random");
+        registry.add("ring_buffer_points/scan_gauge", rawScan<true>);
+        registry.add("compressed_series/scan_gauge", seriesScan<true>, "ring_buffer_points/scan_gauge");
+        registry.add("ring_buffer_points/scan_random", rawScan<false>);
+        registry.add("compressed_series/scan_random", seriesScan<false>, "ring_buffer_points/scan_random");
+    }};
+} // namespace
@@ -0,0 +1,105 @@
+//
+// Benchmarks for DedupWindow<Key, N>
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#include "bench.hpp"
+#include "dedup_window.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace DW_NAMESPACE_NAME;
+
+namespace
+{
+    constexpr std::size_t window = 1 << 16;
+    constexpr std::size_t ids = 10'000'000;
+
+    // 10M message IDs of which percent percent retransmit one of the last
+    // window / 2 new IDs. Only the stream of one rate is kept at a time.
+    std::vector<std::uint64_t> const& stream(int percent)
+    {
+        static std::vector<std::uint64_t> values;
+        static int current = -1;
+        if (current != percent)
+        {
+            values.clear();
+            values.reserve(ids);
+            std::mt19937_64 gen{42};
+            std::uint64_t next = 0;
+            for (std::size_t i = 0; i < ids; ++i)
+            {
+                auto const retransmit = next > window && static_cast<int>(gen() % 100) < percent;
+                auto const counter = retransmit ? next - 1 - gen() % (window / 2) : next++;
+                values.push_back(counter * 0x9E3779B97F4A7C15ull);
+            }
+            current = percent;
+        }
+        return values;
+    }
+
+    // RingBuffer for expiry paired with a node based set
+    template<int Percent>
+    void unorderedSet(bench::State& state)
+    {
+        auto const& values = stream(Percent);
+        auto order = std::make_unique<RingBuffer<std::uint64_t, window>>();
+        std::unordered_set<std::uint64_t> seen;
+        std::size_t i = 0;
+        std::size_t accepted = 0;
+        for (auto _ : state)
+        {
+            auto const id = values[i++ % values.size()];
+            if (seen.insert(id).second)
+            {
+                if (order->full())
+                {
+                    seen.erase(order->front());
+                }
+                order->push(id);
+                ++accepted;
+            }
+        }
+        state.setItemsProcessed(state.iterations());
+        state.setCounter("accepted", static_cast<double>(accepted) / static_cast<double>(state.iterations()));
+    }
+
+    template<int Percent>
+    void dedupWindow(bench::State& state)
+    {
+        auto const& values = stream(Percent);
+        auto seen = std::make_unique<DedupWindow<std::uint64_t, window>>();
+        std::size_t i = 0;
+        std::size_t accepted = 0;
+        for (auto _ : state)
+        {
+            accepted += seen->insert(values[i++ % values.size()]);
+        }
+        state.setItemsProcessed(state.iterations());
+        state.setCounter("accepted", static_cast<double>(accepted) / static_cast<double>(state.iterations()));
+    }
+
+    template<int Percent>
+    void registerRate(bench::Registry& registry)
+    {
+        auto const name = "duplicates_" + std::to_string(Percent) + "%";
+        registry.add("unordered_set_window/" + name, unorderedSet<Percent>);
+        registry.add("dedup_window/" + name, dedupWindow<Percent>, "unordered_set_window/" + name);
+    }
+
+    bench::Registration const registration{[](bench::Registry& registry) {
+        registerRate<0>(registry);
+        registerRate<1>(registry);
+        registerRate<5>(registry);
+        registerRate<20>(registry);
+    }};
+} // namespace
@@ -0,0 +1,114 @@
+//
+// Benchmarks for DelayLine<T, N> and FirFilter<N>
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#include "bench.hpp"
+#include "delay_line.hpp"
+#include "ring_buffer.hpp"
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace DL_NAMESPACE_NAME;
+
+namespace
+{
+    constexpr std::size_t capacity = 512;
+
+    std::vector<float> const& samples()
+    {
+        static auto const result = [] {
+            std::vector<float> values(1 << 16);
+            std::mt19937 gen{42};
+            std::uniform_real_distribution<float> dist{-1.0f, 1.0f};
+            for (auto& value : values)
+            {
+                value = dist(gen);
+            }
+            return values;
+        }();
+        return result;
+    }
+
+    std::vector<float> coefficients(std::size_t taps)
+    {
+        std::vector<float> result(taps);
+        for (std::size_t k = 0; k < taps; ++k)
+        {
+            result[k] = 1.0f / static_cast<float>(k + 1);
+        }
+        return result;
+    }
+
+    // The samples in a RingBuffer, each output iterates the last taps samples
+    template<std::size_t Taps>
+    void ringIterator(bench::State& state)
+    {
+        auto const& input = samples();
+        auto const h = coefficients(Taps);
+        auto ring = std::make_unique<::RB_NAMESPACE_NAME::RingBuffer<float, capacity>>();
+        for (std::size_t i = 0; i < capacity; ++i)
+        {
+            ring->push(0.0f);
+        }
+        std::size_t i = 0;
+        for (auto _ : state)
+        {
+            ring->push(input[i++ % input.size()]);
+            float output = 0.0f;
+            auto it = ring->end();
+            for (std::size_t k = 0; k < Taps; ++k)
+            {
+                output += h[k] * *--it;
+            }
+            bench::doNotOptimize(output);
+        }
+        state.setItemsProcessed(state.iterations());
+    }
+
+    template<std::size_t Taps, int Level>
+    void firFilter(bench::State& state)
+    {
+        auto const& input = samples();
+        auto filter = std::make_unique<FirFilter<capacity>>(coefficients(Taps));
+        std::size_t i = 0;
+        for (auto _ : state)
+        {
+            auto const output = Level < 0 ? filter->process(input[i++ % input.size()])
+                                          : filter->process(static_cast<SimdLevel>(Level), input[i++ % input.size()]);
+            bench::doNotOptimize(output);
+        }
+        state.setItemsProcessed(state.iterations());
+    }
+
+    template<std::size_t Taps>
+    void registerTaps(bench::Registry& registry)
+    {
+        auto const name = std::to_string(Taps) + "_taps";
+        registry.add("ring_iterator_fir/" + name, ringIterator<Taps>);
+        registry.add("fir_filter/scalar/" + name, firFilter<Taps, static_cast<int>(SimdLevel::scalar)>, "ring_iterator_fir/" + name);
+        if (simd_level() >= SimdLevel::sse)
+        {
+            registry.add("fir_filter/sse/" + name, firFilter<Taps, static_cast<int>(SimdLevel::sse)>, "ring_iterator_fir/" + name);
+        }
+        if (simd_level() >= SimdLevel::avx2)
+        {
+            registry.add("fir_filter/avx2/" + name, firFilter<Taps, static_cast<int>(SimdLevel::avx2)>, "ring_iterator_fir/" + name);
+        }
+        registry.add("fir_filter/dispatched/" + name, firFilter<Taps, -1>, "ring_iterator_fir/" + name);
+    }
+
+    bench::Registration const registration{[](bench::Registry& registry) {
+        registerTaps<16>(registry);
+        registerTaps<64>(registry);
+        registerTaps<256>(registry);
+        registerTaps<512>(registry);
+    }};
+} // namespace
@@ -0,0 +1,97 @@
+//
+// Benchmarks for HugePageResource
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#include "bench.hpp"
+#include "huge_page_resource.hpp"
+#include "unique_buffer.hpp"
+
+#include <cstring>
+
+using namespace HP_NAMESPACE_NAME;
+
+namespace
+{
+    constexpr std::size_t bufferSize = std::size_t{256} << 20;
+    constexpr std::size_t count = bufferSize / sizeof(std::uint64_t);
+    constexpr std::size_t randomReads = 1 << 20;
+
+    UniqueBuffer makeBuffer(std::pmr::memory_resource* memres)
+    {
+        UniqueBuffer ub{bufferSize, memres, 4096};
+        std::memset(ub.get(), 1, bufferSize);
+        return ub;
+    }
+
+    void sequential(bench::State& state, std::pmr::memory_resource* memres)
+    {
+        auto ub = makeBuffer(memres);
+        auto const values = ub.as<std::uint64_t>();
+        for (auto _ : state)
+        {
+            std::uint64_t sum = 0;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                sum += values[i];
+            }
+            bench::doNotOptimize(sum);
+        }
+        state.setBytesProcessed(state.iterations() * bufferSize);
+    }
+
+    // Independent loads at pseudo random positions; dominated by TLB and cache misses
+    void random(bench::State& state, std::pmr::memory_resource* memres)
+    {
+        auto ub = makeBuffer(memres);
+        auto const values = ub.as<std::uint64_t>();
+        std::uint64_t x = 88172645463325252ull;
+        for (auto _ : state)
+        {
+            std::uint64_t sum = 0;
+            for (std::size_t i = 0; i < randomReads; ++i)
+            {
+                x ^= x << 13;
+                x ^= x >> 7;
+                x ^= x << 17;
+                sum += values[x & (count - 1)];
+            }
+            bench::doNotOptimize(sum);
+        }
+        state.setItemsProcessed(state.iterations() * randomReads);
+    }
+
+    void regularSequential(bench::State& state)
+    {
+        sequential(state, std::pmr::new_delete_resource());
+    }
+
+    void regularRandom(bench::State& state)
+    {
+        random(state, std::pmr::new_delete_resource());
+    }
+
+    void hugeSequential(bench::State& state)
+    {
+        HugePageResource memres{{HugePageSize::Size2MB, true}};
+        sequential(state, &memres);
+    }
+
+    void hugeRandom(bench::State& state)
+    {
+        HugePageResource memres{{HugePageSize::Size2MB, true}};
+        random(state, &memres);
+    }
+
+    bench::Registration const registration{[](bench::Registry& registry) {
+        registry.add("huge_page_resource/sequential/regular_pages", regularSequential);
+        registry.add(
+            "huge_page_resource/sequential/huge_pages", hugeSequential, "huge_page_resource/sequential/regular_pages");
+        registry.add("huge_page_resource/random/regular_pages", regularRandom);
+        registry.add("huge_page_resource/random/huge_pages", hugeRandom, "huge_page_resource/random/regular_pages");
+    }};
+} // namespace
@@ -0,0 +1,64 @@
+//
+// Benchmarks for LatencyHistogram and RingBufferLatency
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#include "bench.hpp"
+#include "latency_histogram.hpp"
+#include "ring_buffer.hpp"
+
+#include <memory>
+
+using namespace LH_NAMESPACE_NAME;
+
+namespace
+{
+    void record(bench::State& state)
+    {
+        auto histogram = std::make_unique<LatencyHistogram>();
+        std::uint64_t value = 12345;
+        for (auto _ : state)
+        {
+            histogram->record(value);
+            value = value * 6364136223846793005ull + 1442695040888963407ull;
+            value >>= 40;
+        }
+        state.setItemsProcessed(state.iterations());
+    }
+
+    template<std::size_t Slots>
+    using SteadyLatency = RingBufferLatency<Slots, SteadyTickClock>;
+
+    template<template<std::size_t> class Policy>
+    void pushPop(bench::State& state)
+    {
+        auto rb = std::make_unique<RingBuffer<std::uint64_t, 1024, Policy>>();
+        for (std::uint64_t i = 0; i < 512; ++i)
+        {
+            rb->push(i);
+        }
+        std::uint64_t value = 0;
+        for (auto _ : state)
+        {
+            rb->push(value++);
+            bench::doNotOptimize(rb->front());
+            rb->pop();
+        }
+        state.setItemsProcessed(state.iterations());
+    }
+
+    bench::Registration const registration{[](bench::Registry& registry) {
+        registry.add("latency_histogram/record", record);
+        registry.add("ring_buffer_latency/null/push_pop", pushPop<RingBufferNullPolicy>);
+        registry.add(
+            "ring_buffer_latency/default_clock/push_pop",
+            pushPop<RingBufferLatency>,
+            "ring_buffer_latency/null/push_pop");
+        registry.add(
+            "ring_buffer_latency/steady_clock/push_pop", pushPop<SteadyLatency>, "ring_buffer_latency/null/push_pop");
+    }};
+} // namespace
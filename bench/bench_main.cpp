@@ -0,0 +1,259 @@
+//
+// Benchmark driver for utl
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+// Usage: utl_bench [--filter=<substring>] [--min-time=<ms>] [--repetitions=<n>] [--out=<file>]
+//
+// Results are written as JSON to stdout (or the file given by --out). Every
+// benchmark reports the median, minimum and maximum time per iteration over
+// all repetitions. Benchmarks registered with a baseline additionally report
+// "relative_to_baseline", the ratio of their median to the baseline's median.
+// Values above 1.0 mean slower than the baseline.
+//
+
+#include "bench.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+
+namespace bench
+{
+    namespace
+    {
+        double runOnce(Function const& fn, std::size_t iterations, State* keep = nullptr)
+        {
+            State state{iterations};
+            fn(state);
+            auto const elapsed = state.elapsedNanoseconds();
+            if (keep != nullptr)
+            {
+                *keep = std::move(state);
+            }
+            return elapsed;
+        }
+
+        std::size_t calibrate(Function const& fn, Options const& options)
+        {
+            auto const target = options.minTimeMs * 1e6;
+            std::size_t iterations = 1;
+            for (;;)
+            {
+                auto const elapsed = runOnce(fn, iterations);
+                if (elapsed >= target || iterations >= options.maxIterations)
+                {
+                    return iterations;
+                }
+                // Grow towards the target but never more than tenfold per step
+                auto const factor = elapsed > 0.0 ? std::min(10.0, 1.4 * target / elapsed) : 10.0;
+                auto const next = static_cast<std::size_t>(static_cast<double>(iterations) * factor);
+                iterations = std::min(options.maxIterations, std::max(iterations + 1, next));
+            }
+        }
+
+        void writeString(std::ostream& os, std::string const& s)
+        {
+            os << '"';
+            for (auto c : s)
+            {
+                switch (c)
+                {
+                    case '"':
+                        os << "\\\"";
+                        break;
+                    case '\\':
+                        os << "\\\\";
+                        break;
+                    case '\n':
+                        os << "\\n";
+                        break;
+                    default:
+                        os << c;
+                        break;
+                }
+            }
+            os << '"';
+        }
+
+        char const* compilerName()
+        {
+#if defined(__clang__)
+            return "clang " __clang_version__;
+#elif defined(__GNUC__)
+            return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+            return "msvc";
+#else
+            return "unknown";
+#endif
+        }
+
+        bool parseOption(char const* arg, char const* name, char const*& value)
+        {
+            auto const length = std::strlen(name);
+            if (std::strncmp(arg, name, length) == 0 && arg[length] == '=')
+            {
+                value = arg + length + 1;
+                return true;
+            }
+            return false;
+        }
+    } // namespace
+
+    std::vector<Result> Registry::run(Options const& options) const
+    {
+        std::vector<Result> results;
+        for (auto const& benchmark : benchmarks_)
+        {
+            if (!options.filter.empty() && benchmark.name.find(options.filter) == std::string::npos)
+            {
+                continue;
+            }
+            std::cerr << benchmark.name << std::endl;
+
+            auto const iterations = calibrate(benchmark.fn, options);
+            std::vector<double> samples;
+            State last{iterations};
+            for (std::size_t i = 0; i < std::max<std::size_t>(1, options.repetitions); ++i)
+            {
+                samples.push_back(runOnce(benchmark.fn, iterations, &last) / static_cast<double>(iterations));
+            }
+            std::sort(samples.begin(), samples.end());
+
+            Result result;
+            result.name = benchmark.name;
+            result.baseline = benchmark.baseline;
+            result.iterations = iterations;
+            result.nsPerOpMedian = samples[samples.size() / 2];
+            result.nsPerOpMin = samples.front();
+            result.nsPerOpMax = samples.back();
+            auto const seconds = result.nsPerOpMedian * static_cast<double>(iterations) * 1e-9;
+            if (seconds > 0.0)
+            {
+                result.itemsPerSecond = static_cast<double>(last.itemsProcessed()) / seconds;
+                result.bytesPerSecond = static_cast<double>(last.bytesProcessed()) / seconds;
+            }
+            result.counters = last.counters();
+            results.push_back(std::move(result));
+        }
+        return results;
+    }
+
+    void writeJson(std::ostream& os, Options const& options, std::vector<Result> const& results)
+    {
+        std::map<std::string, double> medians;
+        for (auto const& result : results)
+        {
+            medians[result.name] = result.nsPerOpMedian;
+        }
+
+        char date[32]{};
+        auto const now = std::time(nullptr);
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+        os << std::setprecision(6) << std::fixed;
+        os << "{\n  \"context\": {\n";
+        os << "    \"date\": ";
+        writeString(os, date);
+        os << ",\n    \"compiler\": ";
+        writeString(os, compilerName());
+#ifdef NDEBUG
+        os << ",\n    \"build_type\": \"release\"";
+#else
+        os << ",\n    \"build_type\": \"debug\"";
+#endif
+        os << ",\n    \"min_time_ms\": " << options.minTimeMs;
+        os << ",\n    \"repetitions\": " << options.repetitions;
+        os << "\n  },\n  \"benchmarks\": [";
+
+        char const* separator = "\n";
+        for (auto const& result : results)
+        {
+            os << separator << "    {\n      \"name\": ";
+            writeString(os, result.name);
+            os << ",\n      \"iterations\": " << result.iterations;
+            os << ",\n      \"ns_per_op\": " << result.nsPerOpMedian;
+            os << ",\n      \"ns_per_op_min\": " << result.nsPerOpMin;
+            os << ",\n      \"ns_per_op_max\": " << result.nsPerOpMax;
+            if (result.itemsPerSecond > 0.0)
+            {
+                os << ",\n      \"items_per_second\": " << result.itemsPerSecond;
+            }
+            if (result.bytesPerSecond > 0.0)
+            {
+                os << ",\n      \"bytes_per_second\": " << result.bytesPerSecond;
+            }
+            for (auto const& [name, value] : result.counters)
+            {
+                os << ",\n      ";
+                writeString(os, name);
+                os << ": " << value;
+            }
+            if (!result.baseline.empty())
+            {
+                os << ",\n      \"baseline\": ";
+                writeString(os, result.baseline);
+                if (auto it = medians.find(result.baseline); it != medians.end() && it->second > 0.0)
+                {
+                    os << ",\n      \"relative_to_baseline\": " << result.nsPerOpMedian / it->second;
+                }
+            }
+            os << "\n    }";
+            separator = ",\n";
+        }
+        os << "\n  ]\n}\n";
+    }
+} // namespace bench
+
+int main(int argc, char* argv[])
+{
+    bench::Options options;
+    std::string out;
+    for (int i = 1; i < argc; ++i)
+    {
+        char const* value = nullptr;
+        if (bench::parseOption(argv[i], "--filter", value))
+        {
+            options.filter = value;
+        }
+        else if (bench::parseOption(argv[i], "--min-time", value))
+        {
+            options.minTimeMs = std::atof(value);
+        }
+        else if (bench::parseOption(argv[i], "--repetitions", value))
+        {
+            options.repetitions = static_cast<std::size_t>(std::atol(value));
+        }
+        else if (bench::parseOption(argv[i], "--out", value))
+        {
+            out = value;
+        }
+        else
+        {
+            std::cerr << "usage: " << argv[0]
+                      << " [--filter=<substring>] [--min-time=<ms>] [--repetitions=<n>] [--out=<file>]\n";
+            return 1;
+        }
+    }
+
+    auto const results = bench::Registry::instance().run(options);
+    if (out.empty())
+    {
+        bench::writeJson(std::cout, options, results);
+    }
+    else
+    {
+        std::ofstream file{out};
+        bench::writeJson(file, options, results);
+    }
+    return 0;
+}
@@ -0,0 +1,121 @@
+//
+// Benchmarks for ObjectPool and LockFreeObjectPool
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#include "bench.hpp"
+#include "object_pool.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+using namespace OP_NAMESPACE_NAME;
+
+namespace
+{
+    constexpr std::size_t liveObjects = 10000;
+    constexpr std::size_t poolSize = 16384;
+
+    struct Order
+    {
+        Order(std::uint64_t id, std::int64_t price, std::uint32_t quantity) noexcept
+            : id{id}
+            , price{price}
+            , quantity{quantity}
+        {
+        }
+
+        std::uint64_t id;
+        std::int64_t price;
+        std::uint32_t quantity;
+        std::uint32_t flags{};
+        char symbol[40]{};
+    };
+
+    // Keeps liveObjects orders alive and replaces a pseudo randomly chosen one
+    // per iteration, which scatters the free slots like a real order book does
+    template<typename Create, typename Destroy>
+    void churn(bench::State& state, Create create, Destroy destroy)
+    {
+        std::vector<Order*> live;
+        for (std::size_t i = 0; i < liveObjects; ++i)
+        {
+            live.push_back(create(i));
+        }
+        std::uint64_t id = liveObjects;
+        std::uint32_t random = 12345;
+        for (auto _ : state)
+        {
+            random = random * 1664525 + 1013904223;
+            auto& slot = live[(random >> 8) % liveObjects];
+            destroy(slot);
+            slot = create(++id);
+            bench::doNotOptimize(slot);
+        }
+        for (auto p : live)
+        {
+            destroy(p);
+        }
+        state.setItemsProcessed(state.iterations());
+    }
+
+    void newDelete(bench::State& state)
+    {
+        churn(
+            state, [](std::uint64_t id) { return new Order{id, 100, 10}; }, [](Order* p) { delete p; });
+    }
+
+    void poolResource(bench::State& state)
+    {
+        std::pmr::unsynchronized_pool_resource memres;
+        std::pmr::polymorphic_allocator<Order> allocator{&memres};
+        churn(
+            state,
+            [&](std::uint64_t id) { return allocator.new_object<Order>(id, 100, 10); },
+            [&](Order* p) { allocator.delete_object(p); });
+    }
+
+    template<typename Pool>
+    void objectPool(bench::State& state)
+    {
+        auto pool = std::make_unique<Pool>();
+        churn(
+            state, [&](std::uint64_t id) { return pool->construct(id, 100, 10); }, [&](Order* p) { pool->release(p); });
+    }
+
+    // Same with handles, the deleter adds no cost over raw pointers
+    void objectPoolHandle(bench::State& state)
+    {
+        auto pool = std::make_unique<ObjectPool<Order, poolSize>>();
+        std::vector<ObjectPool<Order, poolSize>::handle_type> live;
+        for (std::size_t i = 0; i < liveObjects; ++i)
+        {
+            live.push_back(pool->acquire(i, 100, 10));
+        }
+        std::uint64_t id = liveObjects;
+        std::uint32_t random = 12345;
+        for (auto _ : state)
+        {
+            random = random * 1664525 + 1013904223;
+            auto& slot = live[(random >> 8) % liveObjects];
+            slot.reset();
+            slot = pool->acquire(++id, 100, 10);
+            bench::doNotOptimize(slot);
+        }
+        state.setItemsProcessed(state.iterations());
+    }
+
+    bench::Registration const registration{[](bench::Registry& registry) {
+        registry.add("new_delete/churn", newDelete);
+        registry.add("unsynchronized_pool_resource/churn", poolResource, "new_delete/churn");
+        registry.add("object_pool/churn", objectPool<ObjectPool<Order, poolSize>>, "new_delete/churn");
+        registry.add("object_pool/churn_handle", objectPoolHandle, "new_delete/churn");
+        registry.add("lock_free_object_pool/churn", objectPool<LockFreeObjectPool<Order, poolSize>>, "new_delete/churn");
+    }};
+} // namespace
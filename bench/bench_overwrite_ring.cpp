@@ -0,0 +1,126 @@
+//
+// Benchmarks for OverwriteRing<T, N>
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#include "bench.hpp"
+#include "overwrite_ring.hpp"
+#include "ring_buffer.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace OW_NAMESPACE_NAME;
+
+namespace
+{
+    constexpr std::size_t capacity = 4096;
+
+    struct Sample
+    {
+        std::uint64_t time;
+        std::uint64_t id;
+        double value;
+    };
+
+    // RingBuffer::push() overwrites the oldest sample, a mutex makes it thread safe
+    struct LockedRing
+    {
+        std::mutex mutex;
+        ::RB_NAMESPACE_NAME::RingBuffer<Sample, capacity> ring;
+
+        void push(Sample const& sample)
+        {
+            std::lock_guard lock{mutex};
+            ring.push(sample);
+        }
+    };
+
+    // The benchmark thread and threads - 1 further threads push into the same
+    // ring, while one reader drains it
+    template<typename Ring>
+    void contended(bench::State& state, std::size_t threads)
+    {
+        auto ring = std::make_unique<Ring>();
+        std::atomic<bool> stop{};
+        std::vector<std::thread> others;
+        for (std::size_t t = 1; t < threads; ++t)
+        {
+            others.emplace_back([&, t] {
+                for (std::uint64_t i = 0; !stop.load(std::memory_order_relaxed); ++i)
+                {
+                    ring->push(Sample{i, t, 1.0});
+                }
+            });
+        }
+        std::uint64_t read = 0;
+        if constexpr (std::is_same_v<Ring, OverwriteRing<Sample, capacity>>)
+        {
+            others.emplace_back([&] {
+                typename Ring::Reader reader{*ring};
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    read += reader.drain([](Sample const& sample) { bench::doNotOptimize(sample.value); });
+                }
+            });
+        }
+        else
+        {
+            others.emplace_back([&] {
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    std::lock_guard lock{ring->mutex};
+                    for (; !ring->ring.empty(); ++read)
+                    {
+                        bench::doNotOptimize(ring->ring.front().value);
+                        ring->ring.pop();
+                    }
+                }
+            });
+        }
+
+        std::uint64_t i = 0;
+        for (auto _ : state)
+        {
+            ring->push(Sample{i++, 0, 1.0});
+        }
+        stop = true;
+        for (auto& thread : others)
+        {
+            thread.join();
+        }
+        state.setItemsProcessed(state.iterations());
+        state.setCounter("threads", static_cast<double>(threads));
+        state.setCounter("read", static_cast<double>(read) / static_cast<double>(state.iterations()));
+    }
+
+    void registerThreads(bench::Registry& registry, std::size_t threads)
+    {
+        auto const name = std::to_string(threads) + "_producers";
+        registry.add("locked_ring_buffer/" + name, [threads](bench::State& state) { contended<LockedRing>(state, threads); });
+        registry.add(
+            "overwrite_ring/" + name, [threads](bench::State& state) { contended<OverwriteRing<Sample, capacity>>(state, threads); },
+            "locked_ring_buffer/" + name);
+    }
+
+    bench::Registration const registration{[](bench::Registry& registry) {
+        auto const hardware = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+        registerThreads(registry, 1);
+        registerThreads(registry, 4);
+        if (hardware > 4)
+        {
+            // Full contention, every hardware thread pushes
+            registerThreads(registry, hardware);
+        }
+    }};
+} // namespace
@@ -0,0 +1,277 @@
+//
+// Benchmarks for PerCpuRing<T, N>
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#include "bench.hpp"
+#include "overwrite_ring.hpp"
+#include "per_cpu_ring.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+using namespace PC_NAMESPACE_NAME;
+
+namespace
+{
+    constexpr std::size_t capacity = 4096;
+
+    struct Sample
+    {
+        std::uint64_t time;
+        std::uint64_t id;
+        double value;
+    };
+
+    // Single producer ring of the same layout for each thread
+    class PerThreadRings
+    {
+      public:
+        explicit PerThreadRings(std::size_t threads)
+            : rings_{new Ring[threads]}
+            , count_{threads}
+        {
+        }
+
+        bool push(std::size_t thread, Sample const& sample) noexcept
+        {
+            auto& ring = rings_[thread];
+            auto const tail = ring.tail.load(std::memory_order_relaxed);
+            if (tail - ring.head.load(std::memory_order_acquire) >= capacity)
+            {
+                return false;
+            }
+            ring.samples[tail & (capacity - 1)] = sample;
+            ring.tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        template<typename Fn>
+        std::size_t drain(Fn&& fn) noexcept
+        {
+            std::size_t result = 0;
+            for (std::size_t i = 0; i < count_; ++i)
+            {
+                auto& ring = rings_[i];
+                auto head = ring.head.load(std::memory_order_relaxed);
+                auto const tail = ring.tail.load(std::memory_order_acquire);
+                for (; head != tail; ++head, ++result)
+                {
+                    fn(ring.samples[head & (capacity - 1)]);
+                }
+                ring.head.store(head, std::memory_order_release);
+            }
+            return result;
+        }
+
+        [[nodiscard]] std::size_t bytes() const noexcept
+        {
+            return count_ * sizeof(Ring);
+        }
+
+      private:
+        struct alignas(64) Ring
+        {
+            std::atomic<std::uint64_t> tail{};
+            alignas(64) std::atomic<std::uint64_t> head{};
+            alignas(64) Sample samples[capacity];
+        };
+
+        std::unique_ptr<Ring[]> rings_;
+        std::size_t count_;
+    };
+
+    enum class Kind
+    {
+        perCpuRseq,
+        perCpuAtomic,
+        perThread,
+        singleRing
+    };
+
+    template<Kind K>
+    auto makeRings(std::size_t threads)
+    {
+        if constexpr (K == Kind::perCpuRseq || K == Kind::perCpuAtomic)
+        {
+            return std::make_unique<PerCpuRing<Sample, capacity>>(K == Kind::perCpuRseq);
+        }
+        else if constexpr (K == Kind::perThread)
+        {
+            return std::make_unique<PerThreadRings>(threads);
+        }
+        else
+        {
+            return std::make_unique<::OW_NAMESPACE_NAME::OverwriteRing<Sample, capacity>>();
+        }
+    }
+
+    template<Kind K, typename Rings>
+    bool push(Rings& rings, std::size_t thread, Sample const& sample) noexcept
+    {
+        if constexpr (K == Kind::perThread)
+        {
+            return rings.push(thread, sample);
+        }
+        else if constexpr (K == Kind::singleRing)
+        {
+            rings.push(sample);
+            return true;
+        }
+        else
+        {
+            return rings.push(sample);
+        }
+    }
+
+    // Drains the rings by one collector thread
+    template<Kind K, typename Rings>
+    class Collector
+    {
+      public:
+        explicit Collector(Rings& rings) noexcept
+            : rings_{rings}
+        {
+        }
+
+        std::size_t operator()() noexcept
+        {
+            return rings_.drain([](Sample const& sample) { bench::doNotOptimize(sample.value); });
+        }
+
+      private:
+        Rings& rings_;
+    };
+
+    template<typename Rings>
+    class Collector<Kind::singleRing, Rings>
+    {
+      public:
+        explicit Collector(Rings& rings) noexcept
+            : reader_{rings}
+        {
+        }
+
+        std::size_t operator()() noexcept
+        {
+            return reader_.drain([](Sample const& sample) { bench::doNotOptimize(sample.value); });
+        }
+
+      private:
+        typename Rings::Reader reader_;
+    };
+
+    // The benchmark thread and threads - 1 further threads push, a collector
+    // thread drains the rings. Producers yield to the collector while their
+    // ring is full. The further threads keep pace with the benchmark thread,
+    // as otherwise those sharing its ring could take every slot the collector
+    // frees. A single producer drains the rings itself after every capacity
+    // elements, which measures push() and drain() without the scheduler.
+    template<Kind K>
+    void contended(bench::State& state, std::size_t threads)
+    {
+        auto rings = makeRings<K>(threads);
+        Collector<K, std::remove_reference_t<decltype(*rings)>> collector{*rings};
+        std::atomic<bool> stop{};
+        std::atomic<std::uint64_t> pace{};
+        std::vector<std::thread> others;
+        for (std::size_t t = 1; t < threads; ++t)
+        {
+            others.emplace_back([&, t] {
+                for (std::uint64_t i = 0; !stop.load(std::memory_order_relaxed);)
+                {
+                    if (i < pace.load(std::memory_order_relaxed) + 64 && push<K>(*rings, t, Sample{i, t, 1.0}))
+                    {
+                        ++i;
+                        continue;
+                    }
+                    std::this_thread::yield();
+                }
+            });
+        }
+        if (threads > 1)
+        {
+            others.emplace_back([&] {
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    if (collector() == 0)
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+
+        std::uint64_t i = 0;
+        std::uint64_t rejected = 0;
+        for (auto _ : state)
+        {
+            if (threads == 1 && i % capacity == 0)
+            {
+                collector();
+            }
+            while (!push<K>(*rings, 0, Sample{i, 0, 1.0}))
+            {
+                ++rejected;
+                std::this_thread::yield();
+            }
+            if (++i % 64 == 0)
+            {
+                pace.store(i, std::memory_order_relaxed);
+            }
+        }
+        stop = true;
+        for (auto& thread : others)
+        {
+            thread.join();
+        }
+        state.setItemsProcessed(state.iterations());
+        state.setCounter("threads", static_cast<double>(threads));
+        state.setCounter("rejected", static_cast<double>(rejected) / static_cast<double>(state.iterations()));
+        if constexpr (K == Kind::perThread)
+        {
+            state.setCounter("ring_bytes", static_cast<double>(rings->bytes()));
+        }
+        else if constexpr (K != Kind::singleRing)
+        {
+            state.setCounter("uses_rseq", rings->uses_rseq() ? 1.0 : 0.0);
+            state.setCounter("ring_bytes", static_cast<double>(rings->cpu_count() * capacity * sizeof(Sample)));
+        }
+    }
+
+    void registerThreads(bench::Registry& registry, std::size_t threads)
+    {
+        auto const name = std::to_string(threads) + "_producers";
+        auto const baseline = "single_mpsc_ring/" + name;
+        registry.add(baseline, [threads](bench::State& state) { contended<Kind::singleRing>(state, threads); });
+        registry.add(
+            "per_thread_rings/" + name, [threads](bench::State& state) { contended<Kind::perThread>(state, threads); }, baseline);
+        registry.add(
+            "per_cpu_ring_atomic/" + name, [threads](bench::State& state) { contended<Kind::perCpuAtomic>(state, threads); }, baseline);
+        registry.add(
+            "per_cpu_ring_rseq/" + name, [threads](bench::State& state) { contended<Kind::perCpuRseq>(state, threads); }, baseline);
+    }
+
+    bench::Registration const registration{[](bench::Registry& registry) {
+        auto const hardware = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+        registerThreads(registry, 1);
+        registerThreads(registry, 4);
+        if (hardware > 4)
+        {
+            // Every hardware thread pushes
+            registerThreads(registry, hardware);
+        }
+        // Many more threads than CPUs
+        registerThreads(registry, std::max<std::size_t>(64, 4 * hardware));
+    }};
+} // namespace
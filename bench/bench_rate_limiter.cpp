@@ -0,0 +1,141 @@
+//
+// Benchmarks for SlidingWindowRateLimiter<N> and TokenBucket
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#include "bench.hpp"
+#include "rate_limiter.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace RL_NAMESPACE_NAME;
+
+namespace
+{
+    constexpr std::uint64_t window = 1'000'000'000;
+
+    // Requests arrive at ten times the allowed rate, so the limiter is
+    // saturated and rejects nine out of ten. The measurement starts after a
+    // full window of requests.
+    template<std::size_t Limit>
+    constexpr std::uint64_t step = window / (10 * Limit);
+
+    template<std::size_t Limit>
+    constexpr std::size_t warmup = 10 * Limit;
+
+    // Counts the timestamps of the window by scanning a deque
+    template<std::size_t Limit>
+    void dequeScan(bench::State& state)
+    {
+        std::deque<std::uint64_t> times;
+        std::uint64_t now = 0;
+        auto const acquire = [&] {
+            now += step<Limit>;
+            auto const inWindow = std::count_if(times.begin(), times.end(), [&](auto t) { return now - t < window; });
+            if (static_cast<std::size_t>(inWindow) < Limit)
+            {
+                times.push_back(now);
+                return true;
+            }
+            while (now - times.front() >= window)
+            {
+                times.pop_front();
+            }
+            return false;
+        };
+        for (std::size_t i = 0; i < warmup<Limit>; ++i)
+        {
+            acquire();
+        }
+        std::uint64_t granted = 0;
+        for (auto _ : state)
+        {
+            granted += acquire();
+        }
+        state.setItemsProcessed(state.iterations());
+        state.setCounter("granted", static_cast<double>(granted) / static_cast<double>(state.iterations()));
+    }
+
+    template<std::size_t Limit>
+    void slidingWindow(bench::State& state)
+    {
+        auto limiter = std::make_unique<SlidingWindowRateLimiter<Limit>>(window);
+        std::uint64_t now = 0;
+        for (std::size_t i = 0; i < warmup<Limit>; ++i)
+        {
+            limiter->try_acquire(now += step<Limit>);
+        }
+        std::uint64_t granted = 0;
+        for (auto _ : state)
+        {
+            now += step<Limit>;
+            granted += limiter->try_acquire(now);
+        }
+        state.setItemsProcessed(state.iterations());
+        state.setCounter("granted", static_cast<double>(granted) / static_cast<double>(state.iterations()));
+    }
+
+    // Threads - 1 further threads compete for the same bucket
+    template<std::size_t Limit, int Threads>
+    void tokenBucket(bench::State& state)
+    {
+        TokenBucket bucket{window / Limit, Limit};
+        std::uint64_t now = 0;
+        for (std::size_t i = 0; i < warmup<Limit>; ++i)
+        {
+            bucket.try_acquire(now += step<Limit>);
+        }
+        std::atomic<std::uint64_t> clock{now};
+        std::atomic<bool> stop{};
+        std::vector<std::thread> others;
+        for (int t = 1; t < Threads; ++t)
+        {
+            others.emplace_back([&] {
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    bench::doNotOptimize(bucket.try_acquire(clock.load(std::memory_order_relaxed)));
+                }
+            });
+        }
+        std::uint64_t granted = 0;
+        for (auto _ : state)
+        {
+            now += step<Limit>;
+            clock.store(now, std::memory_order_relaxed);
+            granted += bucket.try_acquire(now);
+        }
+        stop = true;
+        for (auto& thread : others)
+        {
+            thread.join();
+        }
+        state.setItemsProcessed(state.iterations());
+        state.setCounter("granted", static_cast<double>(granted) / static_cast<double>(state.iterations()));
+    }
+
+    template<std::size_t Limit>
+    void registerLimit(bench::Registry& registry)
+    {
+        auto const name = std::to_string(Limit) + "_per_s";
+        registry.add("deque_scan/" + name, dequeScan<Limit>);
+        registry.add("sliding_window/" + name, slidingWindow<Limit>, "deque_scan/" + name);
+        registry.add("token_bucket/" + name, tokenBucket<Limit, 1>, "deque_scan/" + name);
+        registry.add("token_bucket_4_threads/" + name, tokenBucket<Limit, 4>, "deque_scan/" + name);
+    }
+
+    bench::Registration const registration{[](bench::Registry& registry) {
+        registerLimit<500>(registry);
+        registerLimit<10000>(registry);
+    }};
+} // namespace
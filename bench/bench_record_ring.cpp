@@ -0,0 +1,190 @@
+//
+// Benchmarks for RecordRing and SpscRecordRing
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#include "bench.hpp"
+#include "record_ring.hpp"
+#include "ring_buffer.hpp"
+
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace RR_NAMESPACE_NAME;
+
+namespace
+{
+    constexpr std::size_t maxMessage = 8192;
+    constexpr std::size_t ringBytes = 512 * 1024;
+    constexpr std::size_t batch = 32;
+
+    enum class Distribution
+    {
+        Fixed16,
+        Fixed256,
+        Uniform,
+        Bimodal,
+    };
+
+    // Message sizes between 16 bytes and 8 KB drawn with a fixed seed
+    std::vector<std::size_t> const& messageSizes(Distribution distribution)
+    {
+        static std::vector<std::size_t> sizes[4];
+        auto& result = sizes[static_cast<int>(distribution)];
+        if (result.empty())
+        {
+            std::mt19937 gen{42};
+            std::uniform_int_distribution<std::size_t> uniform{16, maxMessage};
+            std::bernoulli_distribution large{0.1};
+            for (int i = 0; i < 4096; ++i)
+            {
+                switch (distribution)
+                {
+                    case Distribution::Fixed16:
+                        result.push_back(16);
+                        break;
+                    case Distribution::Fixed256:
+                        result.push_back(256);
+                        break;
+                    case Distribution::Uniform:
+                        result.push_back(uniform(gen));
+                        break;
+                    case Distribution::Bimodal:
+                        result.push_back(large(gen) ? 4096 : 64);
+                        break;
+                }
+            }
+        }
+        return result;
+    }
+
+    std::uint64_t totalBytes(std::vector<std::size_t> const& sizes, std::size_t iterations)
+    {
+        std::uint64_t bytes = 0;
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            bytes += sizes[i % sizes.size()];
+        }
+        return bytes;
+    }
+
+    template<Distribution D>
+    void recordRing(bench::State& state)
+    {
+        auto const& sizes = messageSizes(D);
+        RecordRing ring{ringBytes};
+        std::byte message[maxMessage]{};
+        std::size_t i = 0;
+        std::uint64_t checksum = 0;
+        for (auto _ : state)
+        {
+            auto const size = sizes[i++ % sizes.size()];
+            ring.push(1, {message, size});
+            if (i % batch == 0)
+            {
+                ring.consume([&](RecordView record) { checksum += record.payload.size(); });
+            }
+        }
+        bench::doNotOptimize(checksum);
+        state.setItemsProcessed(state.iterations());
+        state.setBytesProcessed(totalBytes(sizes, state.iterations()));
+    }
+
+    // Each slot is large enough for the largest message. The payload is left
+    // uninitialized on construction, only the message is copied.
+    struct Slot
+    {
+        Slot() noexcept
+        {
+        }
+
+        std::uint32_t size;
+        std::uint32_t type;
+        std::byte payload[maxMessage];
+    };
+
+    template<Distribution D>
+    void fixedSlotRing(bench::State& state)
+    {
+        auto const& sizes = messageSizes(D);
+        auto rb = std::make_unique<RingBuffer<Slot, ringBytes / sizeof(Slot)>>();
+        std::byte message[maxMessage]{};
+        std::size_t i = 0;
+        std::uint64_t checksum = 0;
+        for (auto _ : state)
+        {
+            auto const size = sizes[i++ % sizes.size()];
+            auto& slot = rb->emplace();
+            slot.size = static_cast<std::uint32_t>(size);
+            slot.type = 1;
+            std::memcpy(slot.payload, message, size);
+            if (i % batch == 0)
+            {
+                while (!rb->empty())
+                {
+                    checksum += rb->front().size;
+                    rb->pop();
+                }
+            }
+        }
+        bench::doNotOptimize(checksum);
+        state.setItemsProcessed(state.iterations());
+        state.setBytesProcessed(totalBytes(sizes, state.iterations()));
+    }
+
+    // The timed thread consumes, a second thread produces
+    template<Distribution D>
+    void spscRecordRing(bench::State& state)
+    {
+        auto const& sizes = messageSizes(D);
+        SpscRecordRing ring{ringBytes};
+        auto const iterations = state.iterations();
+        std::thread producer{[&] {
+            std::byte message[maxMessage]{};
+            for (std::size_t i = 0; i < iterations; ++i)
+            {
+                while (!ring.push(1, {message, sizes[i % sizes.size()]}))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }};
+        std::size_t consumed = 0;
+        std::uint64_t checksum = 0;
+        for (auto _ : state)
+        {
+            while (ring.consume([&](RecordView record) { checksum += record.payload.size(); }, 1) == 0)
+            {
+                std::this_thread::yield();
+            }
+            ++consumed;
+        }
+        producer.join();
+        bench::doNotOptimize(checksum);
+        state.setItemsProcessed(consumed);
+        state.setBytesProcessed(totalBytes(sizes, consumed));
+    }
+
+    template<Distribution D>
+    void registerDistribution(bench::Registry& registry, std::string const& name)
+    {
+        registry.add("fixed_slot_ring/" + name, fixedSlotRing<D>);
+        registry.add("record_ring/" + name, recordRing<D>, "fixed_slot_ring/" + name);
+        registry.add("spsc_record_ring/" + name, spscRecordRing<D>, "record_ring/" + name);
+    }
+
+    bench::Registration const registration{[](bench::Registry& registry) {
+        registerDistribution<Distribution::Fixed16>(registry, "fixed_16B");
+        registerDistribution<Distribution::Fixed256>(registry, "fixed_256B");
+        registerDistribution<Distribution::Uniform>(registry, "uniform_16B_8KB");
+        registerDistribution<Distribution::Bimodal>(registry, "bimodal_64B_4KB");
+    }};
+} // namespace
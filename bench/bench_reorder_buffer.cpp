@@ -0,0 +1,113 @@
+//
+// Benchmarks for ReorderBuffer<T, N>
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#include "bench.hpp"
+#include "reorder_buffer.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace RO_NAMESPACE_NAME;
+
+namespace
+{
+    struct Packet
+    {
+        std::uint64_t seq;
+        std::uint64_t payload[7];
+    };
+
+    // Sequence numbers in arrival order, each displaced by up to depth
+    // positions. The stream continues seamlessly when it is repeated.
+    std::vector<std::uint64_t> const& arrivals(std::size_t depth)
+    {
+        static std::vector<std::uint64_t> result;
+        static std::size_t current = ~std::size_t{};
+        if (current != depth)
+        {
+            std::vector<std::pair<std::uint64_t, std::uint64_t>> keyed;
+            std::mt19937_64 gen{42};
+            for (std::uint64_t seq = 0; seq < (1 << 20); ++seq)
+            {
+                auto const delay = depth == 0 ? 0 : gen() % (depth + 1);
+                keyed.emplace_back(std::min<std::uint64_t>(seq + delay, (1 << 20) - 1), seq);
+            }
+            std::sort(keyed.begin(), keyed.end());
+            result.clear();
+            for (auto const& [key, seq] : keyed)
+            {
+                result.push_back(seq);
+            }
+            current = depth;
+        }
+        return result;
+    }
+
+    template<std::size_t Depth>
+    void orderedMap(bench::State& state)
+    {
+        auto const& seqs = arrivals(Depth);
+        std::map<std::uint64_t, Packet> pending;
+        std::uint64_t expected = 0;
+        std::uint64_t sum = 0;
+        std::size_t i = 0;
+        for (auto _ : state)
+        {
+            auto const seq = seqs[i % seqs.size()] + (i / seqs.size()) * seqs.size();
+            ++i;
+            pending.emplace(seq, Packet{seq, {}});
+            for (auto it = pending.begin(); it != pending.end() && it->first == expected; it = pending.erase(it))
+            {
+                sum += it->second.seq;
+                ++expected;
+            }
+        }
+        bench::doNotOptimize(sum);
+        state.setItemsProcessed(state.iterations());
+    }
+
+    template<std::size_t Depth>
+    void reorderBuffer(bench::State& state)
+    {
+        auto const& seqs = arrivals(Depth);
+        auto buffer = std::make_unique<ReorderBuffer<Packet, 1024>>();
+        std::uint64_t sum = 0;
+        std::size_t i = 0;
+        for (auto _ : state)
+        {
+            auto const seq = seqs[i % seqs.size()] + (i / seqs.size()) * seqs.size();
+            ++i;
+            buffer->emplace(seq, Packet{seq, {}});
+            buffer->drain([&](Packet&& packet) { sum += packet.seq; });
+        }
+        bench::doNotOptimize(sum);
+        state.setItemsProcessed(state.iterations());
+    }
+
+    template<std::size_t Depth>
+    void registerDepth(bench::Registry& registry)
+    {
+        auto const name = "depth_" + std::to_string(Depth);
+        registry.add("ordered_map/" + name, orderedMap<Depth>);
+        registry.add("reorder_buffer/" + name, reorderBuffer<Depth>, "ordered_map/" + name);
+    }
+
+    bench::Registration const registration{[](bench::Registry& registry) {
+        registerDepth<0>(registry);
+        registerDepth<10>(registry);
+        registerDepth<100>(registry);
+        registerDepth<1000>(registry);
+    }};
+} // namespace
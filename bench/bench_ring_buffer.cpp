@@ -0,0 +1,190 @@
+//
+// Benchmarks for RingBuffer<T, N>
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#include "bench.hpp"
+#include "ring_buffer.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace RB_NAMESPACE_NAME;
+
+namespace
+{
+    // Element of Size bytes
+    template<std::size_t Size>
+    struct Payload
+    {
+        static_assert(Size % sizeof(std::uint32_t) == 0);
+
+        Payload() = default;
+
+        explicit Payload(std::uint32_t value) noexcept
+        {
+            words[0] = value;
+        }
+
+        std::uint32_t words[Size / sizeof(std::uint32_t)]{};
+    };
+
+    template<std::size_t Size, std::size_t N>
+    std::string name(char const* container, char const* operation)
+    {
+        return std::string{container} + "/" + operation + "/" + std::to_string(Size) + "B/" + std::to_string(N);
+    }
+
+    // Steady state: half full ring, one push and one pop per iteration
+    template<std::size_t Size, std::size_t N>
+    void pushPop(bench::State& state)
+    {
+        auto rb = std::make_unique<RingBuffer<Payload<Size>, N>>();
+        for (std::size_t i = 0; i < N / 2; ++i)
+        {
+            rb->emplace(static_cast<std::uint32_t>(i));
+        }
+        std::uint32_t value = 0;
+        for (auto _ : state)
+        {
+            rb->emplace(value++);
+            bench::doNotOptimize(rb->front());
+            rb->pop();
+        }
+        state.setItemsProcessed(state.iterations());
+    }
+
+    template<std::size_t Size, std::size_t N>
+    void dequePushPop(bench::State& state)
+    {
+        std::deque<Payload<Size>> dq;
+        for (std::size_t i = 0; i < N / 2; ++i)
+        {
+            dq.emplace_back(static_cast<std::uint32_t>(i));
+        }
+        std::uint32_t value = 0;
+        for (auto _ : state)
+        {
+            dq.emplace_back(value++);
+            bench::doNotOptimize(dq.front());
+            dq.pop_front();
+        }
+        state.setItemsProcessed(state.iterations());
+    }
+
+    // Full ring, every push overwrites the oldest element
+    template<std::size_t Size, std::size_t N>
+    void pushOverwrite(bench::State& state)
+    {
+        auto rb = std::make_unique<RingBuffer<Payload<Size>, N>>();
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            rb->emplace(static_cast<std::uint32_t>(i));
+        }
+        std::uint32_t value = 0;
+        for (auto _ : state)
+        {
+            bench::doNotOptimize(rb->emplace(value++));
+        }
+        state.setItemsProcessed(state.iterations());
+    }
+
+    template<std::size_t Size, std::size_t N>
+    void dequePushOverwrite(bench::State& state)
+    {
+        std::deque<Payload<Size>> dq;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            dq.emplace_back(static_cast<std::uint32_t>(i));
+        }
+        std::uint32_t value = 0;
+        for (auto _ : state)
+        {
+            bench::doNotOptimize(dq.emplace_back(value++));
+            dq.pop_front();
+        }
+        state.setItemsProcessed(state.iterations());
+    }
+
+    // Iterate a full ring whose occupied region wraps around the end of the storage
+    template<std::size_t Size, std::size_t N>
+    void iterate(bench::State& state)
+    {
+        auto rb = std::make_unique<RingBuffer<Payload<Size>, N>>();
+        for (std::size_t i = 0; i < N + N / 2; ++i)
+        {
+            rb->emplace(static_cast<std::uint32_t>(i));
+        }
+        for (auto _ : state)
+        {
+            std::uint32_t sum = 0;
+            for (auto const& element : *rb)
+            {
+                sum += element.words[0];
+            }
+            bench::doNotOptimize(sum);
+        }
+        state.setItemsProcessed(state.iterations() * N);
+        state.setBytesProcessed(state.iterations() * N * Size);
+    }
+
+    template<std::size_t Size, std::size_t N>
+    void vectorIterate(bench::State& state)
+    {
+        std::vector<Payload<Size>> v;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            v.emplace_back(static_cast<std::uint32_t>(i));
+        }
+        for (auto _ : state)
+        {
+            std::uint32_t sum = 0;
+            for (auto const& element : v)
+            {
+                sum += element.words[0];
+            }
+            bench::doNotOptimize(sum);
+        }
+        state.setItemsProcessed(state.iterations() * N);
+        state.setBytesProcessed(state.iterations() * N * Size);
+    }
+
+    template<std::size_t Size, std::size_t N>
+    void registerCapacity(bench::Registry& registry)
+    {
+        registry.add(name<Size, N>("std::deque", "push_pop"), dequePushPop<Size, N>);
+        registry.add(
+            name<Size, N>("ring_buffer", "push_pop"), pushPop<Size, N>, name<Size, N>("std::deque", "push_pop"));
+
+        registry.add(name<Size, N>("std::deque", "push_overwrite"), dequePushOverwrite<Size, N>);
+        registry.add(
+            name<Size, N>("ring_buffer", "push_overwrite"),
+            pushOverwrite<Size, N>,
+            name<Size, N>("std::deque", "push_overwrite"));
+
+        registry.add(name<Size, N>("std::vector", "iterate"), vectorIterate<Size, N>);
+        registry.add(
+            name<Size, N>("ring_buffer", "iterate"), iterate<Size, N>, name<Size, N>("std::vector", "iterate"));
+    }
+
+    template<std::size_t Size>
+    void registerElementSize(bench::Registry& registry)
+    {
+        registerCapacity<Size, 16>(registry);
+        registerCapacity<Size, 1024>(registry);
+        registerCapacity<Size, 65536>(registry);
+    }
+
+    bench::Registration const registration{[](bench::Registry& registry) {
+        registerElementSize<4>(registry);
+        registerElementSize<64>(registry);
+        registerElementSize<256>(registry);
+    }};
+} // namespace
@@ -0,0 +1,110 @@
+//
+// Benchmarks for RingBuffer<char, N>::read_from/write_to
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#include "bench.hpp"
+#include "ring_buffer.hpp"
+
+#ifdef RB_HAS_VECTORED_IO
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+using namespace RB_NAMESPACE_NAME;
+
+namespace
+{
+    using Ring = RingBuffer<char, 65536>;
+
+    // Pipe into the ring buffer and /dev/null as sink
+    struct Pipe
+    {
+        int fds[2]{-1, -1};
+        int sink{::open("/dev/null", O_WRONLY)};
+
+        Pipe()
+        {
+            if (::pipe(fds) != 0)
+            {
+                throw std::runtime_error("pipe() failed");
+            }
+        }
+
+        ~Pipe()
+        {
+            ::close(fds[0]);
+            ::close(fds[1]);
+            ::close(sink);
+        }
+    };
+
+    // Bytes arrive in a temporary array and are pushed into the ring one by
+    // one, on the way out they are copied into a temporary array again
+    template<std::size_t Chunk>
+    void copyPath(bench::State& state)
+    {
+        Pipe pipe;
+        auto rb = std::make_unique<Ring>();
+        char message[Chunk]{};
+        char temp[Chunk];
+        for (auto _ : state)
+        {
+            static_cast<void>(::write(pipe.fds[1], message, Chunk));
+
+            auto const received = ::read(pipe.fds[0], temp, Chunk);
+            for (ssize_t i = 0; i < received; ++i)
+            {
+                rb->push(temp[i]);
+            }
+
+            std::size_t count = 0;
+            while (!rb->empty())
+            {
+                temp[count++] = rb->front();
+                rb->pop();
+            }
+            static_cast<void>(::write(pipe.sink, temp, count));
+        }
+        state.setBytesProcessed(state.iterations() * Chunk);
+    }
+
+    template<std::size_t Chunk>
+    void vectoredPath(bench::State& state)
+    {
+        Pipe pipe;
+        auto rb = std::make_unique<Ring>();
+        char message[Chunk]{};
+        for (auto _ : state)
+        {
+            static_cast<void>(::write(pipe.fds[1], message, Chunk));
+            rb->read_from(pipe.fds[0], Chunk);
+            rb->write_to(pipe.sink);
+        }
+        state.setBytesProcessed(state.iterations() * Chunk);
+    }
+
+    template<std::size_t Chunk>
+    void registerChunk(bench::Registry& registry)
+    {
+        auto const suffix = std::to_string(Chunk) + "B";
+        registry.add("ring_buffer_io/copy/" + suffix, copyPath<Chunk>);
+        registry.add("ring_buffer_io/vectored/" + suffix, vectoredPath<Chunk>, "ring_buffer_io/copy/" + suffix);
+    }
+
+    bench::Registration const registration{[](bench::Registry& registry) {
+        registerChunk<256>(registry);
+        registerChunk<4096>(registry);
+        registerChunk<32768>(registry);
+    }};
+} // namespace
+
+#endif // RB_HAS_VECTORED_IO
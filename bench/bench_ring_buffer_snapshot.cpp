@@ -0,0 +1,168 @@
+//
+// Benchmarks for RingBuffer<T, N>::save_to/restore_from
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#include "bench.hpp"
+#include "ring_buffer.hpp"
+
+#ifdef RB_HAS_VECTORED_IO
+
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <stdexcept>
+
+using namespace RB_NAMESPACE_NAME;
+
+namespace
+{
+    // 1 GB of elements
+    using Ring = RingBuffer<std::uint64_t, (std::size_t{1} << 30) / sizeof(std::uint64_t) - 1>;
+
+    // A full ring buffer wrapping around the end of its storage, a second one
+    // to restore into and an unlinked temporary file, shared by all benchmarks
+    struct Fixture
+    {
+        std::unique_ptr<Ring> source{std::make_unique<Ring>()};
+        std::unique_ptr<Ring> target{std::make_unique<Ring>()};
+        std::FILE* file;
+
+        Fixture()
+        {
+            char path[] = "/tmp/utl_bench_snapshot_XXXXXX";
+            auto const fd = ::mkstemp(path);
+            if (fd < 0)
+            {
+                throw std::runtime_error("mkstemp() failed");
+            }
+            ::unlink(path);
+            file = ::fdopen(fd, "w+");
+
+            std::uint64_t value = 0;
+            while (!source->full())
+            {
+                source->push(value++);
+            }
+            source->pop(source->size() / 2);
+            while (!source->full())
+            {
+                source->push(value++);
+            }
+        }
+
+        ~Fixture()
+        {
+            std::fclose(file);
+        }
+
+        int fd() const noexcept
+        {
+            return ::fileno(file);
+        }
+
+        void rewind() const
+        {
+            std::fflush(file);
+            if (::lseek(fd(), 0, SEEK_SET) != 0 || std::fseek(file, 0, SEEK_SET) != 0)
+            {
+                throw std::runtime_error("lseek() failed");
+            }
+        }
+    };
+
+    Fixture& fixture()
+    {
+        static Fixture instance;
+        return instance;
+    }
+
+    // Elements written one by one through a stdio stream
+    void stdioSave(bench::State& state)
+    {
+        auto& f = fixture();
+        for (auto _ : state)
+        {
+            f.rewind();
+            for (auto const value : *f.source)
+            {
+                std::fwrite(&value, sizeof value, 1, f.file);
+            }
+            std::fflush(f.file);
+        }
+        state.setBytesProcessed(state.iterations() * f.source->size() * sizeof(std::uint64_t));
+    }
+
+    void snapshotSave(bench::State& state)
+    {
+        auto& f = fixture();
+        for (auto _ : state)
+        {
+            f.rewind();
+            if (!f.source->save_to(f.fd()))
+            {
+                throw std::runtime_error("save_to() failed");
+            }
+        }
+        state.setBytesProcessed(state.iterations() * f.source->size() * sizeof(std::uint64_t));
+    }
+
+    // Elements read one by one through a stdio stream and pushed
+    void stdioRestore(bench::State& state)
+    {
+        auto& f = fixture();
+        f.rewind();
+        for (auto const value : *f.source)
+        {
+            std::fwrite(&value, sizeof value, 1, f.file);
+        }
+        for (auto _ : state)
+        {
+            f.rewind();
+            f.target->clear();
+            std::uint64_t value;
+            for (auto count = f.source->size(); count != 0 && std::fread(&value, sizeof value, 1, f.file) == 1; --count)
+            {
+                f.target->push(value);
+            }
+        }
+        bench::doNotOptimize(f.target->back());
+        state.setBytesProcessed(state.iterations() * f.target->size() * sizeof(std::uint64_t));
+    }
+
+    void snapshotRestore(bench::State& state)
+    {
+        auto& f = fixture();
+        f.rewind();
+        if (!f.source->save_to(f.fd()))
+        {
+            throw std::runtime_error("save_to() failed");
+        }
+        for (auto _ : state)
+        {
+            f.rewind();
+            if (!f.target->restore_from(f.fd()))
+            {
+                throw std::runtime_error("restore_from() failed");
+            }
+        }
+        bench::doNotOptimize(f.target->back());
+        state.setBytesProcessed(state.iterations() * f.target->size() * sizeof(std::uint64_t));
+    }
+
+    bench::Registration const registration{[](bench::Registry& registry) {
+        registry.add("ring_buffer_snapshot/stdio/save_1GB", stdioSave);
+        registry.add("ring_buffer_snapshot/save_to/save_1GB", snapshotSave, "ring_buffer_snapshot/stdio/save_1GB");
+        registry.add("ring_buffer_snapshot/stdio/restore_1GB", stdioRestore);
+        registry.add("ring_buffer_snapshot/restore_from/restore_1GB", snapshotRestore, "ring_buffer_snapshot/stdio/restore_1GB");
+    }};
+} // namespace
+
+#endif // RB_HAS_VECTORED_IO
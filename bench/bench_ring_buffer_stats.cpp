@@ -0,0 +1,48 @@
+//
+// Benchmarks for RingBufferStats
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#include "bench.hpp"
+#include "ring_buffer.hpp"
+#include "ring_buffer_stats.hpp"
+
+#include <memory>
+
+using namespace RS_NAMESPACE_NAME;
+
+namespace
+{
+    template<std::size_t Slots>
+    using SteadyStats = RingBufferStats<Slots, SteadyTickClock>;
+
+    template<template<std::size_t> class Policy>
+    void pushPop(bench::State& state)
+    {
+        auto rb = std::make_unique<RingBuffer<std::uint64_t, 1024, Policy>>();
+        for (std::uint64_t i = 0; i < 512; ++i)
+        {
+            rb->push(i);
+        }
+        std::uint64_t value = 0;
+        for (auto _ : state)
+        {
+            rb->push(value++);
+            bench::doNotOptimize(rb->front());
+            rb->pop();
+        }
+        state.setItemsProcessed(state.iterations());
+    }
+
+    bench::Registration const registration{[](bench::Registry& registry) {
+        registry.add("ring_buffer_stats/null/push_pop", pushPop<RingBufferNullPolicy>);
+        registry.add(
+            "ring_buffer_stats/default_clock/push_pop", pushPop<RingBufferStats>, "ring_buffer_stats/null/push_pop");
+        registry.add(
+            "ring_buffer_stats/steady_clock/push_pop", pushPop<SteadyStats>, "ring_buffer_stats/null/push_pop");
+    }};
+} // namespace
@@ -0,0 +1,164 @@
+//
+// Benchmarks for the ring_simd kernels
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#include "bench.hpp"
+#include "ring_simd.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace RV_NAMESPACE_NAME;
+
+namespace
+{
+    constexpr std::size_t capacity = 4096;
+
+    using Ring = RingBuffer<double, capacity>;
+
+    // A full ring of prices which wraps around in the middle of the storage
+    Ring const& prices()
+    {
+        static auto const result = [] {
+            auto ring = std::make_unique<Ring>();
+            std::mt19937_64 gen{42};
+            std::normal_distribution<double> dist{100.0, 5.0};
+            for (std::size_t i = 0; i < capacity + capacity / 2; ++i)
+            {
+                ring->push(dist(gen));
+            }
+            return ring;
+        }();
+        return *result;
+    }
+
+    // The std algorithms on the ring's iterators
+    enum class Operation
+    {
+        sum,
+        min,
+        argmax,
+        find_if,
+        count_if,
+        histogram
+    };
+
+    // Above every price, so searches scan the whole ring
+    constexpr double limit = 1000.0;
+
+    template<Operation Op>
+    void iterator(bench::State& state)
+    {
+        auto const& ring = prices();
+        std::vector<std::uint64_t> bins(64);
+        for (auto _ : state)
+        {
+            if constexpr (Op == Operation::sum)
+            {
+                bench::doNotOptimize(std::accumulate(ring.begin(), ring.end(), 0.0));
+            }
+            else if constexpr (Op == Operation::min)
+            {
+                bench::doNotOptimize(*std::min_element(ring.begin(), ring.end()));
+            }
+            else if constexpr (Op == Operation::argmax)
+            {
+                bench::doNotOptimize(std::max_element(ring.begin(), ring.end()) - ring.begin());
+            }
+            else if constexpr (Op == Operation::find_if)
+            {
+                bench::doNotOptimize(std::find_if(ring.begin(), ring.end(), [](double x) { return x > limit; }) - ring.begin());
+            }
+            else if constexpr (Op == Operation::count_if)
+            {
+                bench::doNotOptimize(std::count_if(ring.begin(), ring.end(), [](double x) { return x > 105.0; }));
+            }
+            else
+            {
+                for (auto const x : ring)
+                {
+                    if (x >= 80.0 && x < 120.0)
+                    {
+                        ++bins[std::min(static_cast<std::size_t>((x - 80.0) * (64 / 40.0)), std::size_t{63})];
+                    }
+                }
+                bench::doNotOptimize(bins.data());
+            }
+        }
+        state.setItemsProcessed(state.iterations() * capacity);
+        state.setBytesProcessed(state.iterations() * capacity * sizeof(double));
+    }
+
+    template<Operation Op, int Level>
+    void kernel(bench::State& state)
+    {
+        auto const& ring = prices();
+        auto const level = Level < 0 ? simd_level() : static_cast<SimdLevel>(Level);
+        std::vector<std::uint64_t> bins(64);
+        for (auto _ : state)
+        {
+            if constexpr (Op == Operation::sum)
+            {
+                bench::doNotOptimize(ring_simd::sum(ring, level));
+            }
+            else if constexpr (Op == Operation::min)
+            {
+                bench::doNotOptimize(ring_simd::min(ring, level));
+            }
+            else if constexpr (Op == Operation::argmax)
+            {
+                bench::doNotOptimize(ring_simd::argmax(ring, level));
+            }
+            else if constexpr (Op == Operation::find_if)
+            {
+                bench::doNotOptimize(ring_simd::find_if(ring, ring_simd::Compare::greater, limit, level));
+            }
+            else if constexpr (Op == Operation::count_if)
+            {
+                bench::doNotOptimize(ring_simd::count_if(ring, ring_simd::Compare::greater, 105.0, level));
+            }
+            else
+            {
+                bench::doNotOptimize(ring_simd::histogram(ring, 80.0, 120.0, bins, level));
+            }
+        }
+        state.setItemsProcessed(state.iterations() * capacity);
+        state.setBytesProcessed(state.iterations() * capacity * sizeof(double));
+    }
+
+    template<Operation Op>
+    void registerOperation(bench::Registry& registry, std::string const& name)
+    {
+        auto const baseline = "std_iterator/" + name;
+        registry.add(baseline, iterator<Op>);
+        registry.add("ring_simd/scalar/" + name, kernel<Op, static_cast<int>(SimdLevel::scalar)>, baseline);
+        if (simd_level() >= SimdLevel::avx2)
+        {
+            registry.add("ring_simd/avx2/" + name, kernel<Op, static_cast<int>(SimdLevel::avx2)>, baseline);
+        }
+        if (simd_level() >= SimdLevel::avx512)
+        {
+            registry.add("ring_simd/avx512/" + name, kernel<Op, static_cast<int>(SimdLevel::avx512)>, baseline);
+        }
+        registry.add("ring_simd/dispatched/" + name, kernel<Op, -1>, baseline);
+    }
+
+    bench::Registration const registration{[](bench::Registry& registry) {
+        registerOperation<Operation::sum>(registry, "sum");
+        registerOperation<Operation::min>(registry, "min");
+        registerOperation<Operation::argmax>(registry, "argmax");
+        registerOperation<Operation::find_if>(registry, "find_if");
+        registerOperation<Operation::count_if>(registry, "count_if");
+        registerOperation<Operation::histogram>(registry, "histogram");
+    }};
+} // namespace
@@ -0,0 +1,161 @@
+//
+// Benchmarks for RoundRobinStore<T, N, Levels>
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#include "bench.hpp"
+#include "round_robin_store.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace RD_NAMESPACE_NAME;
+
+namespace
+{
+    // One sample per second, rows of 1 second, 1 minute and 1 hour
+    constexpr std::uint64_t day = 24 * 3600;
+    constexpr std::uint64_t range = 6 * 3600;
+    constexpr std::size_t rows = 1440;
+
+    using store_type = RoundRobinStore<double, rows, 3>;
+
+    struct Sample
+    {
+        std::uint64_t time;
+        double value;
+    };
+
+    // Every sample of the last day, consolidated into minutes on each query
+    using raw_type = RingBuffer<Sample, day>;
+
+    std::vector<double> const& stream()
+    {
+        static auto const result = [] {
+            std::vector<double> values(1 << 20);
+            std::mt19937 gen{42};
+            std::normal_distribution<double> dist{100.0, 15.0};
+            std::generate(values.begin(), values.end(), [&] { return dist(gen); });
+            return values;
+        }();
+        return result;
+    }
+
+    std::unique_ptr<store_type> makeStore()
+    {
+        return std::make_unique<store_type>(std::array<std::uint64_t, 3>{1, 60, 3600});
+    }
+
+    void rawPush(bench::State& state)
+    {
+        auto const& values = stream();
+        auto raw = std::make_unique<raw_type>();
+        std::uint64_t time = 0;
+        for (auto _ : state)
+        {
+            raw->push(Sample{time, values[time % values.size()]});
+            ++time;
+        }
+        state.setItemsProcessed(state.iterations());
+        state.setCounter("bytes", static_cast<double>(sizeof(raw_type)));
+    }
+
+    void storePush(bench::State& state)
+    {
+        auto const& values = stream();
+        auto rrd = makeStore();
+        std::uint64_t time = 0;
+        for (auto _ : state)
+        {
+            rrd->push(time, values[time % values.size()]);
+            ++time;
+        }
+        state.setItemsProcessed(state.iterations());
+        state.setCounter("bytes", static_cast<double>(sizeof(store_type)));
+    }
+
+    // Minute averages of the last 6 hours from the raw samples
+    void rawQuery(bench::State& state)
+    {
+        auto const& values = stream();
+        auto raw = std::make_unique<raw_type>();
+        for (std::uint64_t time = 0; time < 2 * day; ++time)
+        {
+            raw->push(Sample{time, values[time % values.size()]});
+        }
+        auto const now = raw->back().time + 1;
+        std::vector<double> averages;
+        for (auto _ : state)
+        {
+            averages.clear();
+            auto minute = ~std::uint64_t{};
+            double sum = 0.0;
+            std::size_t count = 0;
+            for (auto const& sample : *raw)
+            {
+                if (sample.time < now - range)
+                {
+                    continue;
+                }
+                if (sample.time / 60 != minute)
+                {
+                    if (count != 0)
+                    {
+                        averages.push_back(sum / static_cast<double>(count));
+                    }
+                    minute = sample.time / 60;
+                    sum = 0.0;
+                    count = 0;
+                }
+                sum += sample.value;
+                ++count;
+            }
+            averages.push_back(sum / static_cast<double>(count));
+            bench::doNotOptimize(averages.data());
+        }
+        state.setItemsProcessed(state.iterations());
+    }
+
+    void storeQuery(bench::State& state)
+    {
+        auto const& values = stream();
+        auto rrd = makeStore();
+        for (std::uint64_t time = 0; time < 2 * day; ++time)
+        {
+            rrd->push(time, values[time % values.size()]);
+        }
+        rrd->flush();
+        auto const now = 2 * day;
+        std::vector<double> averages;
+        for (auto _ : state)
+        {
+            averages.clear();
+            auto const result = rrd->query(now - range, now, 400);
+            for (auto const& row : result.first)
+            {
+                averages.push_back(row.average());
+            }
+            for (auto const& row : result.second)
+            {
+                averages.push_back(row.average());
+            }
+            bench::doNotOptimize(averages.data());
+        }
+        state.setItemsProcessed(state.iterations());
+    }
+
+    bench::Registration const registration{[](bench::Registry& registry) {
+        registry.add("ring_buffer_raw/push", rawPush);
+        registry.add("round_robin_store/push", storePush, "ring_buffer_raw/push");
+        registry.add("ring_buffer_raw/query_6h_by_minute", rawQuery);
+        registry.add("round_robin_store/query_6h_by_minute", storeQuery, "ring_buffer_raw/query_6h_by_minute");
+    }};
+} // namespace
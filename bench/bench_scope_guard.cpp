@@ -0,0 +1,92 @@
+//
+// Benchmarks for ScopeGuard
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#include "bench.hpp"
+#include "scope_guard.hpp"
+
+using namespace SG_NAMESPACE_NAME;
+
+namespace
+{
+    // Cleanup written out by hand at the end of the scope
+    void handWritten(bench::State& state)
+    {
+        int counter = 0;
+        for (auto _ : state)
+        {
+            bench::doNotOptimize(counter);
+            ++counter;
+            bench::clobberMemory();
+        }
+        bench::doNotOptimize(counter);
+    }
+
+    void makeGuardCleanup(bench::State& state)
+    {
+        int counter = 0;
+        for (auto _ : state)
+        {
+            auto guard = makeGuard([&]() noexcept { ++counter; });
+            bench::doNotOptimize(counter);
+            bench::clobberMemory();
+        }
+        bench::doNotOptimize(counter);
+    }
+
+    void makeGuardDismissed(bench::State& state)
+    {
+        int counter = 0;
+        for (auto _ : state)
+        {
+            auto guard = makeGuard([&]() noexcept { ++counter; });
+            bench::doNotOptimize(counter);
+            guard.dismiss();
+            bench::clobberMemory();
+        }
+        bench::doNotOptimize(counter);
+    }
+
+    void scopeExit(bench::State& state)
+    {
+        int counter = 0;
+        for (auto _ : state)
+        {
+            SCOPE_EXIT
+            {
+                ++counter;
+            };
+            bench::doNotOptimize(counter);
+            bench::clobberMemory();
+        }
+        bench::doNotOptimize(counter);
+    }
+
+    void scopeSuccess(bench::State& state)
+    {
+        int counter = 0;
+        for (auto _ : state)
+        {
+            SCOPE_SUCCESS
+            {
+                ++counter;
+            };
+            bench::doNotOptimize(counter);
+            bench::clobberMemory();
+        }
+        bench::doNotOptimize(counter);
+    }
+
+    bench::Registration const registration{[](bench::Registry& registry) {
+        registry.add("hand_written/cleanup", handWritten);
+        registry.add("scope_guard/make_guard", makeGuardCleanup, "hand_written/cleanup");
+        registry.add("scope_guard/make_guard_dismissed", makeGuardDismissed, "hand_written/cleanup");
+        registry.add("scope_guard/scope_exit", scopeExit, "hand_written/cleanup");
+        registry.add("scope_guard/scope_success", scopeSuccess, "hand_written/cleanup");
+    }};
+} // namespace
@@ -0,0 +1,68 @@
+//
+// Benchmarks for TempBuffer<L>
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#include "bench.hpp"
+#include "temp_buffer.hpp"
+
+#include <cstdlib>
+#include <string>
+
+using namespace TB_NAMESPACE_NAME;
+
+namespace
+{
+    constexpr std::size_t stackSize = 1024;
+
+    template<std::size_t Size>
+    void tempBuffer(bench::State& state)
+    {
+        for (auto _ : state)
+        {
+            TempBuffer<stackSize> buffer{Size};
+            auto p = buffer.as<std::byte>();
+            p[0] = p[Size - 1] = std::byte{1};
+            bench::doNotOptimize(p);
+            bench::clobberMemory();
+        }
+        state.setItemsProcessed(state.iterations());
+    }
+
+    template<std::size_t Size>
+    void rawMalloc(bench::State& state)
+    {
+        for (auto _ : state)
+        {
+            auto p = static_cast<std::byte*>(std::malloc(Size));
+            p[0] = p[Size - 1] = std::byte{1};
+            bench::doNotOptimize(p);
+            bench::clobberMemory();
+            std::free(p);
+        }
+        state.setItemsProcessed(state.iterations());
+    }
+
+    template<std::size_t Size>
+    void registerSize(bench::Registry& registry)
+    {
+        // Sizes up to stackSize stay on the stack, larger ones fall back to the heap
+        auto const suffix = std::to_string(Size) + "B";
+        registry.add("malloc/allocate_touch/" + suffix, rawMalloc<Size>);
+        registry.add(
+            std::string{"temp_buffer/"} + (Size <= stackSize ? "stack/" : "heap/") + suffix,
+            tempBuffer<Size>,
+            "malloc/allocate_touch/" + suffix);
+    }
+
+    bench::Registration const registration{[](bench::Registry& registry) {
+        registerSize<64>(registry);
+        registerSize<stackSize>(registry);
+        registerSize<4 * stackSize>(registry);
+        registerSize<64 * stackSize>(registry);
+    }};
+} // namespace
@@ -0,0 +1,102 @@
+//
+// Benchmarks for TimeWindow<T, N>
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#include "bench.hpp"
+#include "time_window.hpp"
+#include "windowed_aggregate.hpp"
+
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace TM_NAMESPACE_NAME;
+
+namespace
+{
+    constexpr std::size_t capacity = 1 << 16;
+    constexpr std::uint64_t window = 5000;
+
+    // Arrival times: either one sample per tick or bursts of 4096 samples
+    // every 1000 ticks, which expire in batches
+    std::vector<std::uint64_t> const& arrivals(bool bursty)
+    {
+        static std::vector<std::uint64_t> times[2];
+        auto& result = times[bursty];
+        if (result.empty())
+        {
+            for (std::uint64_t i = 0; i < (1 << 20); ++i)
+            {
+                result.push_back(bursty ? (i / 4096) * 1000 : i);
+            }
+        }
+        return result;
+    }
+
+    // Keeps the timestamps in a parallel RingBuffer and evicts samples one by
+    // one from the front
+    template<bool Bursty>
+    void popLoop(bench::State& state)
+    {
+        auto const& times = arrivals(Bursty);
+        auto wa = std::make_unique<WindowedAggregate<double, capacity, WindowSum, WindowMin, WindowMax>>();
+        auto stamps = std::make_unique<RingBuffer<std::uint64_t, capacity>>();
+        std::size_t i = 0;
+        std::uint64_t offset = 0;
+        for (auto _ : state)
+        {
+            if (i == times.size())
+            {
+                i = 0;
+                offset = stamps->back() + window;
+            }
+            auto const now = offset + times[i];
+            while (!stamps->empty() && stamps->front() + window <= now)
+            {
+                stamps->pop();
+                wa->pop();
+            }
+            if (stamps->full())
+            {
+                stamps->pop();
+            }
+            stamps->push(now);
+            wa->push(static_cast<double>(i++ & 1023));
+            bench::doNotOptimize(wa->value<WindowSum>());
+        }
+        state.setItemsProcessed(state.iterations());
+    }
+
+    template<bool Bursty>
+    void timeWindow(bench::State& state)
+    {
+        auto const& times = arrivals(Bursty);
+        auto tw = std::make_unique<TimeWindow<double, capacity>>(window);
+        std::size_t i = 0;
+        std::uint64_t offset = 0;
+        for (auto _ : state)
+        {
+            if (i == times.size())
+            {
+                i = 0;
+                offset = tw->samples().back().time + window;
+            }
+            tw->push(offset + times[i], static_cast<double>(i & 1023));
+            ++i;
+            bench::doNotOptimize(tw->statistics().sum);
+        }
+        state.setItemsProcessed(state.iterations());
+    }
+
+    bench::Registration const registration{[](bench::Registry& registry) {
+        registry.add("pop_loop/steady", popLoop<false>);
+        registry.add("time_window/steady", timeWindow<false>, "pop_loop/steady");
+        registry.add("pop_loop/bursty", popLoop<true>);
+        registry.add("time_window/bursty", timeWindow<true>, "pop_loop/bursty");
+    }};
+} // namespace
@@ -0,0 +1,185 @@
+//
+// Benchmarks for TimingWheel
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#include "bench.hpp"
+#include "timing_wheel.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <queue>
+#include <vector>
+
+using namespace TW_NAMESPACE_NAME;
+
+namespace
+{
+    constexpr std::size_t timers = 1 << 20;
+    constexpr std::uint64_t maxTimeout = 1 << 22;
+
+    struct Random
+    {
+        std::uint64_t state = 0x9E3779B97F4A7C15;
+
+        std::uint64_t operator()() noexcept
+        {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            return state;
+        }
+    };
+
+    // Binary heap with lazy cancellation: cancelled entries stay in the heap
+    // until they reach the top
+    class TimerHeap
+    {
+      public:
+        struct Id
+        {
+            std::uint32_t index;
+            std::uint32_t generation;
+        };
+
+        TimerHeap()
+            : generations_(timers, 0)
+        {
+            for (std::uint32_t index = timers; index > 0; --index)
+            {
+                free_.push_back(index - 1);
+            }
+        }
+
+        Id schedule(std::uint64_t deadline)
+        {
+            auto const index = free_.back();
+            free_.pop_back();
+            heap_.push({deadline, index, generations_[index]});
+            return {index, generations_[index]};
+        }
+
+        bool cancel(Id id)
+        {
+            if (generations_[id.index] != id.generation)
+            {
+                return false;
+            }
+            ++generations_[id.index];
+            free_.push_back(id.index);
+            return true;
+        }
+
+        template<typename Fn>
+        std::size_t tick(std::uint64_t now, Fn&& fn)
+        {
+            std::size_t fired = 0;
+            while (!heap_.empty() && heap_.top().deadline <= now)
+            {
+                auto const entry = heap_.top();
+                heap_.pop();
+                if (generations_[entry.index] == entry.generation)
+                {
+                    ++generations_[entry.index];
+                    free_.push_back(entry.index);
+                    fn(entry.index);
+                    ++fired;
+                }
+            }
+            return fired;
+        }
+
+      private:
+        struct Entry
+        {
+            std::uint64_t deadline;
+            std::uint32_t index;
+            std::uint32_t generation;
+
+            bool operator<(Entry const& rhs) const noexcept
+            {
+                return deadline > rhs.deadline;
+            }
+        };
+
+        std::priority_queue<Entry> heap_;
+        std::vector<std::uint32_t> generations_;
+        std::vector<std::uint32_t> free_;
+    };
+
+    // Up to 1M timers with timeouts up to 4M ticks are kept alive. Every
+    // iteration advances the time by 4 ticks, cancels a random timer, schedules
+    // a new one and fires whatever expired, which is the typical life of order
+    // timeouts: most are cancelled, some expire. Timeouts are either uniformly
+    // distributed or all the same.
+    template<typename Timers, typename Id, bool FixedTimeout>
+    void steadyState(bench::State& state, Timers& wheel)
+    {
+        Random random;
+        auto const timeout = [&] { return FixedTimeout ? maxTimeout : 1 + random() % maxTimeout; };
+        std::vector<Id> ids;
+        for (std::size_t i = 0; i < timers / 2; ++i)
+        {
+            ids.push_back(wheel.schedule(FixedTimeout ? 1 + random() % maxTimeout : timeout()));
+        }
+        std::uint64_t now = 0;
+        std::uint64_t fired = 0;
+        for (auto _ : state)
+        {
+            now += 4;
+            auto& id = ids[random() % ids.size()];
+            wheel.cancel(id);
+            id = wheel.schedule(now + timeout());
+            fired += wheel.tick(now, [](auto const&) {});
+        }
+        bench::doNotOptimize(fired);
+        state.setItemsProcessed(state.iterations());
+        state.setCounter("fired", static_cast<double>(fired));
+    }
+
+    template<bool FixedTimeout>
+    void binaryHeap(bench::State& state)
+    {
+        TimerHeap heap;
+        steadyState<TimerHeap, TimerHeap::Id, FixedTimeout>(state, heap);
+    }
+
+    struct Wheel
+    {
+        std::unique_ptr<TimingWheel<std::uint32_t, timers>> wheel = std::make_unique<TimingWheel<std::uint32_t, timers>>();
+
+        TimerId schedule(std::uint64_t deadline)
+        {
+            return wheel->schedule(deadline, 0u);
+        }
+
+        bool cancel(TimerId id)
+        {
+            return wheel->cancel(id);
+        }
+
+        template<typename Fn>
+        std::size_t tick(std::uint64_t now, Fn&& fn)
+        {
+            return wheel->tick(now, fn);
+        }
+    };
+
+    template<bool FixedTimeout>
+    void timingWheel(bench::State& state)
+    {
+        Wheel wheel;
+        steadyState<Wheel, TimerId, FixedTimeout>(state, wheel);
+    }
+
+    bench::Registration const registration{[](bench::Registry& registry) {
+        registry.add("binary_heap/steady_1M/random_timeout", binaryHeap<false>);
+        registry.add("timing_wheel/steady_1M/random_timeout", timingWheel<false>, "binary_heap/steady_1M/random_timeout");
+        registry.add("binary_heap/steady_1M/fixed_timeout", binaryHeap<true>);
+        registry.add("timing_wheel/steady_1M/fixed_timeout", timingWheel<true>, "binary_heap/steady_1M/fixed_timeout");
+    }};
+} // namespace
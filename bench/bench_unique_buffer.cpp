@@ -0,0 +1,102 @@
+//
+// Benchmarks for UniqueBuffer
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#include "bench.hpp"
+#include "unique_buffer.hpp"
+
+#include <cstdlib>
+#include <memory>
+#include <memory_resource>
+#include <string>
+
+using namespace UB_NAMESPACE_NAME;
+
+namespace
+{
+    template<std::size_t Size>
+    void rawMalloc(bench::State& state)
+    {
+        for (auto _ : state)
+        {
+            auto p = std::malloc(Size);
+            bench::doNotOptimize(p);
+            std::free(p);
+        }
+        state.setItemsProcessed(state.iterations());
+    }
+
+    template<std::size_t Size>
+    void uniqueBuffer(bench::State& state, std::pmr::memory_resource* memres)
+    {
+        for (auto _ : state)
+        {
+            UniqueBuffer ub{Size, memres};
+            bench::doNotOptimize(ub.get());
+        }
+        state.setItemsProcessed(state.iterations());
+    }
+
+    template<std::size_t Size>
+    void newDelete(bench::State& state)
+    {
+        uniqueBuffer<Size>(state, std::pmr::new_delete_resource());
+    }
+
+    template<std::size_t Size>
+    void unsynchronizedPool(bench::State& state)
+    {
+        std::pmr::unsynchronized_pool_resource memres;
+        uniqueBuffer<Size>(state, &memres);
+    }
+
+    template<std::size_t Size>
+    void synchronizedPool(bench::State& state)
+    {
+        std::pmr::synchronized_pool_resource memres;
+        uniqueBuffer<Size>(state, &memres);
+    }
+
+    // Monotonic buffers never reuse memory, hence the arena is released whenever it is exhausted
+    template<std::size_t Size>
+    void monotonic(bench::State& state)
+    {
+        constexpr std::size_t arenaSize = 1024 * 1024;
+        auto arena = std::make_unique<std::byte[]>(arenaSize);
+        std::pmr::monotonic_buffer_resource memres{arena.get(), arenaSize, std::pmr::null_memory_resource()};
+        std::size_t allocations = 0;
+        for (auto _ : state)
+        {
+            if (++allocations == arenaSize / Size)
+            {
+                memres.release();
+                allocations = 0;
+            }
+            UniqueBuffer ub{Size, &memres};
+            bench::doNotOptimize(ub.get());
+        }
+        state.setItemsProcessed(state.iterations());
+    }
+
+    template<std::size_t Size>
+    void registerSize(bench::Registry& registry)
+    {
+        auto const suffix = std::to_string(Size) + "B";
+        auto const baseline = "malloc/allocate/" + suffix;
+        registry.add(baseline, rawMalloc<Size>);
+        registry.add("unique_buffer/new_delete_resource/" + suffix, newDelete<Size>, baseline);
+        registry.add("unique_buffer/unsynchronized_pool_resource/" + suffix, unsynchronizedPool<Size>, baseline);
+        registry.add("unique_buffer/synchronized_pool_resource/" + suffix, synchronizedPool<Size>, baseline);
+        registry.add("unique_buffer/monotonic_buffer_resource/" + suffix, monotonic<Size>, baseline);
+    }
+
+    bench::Registration const registration{[](bench::Registry& registry) {
+        registerSize<64>(registry);
+        registerSize<4096>(registry);
+    }};
+} // namespace
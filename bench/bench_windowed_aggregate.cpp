@@ -0,0 +1,111 @@
+//
+// Benchmarks for WindowedAggregate<T, N, Ops...>
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#include "bench.hpp"
+#include "windowed_aggregate.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace WA_NAMESPACE_NAME;
+
+namespace
+{
+    std::vector<double> const& samples()
+    {
+        static auto const result = [] {
+            std::vector<double> values(1 << 16);
+            std::mt19937 gen{42};
+            std::lognormal_distribution<double> dist{3.0, 0.5};
+            std::generate(values.begin(), values.end(), [&] { return dist(gen); });
+            return values;
+        }();
+        return result;
+    }
+
+    struct Statistics
+    {
+        double sum;
+        double mean;
+        double variance;
+        double min;
+        double max;
+    };
+
+    // Pushes into a RingBuffer and computes all statistics from scratch
+    template<std::size_t N>
+    void recompute(bench::State& state)
+    {
+        auto const& values = samples();
+        auto rb = std::make_unique<RingBuffer<double, N>>();
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            rb->push(values[i % values.size()]);
+        }
+        std::size_t i = 0;
+        for (auto _ : state)
+        {
+            rb->push(values[i++ % values.size()]);
+            Statistics s{0.0, 0.0, 0.0, rb->front(), rb->front()};
+            for (auto value : *rb)
+            {
+                s.sum += value;
+                s.min = std::min(s.min, value);
+                s.max = std::max(s.max, value);
+            }
+            s.mean = s.sum / static_cast<double>(N);
+            for (auto value : *rb)
+            {
+                s.variance += (value - s.mean) * (value - s.mean);
+            }
+            s.variance /= static_cast<double>(N);
+            bench::doNotOptimize(s);
+        }
+        state.setItemsProcessed(state.iterations());
+    }
+
+    template<std::size_t N>
+    void incremental(bench::State& state)
+    {
+        auto const& values = samples();
+        auto wa = std::make_unique<WindowedAggregate<double, N, WindowSum, WindowMean, WindowVariance, WindowMin, WindowMax>>();
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            wa->push(values[i % values.size()]);
+        }
+        std::size_t i = 0;
+        for (auto _ : state)
+        {
+            wa->push(values[i++ % values.size()]);
+            Statistics s{
+                wa->template value<WindowSum>(),
+                wa->template value<WindowMean>(),
+                wa->template value<WindowVariance>(),
+                wa->template value<WindowMin>(),
+                wa->template value<WindowMax>()};
+            bench::doNotOptimize(s);
+        }
+        state.setItemsProcessed(state.iterations());
+    }
+
+    template<std::size_t N>
+    void registerWindow(bench::Registry& registry, std::string const& name)
+    {
+        registry.add("ring_buffer_recompute/" + name, recompute<N>);
+        registry.add("windowed_aggregate/" + name, incremental<N>, "ring_buffer_recompute/" + name);
+    }
+
+    bench::Registration const registration{[](bench::Registry& registry) {
+        registerWindow<1000>(registry, "1K");
+        registerWindow<100000>(registry, "100K");
+    }};
+} // namespace
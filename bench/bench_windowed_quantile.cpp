@@ -0,0 +1,90 @@
+//
+// Benchmarks for WindowedQuantile<T, N>
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#include "bench.hpp"
+#include "windowed_quantile.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace WQ_NAMESPACE_NAME;
+
+namespace
+{
+    // Stream of 1M latency samples in nanoseconds
+    std::vector<std::uint32_t> const& stream()
+    {
+        static auto const result = [] {
+            std::vector<std::uint32_t> values(1 << 20);
+            std::mt19937 gen{42};
+            std::lognormal_distribution<double> dist{9.0, 0.7};
+            std::generate(values.begin(), values.end(), [&] { return static_cast<std::uint32_t>(dist(gen)); });
+            return values;
+        }();
+        return result;
+    }
+
+    // Copies the ring buffer and sorts the copy on every push
+    template<std::size_t N>
+    void sortCopy(bench::State& state)
+    {
+        auto const& values = stream();
+        auto rb = std::make_unique<RingBuffer<std::uint32_t, N>>();
+        std::vector<std::uint32_t> sorted;
+        std::size_t i = 0;
+        while (i < N)
+        {
+            rb->push(values[i++]);
+        }
+        for (auto _ : state)
+        {
+            rb->push(values[i++ % values.size()]);
+            sorted.assign(rb->begin(), rb->end());
+            std::sort(sorted.begin(), sorted.end());
+            bench::doNotOptimize(sorted[(sorted.size() - 1) / 2]);
+            bench::doNotOptimize(sorted[(sorted.size() * 95 + 99) / 100 - 1]);
+        }
+        state.setItemsProcessed(state.iterations());
+    }
+
+    template<std::size_t N>
+    void windowedQuantile(bench::State& state)
+    {
+        auto const& values = stream();
+        auto wq = std::make_unique<WindowedQuantile<std::uint32_t, N>>();
+        std::size_t i = 0;
+        while (i < N)
+        {
+            wq->push(values[i++]);
+        }
+        for (auto _ : state)
+        {
+            wq->push(values[i++ % values.size()]);
+            bench::doNotOptimize(wq->median());
+            bench::doNotOptimize(wq->quantile(0.95));
+        }
+        state.setItemsProcessed(state.iterations());
+    }
+
+    template<std::size_t N>
+    void registerWindow(bench::Registry& registry, std::string const& name)
+    {
+        registry.add("ring_buffer_sort/" + name, sortCopy<N>);
+        registry.add("windowed_quantile/" + name, windowedQuantile<N>, "ring_buffer_sort/" + name);
+    }
+
+    bench::Registration const registration{[](bench::Registry& registry) {
+        registerWindow<1024>(registry, "1K");
+        registerWindow<65536>(registry, "64K");
+    }};
+} // namespace
@@ -0,0 +1,547 @@
+//
+// Asynchronous logger writing binary records on hot threads and formatting them in the background
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#ifndef AL_ASYNC_LOGGER_HPP_INCLUDED
+#define AL_ASYNC_LOGGER_HPP_INCLUDED
+
+// Configure namespace preference for AsyncLogger.
+// By default namespace utl is used.
+#define AL_NAMESPACE_NAME utl
+
+// clang-format off
+#ifndef AL_BEGIN_NAMESPACE
+#define AL_BEGIN_NAMESPACE namespace AL_NAMESPACE_NAME {
+#endif // AL_BEGIN_NAMESPAC
+#ifndef AL_END_NAMESPACE
+#define AL_END_NAMESPACE }
+#endif // AL_END_NAMESPACE
+// clang-format on
+
+#include "record_ring.hpp"
+#include "temp_buffer.hpp"
+
+#include <sys/uio.h>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+AL_BEGIN_NAMESPACE
+
+// What a producer does when its ring is full
+enum class AsyncLogFull
+{
+    block, // Wait until the background thread has made room
+    drop   // Discard the message and count it
+};
+
+namespace detail
+{
+    // Encoding of an argument of a log record. Arithmetic values and pointers
+    // are copied as they are.
+    template<typename T>
+    struct AsyncLogArg
+    {
+        static_assert(std::is_arithmetic_v<T> || std::is_pointer_v<T>, "Only arithmetic values, pointers and strings can be logged");
+
+        using decoded_type = T;
+
+        static std::size_t size(T) noexcept
+        {
+            return sizeof(T);
+        }
+
+        static std::byte* encode(std::byte* out, T value) noexcept
+        {
+            std::memcpy(out, &value, sizeof(T));
+            return out + sizeof(T);
+        }
+
+        static T decode(std::byte const*& in) noexcept
+        {
+            T value;
+            std::memcpy(&value, in, sizeof(T));
+            in += sizeof(T);
+            return value;
+        }
+    };
+
+    // Strings are copied into the record as a 4 byte length followed by the
+    // characters and a terminating zero, so they need not outlive the call and
+    // decode to a C string pointing into the record.
+    struct AsyncLogStringArg
+    {
+        using decoded_type = char const*;
+
+        static std::size_t size(std::string_view s) noexcept
+        {
+            return sizeof(std::uint32_t) + s.size() + 1;
+        }
+
+        static std::byte* encode(std::byte* out, std::string_view s) noexcept
+        {
+            auto const length = static_cast<std::uint32_t>(s.size());
+            std::memcpy(out, &length, sizeof length);
+            std::memcpy(out + sizeof length, s.data(), s.size());
+            out[sizeof length + s.size()] = std::byte{};
+            return out + size(s);
+        }
+
+        static char const* decode(std::byte const*& in) noexcept
+        {
+            std::uint32_t length;
+            std::memcpy(&length, in, sizeof length);
+            auto const s = reinterpret_cast<char const*>(in + sizeof length);
+            in += sizeof length + length + 1;
+            return s;
+        }
+    };
+
+    template<>
+    struct AsyncLogArg<std::string_view> : AsyncLogStringArg
+    {
+    };
+
+    template<>
+    struct AsyncLogArg<std::string> : AsyncLogStringArg
+    {
+    };
+
+    template<>
+    struct AsyncLogArg<char const*> : AsyncLogStringArg
+    {
+        static std::size_t size(char const* s) noexcept
+        {
+            return AsyncLogStringArg::size(s != nullptr ? s : "(null)");
+        }
+
+        static std::byte* encode(std::byte* out, char const* s) noexcept
+        {
+            return AsyncLogStringArg::encode(out, s != nullptr ? s : "(null)");
+        }
+    };
+
+    template<>
+    struct AsyncLogArg<char*> : AsyncLogArg<char const*>
+    {
+    };
+
+    // Formats the arguments following a record header with snprintf()
+    using AsyncLogFormatFn = int (*)(char const* format, std::byte const* args, char* out, std::size_t size);
+
+    template<typename... Args>
+    int formatAsyncLog(char const* format, [[maybe_unused]] std::byte const* args, char* out, std::size_t size)
+    {
+        // Braced initialization decodes the arguments from left to right
+        std::tuple<typename AsyncLogArg<Args>::decoded_type...> const values{AsyncLogArg<Args>::decode(args)...};
+        return std::apply([&](auto... value) { return std::snprintf(out, size, format, value...); }, values);
+    }
+
+    // Leads every record, the encoded arguments follow it
+    struct AsyncLogHeader
+    {
+        AsyncLogFormatFn formatFn; // nullptr if there are no arguments
+        char const* format;
+    };
+} // namespace detail
+
+// Logger moving the cost of formatting and writing off the calling threads.
+// Each thread logs through its own Producer, which writes a compact binary
+// record into an SpscRecordRing: the printf() style format string, a pointer
+// to the function able to format it and the raw arguments.
+//
+//   AsyncLogger<> logger{fd};
+//   thread_local AsyncLogger<>::Producer log{logger};
+//   log("order %llu filled %d @ %.2f\n", id, quantity, price);
+//
+// A background thread drains the rings of all producers, formats the records
+// into a TempBuffer of BatchBytes and writes the batch with writev(). Messages
+// without arguments are not copied at all, the batch refers to their format
+// string. Format strings must therefore have static storage duration, while
+// string arguments (char const*, std::string_view, std::string) are copied
+// into the record. The messages of a producer are written in order; messages
+// of different producers are not ordered.
+//
+// When its ring is full, a producer either waits for the background thread
+// or drops the message, depending on the AsyncLogFull policy. The logger must
+// outlive its producers. Destroying it writes what is left.
+template<std::size_t BatchBytes = 65536>
+class AsyncLogger
+{
+    struct Channel;
+
+  public:
+    using clock_type = std::chrono::steady_clock;
+
+    class Producer
+    {
+      public:
+        explicit Producer(AsyncLogger& logger)
+            : channel_{logger.attach()}
+            , full_{logger.full_}
+        {
+        }
+
+        Producer(Producer&&) = delete;
+        Producer(Producer const&) = delete;
+        Producer& operator=(Producer&&) = delete;
+        Producer& operator=(Producer const&) = delete;
+
+        // The remaining messages are still written, the ring is released
+        // once the background thread has drained it
+        ~Producer()
+        {
+            channel_->closed.store(true, std::memory_order_release);
+        }
+
+        // Logs a message. Returns false if it was dropped because the ring is
+        // full or the message is larger than the ring's maxPayload(). Waiting
+        // for room ends once the ring is empty, a message which does not fit
+        // then is dropped.
+        template<typename... Args>
+        bool operator()(char const* format, Args const&... args) noexcept
+        {
+            using Header = detail::AsyncLogHeader;
+            auto const size = (sizeof(Header) + ... + detail::AsyncLogArg<std::decay_t<Args>>::size(args));
+            auto& ring = channel_->ring;
+            if (size > ring.maxPayload())
+            {
+                return drop();
+            }
+            auto space = ring.reserve(size);
+            while (space.data() == nullptr)
+            {
+                if (full_ == AsyncLogFull::drop)
+                {
+                    return drop();
+                }
+                std::this_thread::yield();
+                auto const empty = ring.empty();
+                space = ring.reserve(size);
+                if (space.data() == nullptr && empty)
+                {
+                    return drop();
+                }
+            }
+            Header header{nullptr, format};
+            if constexpr (sizeof...(Args) != 0)
+            {
+                header.formatFn = &detail::formatAsyncLog<std::decay_t<Args>...>;
+            }
+            std::memcpy(space.data(), &header, sizeof header);
+            [[maybe_unused]] auto out = space.data() + sizeof header;
+            ((out = detail::AsyncLogArg<std::decay_t<Args>>::encode(out, args)), ...);
+            ring.commit(0);
+            return true;
+        }
+
+        // Messages dropped by this producer
+        [[nodiscard]] std::uint64_t dropped() const noexcept
+        {
+            return channel_->dropped.load(std::memory_order_relaxed);
+        }
+
+      private:
+        Channel* channel_;
+        AsyncLogFull full_;
+
+        bool drop() noexcept
+        {
+            // Only this thread writes the counter
+            channel_->dropped.store(channel_->dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return false;
+        }
+    };
+
+    // Writes to fd, which the logger does not close. Each producer gets a ring
+    // of ringBytes. The background thread sleeps for idle when it found nothing
+    // to write.
+    explicit AsyncLogger(
+        int fd,
+        AsyncLogFull full = AsyncLogFull::block,
+        std::size_t ringBytes = 65536,
+        clock_type::duration idle = std::chrono::milliseconds{1})
+        : fd_{fd}
+        , full_{full}
+        , ringBytes_{ringBytes}
+        , idle_{idle}
+        , thread_{[this] { run(); }}
+    {
+    }
+
+    AsyncLogger(AsyncLogger&&) = delete;
+    AsyncLogger(AsyncLogger const&) = delete;
+    AsyncLogger& operator=(AsyncLogger&&) = delete;
+    AsyncLogger& operator=(AsyncLogger const&) = delete;
+
+    ~AsyncLogger()
+    {
+        {
+            std::lock_guard lock{wakeMutex_};
+            stop_ = true;
+        }
+        wakeCv_.notify_one();
+        thread_.join();
+    }
+
+    // Waits until every message logged before has been written
+    void flush()
+    {
+        std::unique_lock lock{wakeMutex_};
+        auto const target = started_ + 1;
+        wake_ = true;
+        wakeCv_.notify_one();
+        passedCv_.wait(lock, [&] { return passed_ >= target; });
+    }
+
+    // Messages dropped by all producers, including the destroyed ones
+    [[nodiscard]] std::uint64_t dropped() const
+    {
+        std::lock_guard lock{channelsMutex_};
+        auto result = retiredDropped_;
+        for (auto const& channel : channels_)
+        {
+            result += channel->dropped.load(std::memory_order_relaxed);
+        }
+        return result;
+    }
+
+    // Number of writev() calls which failed, their messages are lost
+    [[nodiscard]] std::uint64_t write_errors() const noexcept
+    {
+        return writeErrors_.load(std::memory_order_relaxed);
+    }
+
+  private:
+    static constexpr std::size_t maxPieces = 64;
+
+    struct Channel
+    {
+        explicit Channel(std::size_t ringBytes)
+            : ring{ringBytes}
+        {
+        }
+
+        ::RR_NAMESPACE_NAME::SpscRecordRing ring;
+        std::atomic<std::uint64_t> dropped{};
+        std::atomic<bool> closed{};
+        bool retired{}; // Closed and drained, used by the background thread only
+    };
+
+    // Part of the batch: a format string without arguments or formatted text
+    // at offset in text_
+    struct Piece
+    {
+        char const* literal;
+        std::size_t offset;
+        std::size_t length;
+    };
+
+    int fd_;
+    AsyncLogFull full_;
+    std::size_t ringBytes_;
+    clock_type::duration idle_;
+
+    mutable std::mutex channelsMutex_;
+    std::vector<std::unique_ptr<Channel>> channels_;
+    std::uint64_t retiredDropped_{};
+
+    // Used by the background thread only
+    std::vector<Channel*> draining_;
+    ::TB_NAMESPACE_NAME::TempBuffer<BatchBytes> text_{BatchBytes};
+    std::size_t used_{};
+    Piece pieces_[maxPieces];
+    std::size_t pieceCount_{};
+    std::atomic<std::uint64_t> writeErrors_{};
+
+    std::mutex wakeMutex_;
+    std::condition_variable wakeCv_;
+    std::condition_variable passedCv_;
+    bool wake_{};
+    bool stop_{};
+    std::uint64_t started_{}; // Drain passes started
+    std::uint64_t passed_{};  // Drain passes completed
+
+    std::thread thread_;
+
+    Channel* attach()
+    {
+        std::lock_guard lock{channelsMutex_};
+        return channels_.emplace_back(std::make_unique<Channel>(ringBytes_)).get();
+    }
+
+    void run()
+    {
+        std::unique_lock lock{wakeMutex_};
+        for (;;)
+        {
+            auto const stopping = stop_;
+            wake_ = false;
+            ++started_;
+            lock.unlock();
+            auto const count = drain();
+            lock.lock();
+            ++passed_;
+            passedCv_.notify_all();
+            if (stopping)
+            {
+                break;
+            }
+            if (count == 0)
+            {
+                wakeCv_.wait_for(lock, idle_, [&] { return wake_ || stop_; });
+            }
+        }
+    }
+
+    // Writes the records of all rings, returns their number. The channels are
+    // only looked up under channelsMutex_, so attach() and dropped() do not
+    // wait for formatting and writing. Only this thread removes channels, the
+    // ones looked up stay valid.
+    std::size_t drain()
+    {
+        {
+            std::lock_guard lock{channelsMutex_};
+            draining_.clear();
+            for (auto const& channel : channels_)
+            {
+                draining_.push_back(channel.get());
+            }
+        }
+        std::size_t count = 0;
+        std::size_t retired = 0;
+        for (auto channel : draining_)
+        {
+            // A closed ring receives no more records once the flag is seen
+            channel->retired = channel->closed.load(std::memory_order_acquire);
+            count += channel->ring.consume([this](::RR_NAMESPACE_NAME::RecordView record) { append(record.payload); });
+            retired += channel->retired;
+        }
+        flushBatch();
+        if (retired != 0)
+        {
+            std::lock_guard lock{channelsMutex_};
+            std::erase_if(channels_, [this](auto const& channel) {
+                if (channel->retired)
+                {
+                    retiredDropped_ += channel->dropped.load(std::memory_order_relaxed);
+                }
+                return channel->retired;
+            });
+        }
+        return count;
+    }
+
+    void append(std::span<std::byte const> record)
+    {
+        detail::AsyncLogHeader header;
+        std::memcpy(&header, record.data(), sizeof header);
+        if (pieceCount_ == maxPieces)
+        {
+            flushBatch();
+        }
+        if (header.formatFn == nullptr && std::strchr(header.format, '%') == nullptr)
+        {
+            pieces_[pieceCount_++] = {header.format, 0, std::strlen(header.format)};
+            return;
+        }
+
+        auto const format = header.formatFn != nullptr ? header.formatFn : &detail::formatAsyncLog<>;
+        auto const args = record.data() + sizeof header;
+        auto length = format(header.format, args, text() + used_, text_.size() - used_);
+        if (length < 0)
+        {
+            return;
+        }
+        if (static_cast<std::size_t>(length) >= text_.size() - used_)
+        {
+            // Formatted again after making room, the scratch space grows
+            // beyond BatchBytes for messages which are larger
+            flushBatch();
+            if (static_cast<std::size_t>(length) >= text_.size())
+            {
+                text_.resize(static_cast<std::size_t>(length) + 1);
+            }
+            length = format(header.format, args, text(), text_.size());
+        }
+        auto const size = static_cast<std::size_t>(length);
+        if (pieceCount_ != 0 && pieces_[pieceCount_ - 1].literal == nullptr)
+        {
+            pieces_[pieceCount_ - 1].length += size;
+        }
+        else
+        {
+            pieces_[pieceCount_++] = {nullptr, used_, size};
+        }
+        used_ += size;
+    }
+
+    void flushBatch()
+    {
+        iovec iov[maxPieces];
+        for (std::size_t i = 0; i < pieceCount_; ++i)
+        {
+            auto const& piece = pieces_[i];
+            iov[i] = {const_cast<char*>(piece.literal != nullptr ? piece.literal : text() + piece.offset), piece.length};
+        }
+        auto next = iov;
+        auto count = static_cast<int>(pieceCount_);
+        while (count != 0)
+        {
+            auto const result = ::writev(fd_, next, count);
+            if (result < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                writeErrors_.fetch_add(1, std::memory_order_relaxed);
+                break;
+            }
+            // Continue after a partial write
+            auto written = static_cast<std::size_t>(result);
+            for (; count != 0 && written >= next->iov_len; ++next, --count)
+            {
+                written -= next->iov_len;
+            }
+            if (count != 0)
+            {
+                next->iov_base = static_cast<char*>(next->iov_base) + written;
+                next->iov_len -= written;
+            }
+        }
+        pieceCount_ = 0;
+        used_ = 0;
+        if (text_.dynamic())
+        {
+            text_.resize(BatchBytes);
+        }
+    }
+
+    char* text() const noexcept
+    {
+        return static_cast<char*>(text_.get());
+    }
+};
+
+AL_END_NAMESPACE
+
+#endif // AL_ASYNC_LOGGER_HPP_INCLUDED
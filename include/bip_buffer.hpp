@@ -0,0 +1,240 @@
+//
+// Fixed size bip buffer (two region circular buffer)
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#ifndef BB_BIP_BUFFER_HPP_INCLUDED
+#define BB_BIP_BUFFER_HPP_INCLUDED
+
+// Configure namespace preference for BipBuffer.
+// By default namespace utl is used.
+#define BB_NAMESPACE_NAME utl
+
+// clang-format off
+#ifndef BB_BEGIN_NAMESPACE
+#define BB_BEGIN_NAMESPACE namespace BB_NAMESPACE_NAME {
+#endif // BB_BEGIN_NAMESPAC
+#ifndef BB_END_NAMESPACE
+#define BB_END_NAMESPACE }
+#endif // BB_END_NAMESPACE
+// clang-format on
+
+#include <algorithm>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+BB_BEGIN_NAMESPACE
+
+// Circular buffer which always hands out contiguous regions. Committed elements
+// live in up to two regions: A, which is read from, and B, which starts at the
+// beginning of the storage and grows towards A once there is no room left after
+// A. When A has been read completely, B becomes A.
+//
+// Writers reserve a contiguous region of uninitialized storage, construct the
+// elements in place (std::construct_at) or let an external API fill it, and
+// commit the number of elements constructed:
+//
+//   if (auto out = bb.reserve(frameSize); !out.empty())
+//   {
+//       auto const written = encoder.encode(out.data(), out.size());
+//       bb.commit(written);
+//   }
+//
+// Readers get the oldest elements as one contiguous region and release them
+// when done, which destroys them:
+//
+//   auto in = bb.read();
+//   auto const consumed = decoder.decode(in.data(), in.size());
+//   bb.release(consumed);
+template<typename T, std::size_t N>
+class BipBuffer
+{
+  public:
+    static_assert(N > 0, "Template argument N must not be zero");
+
+    using value_type = T;
+    using pointer = T*;
+    using const_pointer = T const*;
+    using reference = T&;
+    using const_reference = T const&;
+    using size_type = std::size_t;
+
+    BipBuffer() = default;
+    BipBuffer(BipBuffer&&) = delete;
+    BipBuffer(BipBuffer const&) = delete;
+    BipBuffer& operator=(BipBuffer&&) = delete;
+    BipBuffer& operator=(BipBuffer const&) = delete;
+
+    ~BipBuffer() noexcept
+    {
+        clear();
+    }
+
+    // Returns count contiguous slots of uninitialized storage or an empty span
+    // if there is no contiguous free region large enough. A new reservation
+    // replaces a previous one which has not been committed.
+    [[nodiscard]] std::span<T> reserve(size_type count) noexcept
+    {
+        if (count == 0)
+        {
+            return {};
+        }
+        if (bEnd_ != 0 || (aEnd_ != aStart_ && N - aEnd_ < count))
+        {
+            // Region B is in use or there is no room after A
+            if (aStart_ - bEnd_ < count)
+            {
+                return {};
+            }
+            reserveStart_ = bEnd_;
+        }
+        else
+        {
+            if (N - aEnd_ < count)
+            {
+                return {};
+            }
+            reserveStart_ = aEnd_;
+        }
+        reserveCount_ = count;
+        return {static_cast<T*>(storageAt(reserveStart_)), count};
+    }
+
+    // Makes the first count elements of the last reservation available for
+    // reading. They must have been constructed.
+    void commit(size_type count) noexcept
+    {
+        count = std::min(count, std::exchange(reserveCount_, 0));
+        if (count == 0)
+        {
+            return;
+        }
+        if (empty())
+        {
+            // Region A has been released while the reservation was pending, it becomes region A
+            aStart_ = reserveStart_;
+            aEnd_ = reserveStart_ + count;
+        }
+        else if (reserveStart_ == aEnd_ && bEnd_ == 0)
+        {
+            aEnd_ += count;
+        }
+        else
+        {
+            bEnd_ += count;
+        }
+    }
+
+    template<typename... Args>
+    bool emplace(Args&&... args)
+    {
+        auto space = reserve(1);
+        if (space.empty())
+        {
+            return false;
+        }
+        std::construct_at(space.data(), std::forward<Args>(args)...);
+        commit(1);
+        return true;
+    }
+
+    // The oldest committed elements as one contiguous region
+    [[nodiscard]] std::span<T> read() noexcept
+    {
+        return {objectAt(aStart_), aEnd_ - aStart_};
+    }
+
+    [[nodiscard]] std::span<T const> read() const noexcept
+    {
+        return {objectAt(aStart_), aEnd_ - aStart_};
+    }
+
+    // Destroys the first count elements of the region returned by read()
+    void release(size_type count) noexcept
+    {
+        count = std::min(count, aEnd_ - aStart_);
+        std::destroy_n(objectAt(aStart_), count);
+        aStart_ += count;
+        if (aStart_ == aEnd_)
+        {
+            if (bEnd_ != 0)
+            {
+                // Region B becomes region A
+                aStart_ = 0;
+                aEnd_ = std::exchange(bEnd_, 0);
+            }
+            else
+            {
+                // Start over at the beginning, commit() places a pending reservation
+                aStart_ = aEnd_ = 0;
+            }
+        }
+    }
+
+    void clear() noexcept
+    {
+        while (!empty())
+        {
+            release(aEnd_ - aStart_);
+        }
+        reserveCount_ = 0;
+    }
+
+    [[nodiscard]] size_type size() const noexcept
+    {
+        return aEnd_ - aStart_ + bEnd_;
+    }
+
+    [[nodiscard]] size_type capacity() const noexcept
+    {
+        return N;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return aStart_ == aEnd_;
+    }
+
+    // Size of the largest region reserve() would currently succeed with
+    [[nodiscard]] size_type contiguous_free() const noexcept
+    {
+        if (bEnd_ != 0)
+        {
+            return aStart_ - bEnd_;
+        }
+        return std::max(N - aEnd_, aStart_);
+    }
+
+  private:
+    size_type aStart_{}; // Storage index of the first element of region A
+    size_type aEnd_{};   // Storage index one past the last element of region A
+    size_type bEnd_{};   // Storage index one past the last element of region B, which starts at 0
+    size_type reserveStart_{};
+    size_type reserveCount_{};
+    std::aligned_storage_t<sizeof(T), alignof(T)> storage_[N];
+
+    T* objectAt(size_type index) noexcept
+    {
+        return std::launder(static_cast<T*>(static_cast<void*>(&storage_[index])));
+    }
+
+    T const* objectAt(size_type index) const noexcept
+    {
+        return std::launder(static_cast<T const*>(static_cast<void const*>(&storage_[index])));
+    }
+
+    void* storageAt(size_type index) noexcept
+    {
+        return static_cast<void*>(&storage_[index]);
+    }
+};
+
+BB_END_NAMESPACE
+
+#endif // BB_BIP_BUFFER_HPP_INCLUDED
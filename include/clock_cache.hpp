@@ -0,0 +1,644 @@
+//
+// Bounded cache with CLOCK eviction in fixed slots
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#ifndef CC_CLOCK_CACHE_HPP_INCLUDED
+#define CC_CLOCK_CACHE_HPP_INCLUDED
+
+// Configure namespace preference for ClockCache.
+// By default namespace utl is used.
+#define CC_NAMESPACE_NAME utl
+
+// clang-format off
+#ifndef CC_BEGIN_NAMESPACE
+#define CC_BEGIN_NAMESPACE namespace CC_NAMESPACE_NAME {
+#endif // CC_BEGIN_NAMESPAC
+#ifndef CC_END_NAMESPACE
+#define CC_END_NAMESPACE }
+#endif // CC_END_NAMESPACE
+// clang-format on
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+CC_BEGIN_NAMESPACE
+
+namespace detail
+{
+    // Cell read by lookups, which may run concurrently to a writer
+    template<typename T, bool Shared>
+    class ClockCacheCell
+    {
+      public:
+        T load(std::memory_order order) const noexcept
+        {
+            return value_.load(order);
+        }
+
+        void store(T value, std::memory_order order) noexcept
+        {
+            value_.store(value, order);
+        }
+
+      private:
+        std::atomic<T> value_{};
+    };
+
+    // Cell of a single threaded cache
+    template<typename T>
+    class ClockCacheCell<T, false>
+    {
+      public:
+        T load(std::memory_order) const noexcept
+        {
+            return value_;
+        }
+
+        void store(T value, std::memory_order) noexcept
+        {
+            value_ = value;
+        }
+
+      private:
+        T value_{};
+    };
+
+    // Entry of a concurrent cache, stored as relaxed atomic words, so a reader
+    // may copy it while a writer overwrites it without a data race
+    template<typename Entry, bool Shared>
+    class ClockCacheSlot
+    {
+      public:
+        Entry load() const noexcept
+        {
+            std::uint64_t words[wordCount];
+            for (std::size_t i = 0; i < wordCount; ++i)
+            {
+                words[i] = words_[i].load(std::memory_order_relaxed);
+            }
+            std::array<std::byte, sizeof(Entry)> bytes;
+            std::memcpy(bytes.data(), words, sizeof(Entry));
+            return std::bit_cast<Entry>(bytes);
+        }
+
+        void store(Entry const& entry) noexcept
+        {
+            std::uint64_t words[wordCount]{};
+            std::memcpy(words, &entry, sizeof(Entry));
+            for (std::size_t i = 0; i < wordCount; ++i)
+            {
+                words_[i].store(words[i], std::memory_order_relaxed);
+            }
+        }
+
+      private:
+        static constexpr std::size_t wordCount = (sizeof(Entry) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+        std::atomic<std::uint64_t> words_[wordCount];
+    };
+
+    // Entry of a single threaded cache, constructed in place
+    template<typename Entry>
+    class ClockCacheSlot<Entry, false>
+    {
+      public:
+        void* storage() noexcept
+        {
+            return &storage_;
+        }
+
+        Entry* get() noexcept
+        {
+            return std::launder(static_cast<Entry*>(storage()));
+        }
+
+        Entry const* get() const noexcept
+        {
+            return std::launder(static_cast<Entry const*>(static_cast<void const*>(&storage_)));
+        }
+
+      private:
+        std::aligned_storage_t<sizeof(Entry), alignof(Entry)> storage_;
+    };
+
+    // Writers are serialized by a mutex and bump a version before and after
+    // modifying the cache. Readers take no lock, they retry if the version
+    // was odd or changed while they were reading (a sequence lock). A reader
+    // which finds a writer in progress waits for it to finish.
+    template<bool Shared>
+    class ClockCacheSync
+    {
+      public:
+        class WriteLock
+        {
+          public:
+            explicit WriteLock(ClockCacheSync& sync)
+                : sync_{sync}
+            {
+                sync_.mutex_.lock();
+                sync_.version_.store(sync_.version_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_release);
+            }
+
+            WriteLock(WriteLock const&) = delete;
+            WriteLock& operator=(WriteLock const&) = delete;
+
+            ~WriteLock() noexcept
+            {
+                sync_.version_.store(sync_.version_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+                sync_.mutex_.unlock();
+            }
+
+          private:
+            ClockCacheSync& sync_;
+        };
+
+        [[nodiscard]] WriteLock write()
+        {
+            return WriteLock{*this};
+        }
+
+        template<typename Fn>
+        auto read(Fn&& fn) const
+        {
+            for (;;)
+            {
+                auto const version = version_.load(std::memory_order_acquire);
+                if ((version & 1) != 0)
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+                auto result = fn();
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (version_.load(std::memory_order_relaxed) == version)
+                {
+                    return result;
+                }
+            }
+        }
+
+      private:
+        std::mutex mutex_;
+        std::atomic<std::uint64_t> version_{};
+    };
+
+    template<>
+    class ClockCacheSync<false>
+    {
+      public:
+        struct WriteLock
+        {
+        };
+
+        [[nodiscard]] WriteLock write() noexcept
+        {
+            return {};
+        }
+
+        template<typename Fn>
+        auto read(Fn&& fn) const
+        {
+            return fn();
+        }
+    };
+} // namespace detail
+
+// Cache of up to N key value pairs which evicts entries by the CLOCK algorithm,
+// an approximation of LRU: every slot has a reference bit which lookups set.
+// When a new entry needs a slot, a clock hand sweeps the slots in ring order,
+// clearing reference bits, and evicts the first entry which has not been
+// referenced since the hand passed it last. Unlike a linked list LRU a hit
+// does not reorder anything, it sets at most one byte.
+//
+//   auto cache = std::make_unique<ClockCache<std::uint64_t, Quote, 65536>>();
+//   if (auto quote = cache->find(id))
+//       ...
+//   else
+//       cache->insert_or_assign(id, load(id));
+//
+// Entries live in inline storage and are indexed by an open addressing hash
+// table with linear probing and backward shift deletion, so the cache never
+// allocates.
+//
+// BasicClockCache<..., false> (ClockCache) is for single threaded use.
+// BasicClockCache<..., true> (ConcurrentClockCache) serializes writers with a
+// mutex while get() and contains() take no lock: they read under a sequence
+// lock and retry if a writer interfered. Readers never contend with each
+// other, but they are not lock-free: a reader waits while a writer is in the
+// middle of an update, so a writer preempted there holds up the readers of
+// its cache. Keys and values must be trivially copyable, as readers may copy
+// an entry while it is overwritten.
+// ShardedClockCache spreads keys over several of them to reduce contention
+// among writers.
+template<typename K, typename V, std::size_t N, typename Hash, bool Shared>
+class BasicClockCache
+{
+  public:
+    static_assert(N > 0, "Template argument N must not be zero");
+    static_assert(N < std::numeric_limits<std::uint32_t>::max() / 2, "Template argument N is too large");
+    static_assert(!Shared || (std::is_trivially_copyable_v<K> && std::is_trivially_copyable_v<V>),
+                  "ConcurrentClockCache requires trivially copyable keys and values");
+
+    using key_type = K;
+    using mapped_type = V;
+    using hasher = Hash;
+    using size_type = std::size_t;
+
+    BasicClockCache() = default;
+    BasicClockCache(BasicClockCache&&) = delete;
+    BasicClockCache(BasicClockCache const&) = delete;
+    BasicClockCache& operator=(BasicClockCache&&) = delete;
+    BasicClockCache& operator=(BasicClockCache const&) = delete;
+
+    ~BasicClockCache() noexcept
+    {
+        clear();
+    }
+
+    // The value of key, marking it referenced, or nullptr on a miss
+    [[nodiscard]] V* find(K const& key) noexcept requires(!Shared)
+    {
+        auto const slot = lookup(key);
+        if (slot == npos)
+        {
+            return nullptr;
+        }
+        touch(slot);
+        return &slots_[slot].get()->value;
+    }
+
+    // A copy of the value of key, marking it referenced
+    [[nodiscard]] std::optional<V> get(K const& key)
+    {
+        return sync_.read([&]() -> std::optional<V> {
+            auto const slot = lookup(key);
+            if (slot == npos)
+            {
+                return std::nullopt;
+            }
+            touch(slot);
+            if constexpr (Shared)
+            {
+                return slots_[slot].load().value;
+            }
+            else
+            {
+                return slots_[slot].get()->value;
+            }
+        });
+    }
+
+    [[nodiscard]] bool contains(K const& key) const noexcept
+    {
+        return sync_.read([&] { return lookup(key) != npos; });
+    }
+
+    // Assigns value to key, inserting it if it is not cached and evicting an
+    // entry if the cache is full. Returns true if key was inserted.
+    bool insert_or_assign(K const& key, V const& value)
+    {
+        [[maybe_unused]] auto const lock = sync_.write();
+        auto const home = homeOf(key);
+        if (auto const slot = lookup(key, home); slot != npos)
+        {
+            if constexpr (Shared)
+            {
+                auto entry = slots_[slot].load();
+                entry.value = value;
+                slots_[slot].store(entry);
+            }
+            else
+            {
+                slots_[slot].get()->value = value;
+            }
+            touch(slot);
+            return false;
+        }
+        auto const slot = allocate();
+        if constexpr (Shared)
+        {
+            slots_[slot].store(Entry{key, value});
+        }
+        else
+        {
+            try
+            {
+                std::construct_at(static_cast<Entry*>(slots_[slot].storage()), key, value);
+            }
+            catch (...)
+            {
+                free_[freeCount_++] = slot;
+                throw;
+            }
+        }
+        referenced_[slot].store(0, std::memory_order_relaxed);
+        homes_[slot] = home;
+        auto position = home;
+        while (index_[position].load(std::memory_order_relaxed) != 0)
+        {
+            position = (position + 1) & mask;
+        }
+        index_[position].store(slot + 1, std::memory_order_relaxed);
+        size_.store(size_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool erase(K const& key)
+    {
+        [[maybe_unused]] auto const lock = sync_.write();
+        auto const slot = lookup(key);
+        if (slot == npos)
+        {
+            return false;
+        }
+        remove(slot);
+        free_[freeCount_++] = slot;
+        return true;
+    }
+
+    void clear()
+    {
+        [[maybe_unused]] auto const lock = sync_.write();
+        for (std::uint32_t position = 0; position < tableSize; ++position)
+        {
+            if (auto const entry = index_[position].load(std::memory_order_relaxed); entry != 0)
+            {
+                destruct(entry - 1);
+                index_[position].store(0, std::memory_order_relaxed);
+            }
+        }
+        size_.store(0, std::memory_order_relaxed);
+        fresh_ = 0;
+        freeCount_ = 0;
+        hand_ = 0;
+    }
+
+    [[nodiscard]] size_type size() const noexcept
+    {
+        return size_.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] size_type capacity() const noexcept
+    {
+        return N;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+  private:
+    static constexpr std::uint32_t npos = std::numeric_limits<std::uint32_t>::max();
+
+    // At most half of the index is in use, which keeps probe sequences short
+    static constexpr std::uint32_t tableSize = std::bit_ceil(static_cast<std::uint32_t>(2 * N));
+    static constexpr std::uint32_t mask = tableSize - 1;
+
+    struct Entry
+    {
+        K key;
+        V value;
+    };
+
+    [[no_unique_address]] mutable detail::ClockCacheSync<Shared> sync_;
+    detail::ClockCacheSlot<Entry, Shared> slots_[N];
+    detail::ClockCacheCell<std::uint8_t, Shared> referenced_[N];
+    detail::ClockCacheCell<std::uint32_t, Shared> index_[tableSize]; // Slot + 1, 0 if empty
+    std::uint32_t homes_[N];                                         // Home position in index_ of each slot
+    std::uint32_t free_[N];                                          // Slots freed by erase()
+    std::uint32_t freeCount_{};
+    std::uint32_t fresh_{}; // Slots from fresh_ on have never been used
+    std::size_t hand_{};
+    detail::ClockCacheCell<size_type, Shared> size_;
+
+    std::uint32_t homeOf(K const& key) const noexcept
+    {
+        // Fibonacci hashing, so weak hashes like the identity spread evenly
+        auto const hash = static_cast<std::uint64_t>(Hash{}(key)) * 0x9E3779B97F4A7C15ull;
+        return static_cast<std::uint32_t>(hash >> 32) & mask;
+    }
+
+    std::uint32_t lookup(K const& key) const noexcept
+    {
+        return lookup(key, homeOf(key));
+    }
+
+    // Probes at most tableSize positions, so a reader racing with a writer
+    // cannot loop forever
+    std::uint32_t lookup(K const& key, std::uint32_t position) const noexcept
+    {
+        for (std::uint32_t probes = 0; probes < tableSize; ++probes)
+        {
+            auto const entry = index_[position].load(std::memory_order_relaxed);
+            if (entry == 0)
+            {
+                break;
+            }
+            if (keyOf(entry - 1) == key)
+            {
+                return entry - 1;
+            }
+            position = (position + 1) & mask;
+        }
+        return npos;
+    }
+
+    void touch(std::uint32_t slot) noexcept
+    {
+        auto& referenced = referenced_[slot];
+        if (referenced.load(std::memory_order_relaxed) == 0)
+        {
+            referenced.store(1, std::memory_order_relaxed);
+        }
+    }
+
+    std::uint32_t allocate() noexcept
+    {
+        if (fresh_ < N)
+        {
+            return fresh_++;
+        }
+        if (freeCount_ != 0)
+        {
+            return free_[--freeCount_];
+        }
+        // All slots are in use, advance the hand to an entry not referenced
+        // since its last pass
+        for (;;)
+        {
+            auto const slot = static_cast<std::uint32_t>(increment(hand_));
+            if (referenced_[slot].load(std::memory_order_relaxed) == 0)
+            {
+                remove(slot);
+                return slot;
+            }
+            referenced_[slot].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // Removes the entry in slot from the index and destroys it
+    void remove(std::uint32_t slot) noexcept
+    {
+        auto position = homes_[slot];
+        while (index_[position].load(std::memory_order_relaxed) != slot + 1)
+        {
+            position = (position + 1) & mask;
+        }
+        // Shift later entries of the probe sequence back into the gap, unless
+        // their home lies cyclically after the gap
+        auto next = position;
+        for (;;)
+        {
+            next = (next + 1) & mask;
+            auto const entry = index_[next].load(std::memory_order_relaxed);
+            if (entry == 0)
+            {
+                break;
+            }
+            auto const home = homes_[entry - 1];
+            if (((next - home) & mask) >= ((next - position) & mask))
+            {
+                index_[position].store(entry, std::memory_order_relaxed);
+                position = next;
+            }
+        }
+        index_[position].store(0, std::memory_order_relaxed);
+        destruct(slot);
+        size_.store(size_.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+    }
+
+    auto increment(std::size_t& index) noexcept
+    {
+        return std::exchange(index, (index + 1) % N);
+    }
+
+    decltype(auto) keyOf(std::uint32_t slot) const noexcept
+    {
+        if constexpr (Shared)
+        {
+            return slots_[slot].load().key;
+        }
+        else
+        {
+            return (slots_[slot].get()->key);
+        }
+    }
+
+    void destruct(std::uint32_t slot) noexcept
+    {
+        if constexpr (!Shared)
+        {
+            std::destroy_at(slots_[slot].get());
+        }
+    }
+};
+
+template<typename K, typename V, std::size_t N, typename Hash = std::hash<K>>
+using ClockCache = BasicClockCache<K, V, N, Hash, false>;
+
+template<typename K, typename V, std::size_t N, typename Hash = std::hash<K>>
+using ConcurrentClockCache = BasicClockCache<K, V, N, Hash, true>;
+
+// Concurrent cache of up to N entries in Shards independent ConcurrentClockCaches
+// of N / Shards entries each. A key always maps to the same shard, so writers
+// of different shards do not contend.
+template<typename K, typename V, std::size_t N, std::size_t Shards = 16, typename Hash = std::hash<K>>
+class ShardedClockCache
+{
+  public:
+    static_assert(Shards > 0 && N % Shards == 0, "Template argument N must be a multiple of Shards");
+
+    using key_type = K;
+    using mapped_type = V;
+    using hasher = Hash;
+    using size_type = std::size_t;
+    using shard_type = ConcurrentClockCache<K, V, N / Shards, Hash>;
+
+    ShardedClockCache() = default;
+    ShardedClockCache(ShardedClockCache&&) = delete;
+    ShardedClockCache(ShardedClockCache const&) = delete;
+    ShardedClockCache& operator=(ShardedClockCache&&) = delete;
+    ShardedClockCache& operator=(ShardedClockCache const&) = delete;
+
+    [[nodiscard]] std::optional<V> get(K const& key)
+    {
+        return shardOf(key).get(key);
+    }
+
+    [[nodiscard]] bool contains(K const& key) const noexcept
+    {
+        return shardOf(key).contains(key);
+    }
+
+    bool insert_or_assign(K const& key, V const& value)
+    {
+        return shardOf(key).insert_or_assign(key, value);
+    }
+
+    bool erase(K const& key)
+    {
+        return shardOf(key).erase(key);
+    }
+
+    void clear()
+    {
+        for (auto& shard : shards_)
+        {
+            shard.clear();
+        }
+    }
+
+    // Number of entries, which is approximate while writers are active
+    [[nodiscard]] size_type size() const noexcept
+    {
+        size_type result = 0;
+        for (auto const& shard : shards_)
+        {
+            result += shard.size();
+        }
+        return result;
+    }
+
+    [[nodiscard]] size_type capacity() const noexcept
+    {
+        return N;
+    }
+
+  private:
+    shard_type shards_[Shards];
+
+    // The shard is taken from the low bits of a different multiplicative hash
+    // than the one the shards use for their index
+    shard_type& shardOf(K const& key) noexcept
+    {
+        return shards_[(static_cast<std::uint64_t>(Hash{}(key)) * 0xC2B2AE3D27D4EB4Full >> 40) % Shards];
+    }
+
+    shard_type const& shardOf(K const& key) const noexcept
+    {
+        return const_cast<ShardedClockCache*>(this)->shardOf(key);
+    }
+};
+
+CC_END_NAMESPACE
+
+#endif // CC_CLOCK_CACHE_HPP_INCLUDED
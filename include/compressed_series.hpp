@@ -0,0 +1,398 @@
+//
+// Ring of compressed time series blocks using Gorilla encoding
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#ifndef CS_COMPRESSED_SERIES_HPP_INCLUDED
+#define CS_COMPRESSED_SERIES_HPP_INCLUDED
+
+// Configure namespace preference for CompressedSeries.
+// By default namespace utl is used.
+#define CS_NAMESPACE_NAME utl
+
+// clang-format off
+#ifndef CS_BEGIN_NAMESPACE
+#define CS_BEGIN_NAMESPACE namespace CS_NAMESPACE_NAME {
+#endif // CS_BEGIN_NAMESPAC
+#ifndef CS_END_NAMESPACE
+#define CS_END_NAMESPACE }
+#endif // CS_END_NAMESPACE
+// clang-format on
+
+#include "ring_buffer.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+CS_BEGIN_NAMESPACE
+
+struct CompressedPoint
+{
+    std::int64_t time;
+    double value;
+};
+
+namespace detail
+{
+    // Block of a CompressedSeries. The first point is stored as is, the
+    // following ones as a bit stream, most significant bit first.
+    template<std::size_t BlockSize>
+    struct CompressedBlock
+    {
+        static constexpr std::size_t words = (BlockSize - 24) / 8;
+
+        std::int64_t time;
+        std::uint64_t value;
+        std::uint32_t count; // Number of points including the first one
+        std::uint32_t bits;  // Number of bits used in stream
+        std::uint64_t stream[words];
+
+        void write(std::uint64_t value, unsigned length) noexcept
+        {
+            auto const index = bits / 64;
+            auto const available = 64 - bits % 64;
+            if (length <= available)
+            {
+                stream[index] |= value << (available - length);
+            }
+            else
+            {
+                stream[index] |= value >> (length - available);
+                stream[index + 1] |= value << (64 - (length - available));
+            }
+            bits += length;
+        }
+
+        std::uint64_t read(std::uint32_t& position, unsigned length) const noexcept
+        {
+            auto const index = position / 64;
+            auto const offset = position % 64;
+            auto result = (stream[index] << offset) >> (64 - length);
+            if (length > 64 - offset)
+            {
+                result |= stream[index + 1] >> (128 - offset - length);
+            }
+            position += length;
+            return result;
+        }
+    };
+} // namespace detail
+
+// Time series of (time, value) points compressed as described in "Gorilla: A
+// Fast, Scalable, In-Memory Time Series Database" (Pelkonen et al., 2015):
+// timestamps are stored as the difference of consecutive deltas, which is 0
+// for regular intervals and costs a single bit, and values as the XOR with the
+// previous value, of which only the meaningful bits are stored. Regularly
+// sampled metrics typically take 1 to 2 bytes per point instead of 16.
+//
+//   auto cpu = std::make_unique<CompressedSeries<4096, 64>>();
+//   cpu->push(seconds, load);
+//   ...
+//   for (auto const& [time, value] : *cpu) { ... }
+//
+// Points are encoded into a RingBuffer of Blocks blocks of BlockSize bytes.
+// When the newest block is full a new one is started, and when all blocks are
+// used the oldest one is evicted with all its points. Memory is therefore fixed
+// and the series covers as many points as fit into the blocks. Iterators decode
+// the points on the fly and are invalidated by push() and clear().
+template<std::size_t BlockSize, std::size_t Blocks>
+class CompressedSeries
+{
+    using block_type = detail::CompressedBlock<BlockSize>;
+
+    // Longest encoding of a point: 4 + 64 bits of time, 2 + 5 + 6 + 64 bits of value
+    static constexpr std::uint32_t maxPointBits = 145;
+
+  public:
+    static_assert(BlockSize % 8 == 0, "Template argument BlockSize must be a multiple of 8");
+    static_assert(block_type::words * 64 >= maxPointBits, "Template argument BlockSize is too small");
+    static_assert(sizeof(block_type) == BlockSize);
+
+    using value_type = CompressedPoint;
+    using size_type = std::size_t;
+    using time_type = std::int64_t;
+
+    class const_iterator
+    {
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = CompressedPoint;
+        using difference_type = std::ptrdiff_t;
+        using pointer = CompressedPoint const*;
+        using reference = CompressedPoint const&;
+
+        const_iterator() = default;
+
+        [[nodiscard]] reference operator*() const noexcept
+        {
+            return point_;
+        }
+
+        [[nodiscard]] pointer operator->() const noexcept
+        {
+            return &point_;
+        }
+
+        const_iterator& operator++() noexcept
+        {
+            auto const& blocks = series_->blocks_;
+            if (++index_ == blocks[block_].count)
+            {
+                start(block_ + 1);
+                return *this;
+            }
+            auto const& block = blocks[block_];
+            delta_ += decodeDeltaOfDelta(block);
+            point_.time = static_cast<time_type>(static_cast<std::uint64_t>(point_.time) + delta_);
+            if (block.read(position_, 1) != 0)
+            {
+                if (block.read(position_, 1) != 0)
+                {
+                    leading_ = static_cast<unsigned>(block.read(position_, 5));
+                    auto const meaningful = static_cast<unsigned>(block.read(position_, 6)) + 1;
+                    trailing_ = 64 - leading_ - meaningful;
+                }
+                bits_ ^= block.read(position_, 64 - leading_ - trailing_) << trailing_;
+                point_.value = std::bit_cast<double>(bits_);
+            }
+            return *this;
+        }
+
+        const_iterator operator++(int) noexcept
+        {
+            auto result = *this;
+            ++*this;
+            return result;
+        }
+
+        [[nodiscard]] bool operator==(const_iterator const& other) const noexcept
+        {
+            return block_ == other.block_ && index_ == other.index_;
+        }
+
+      private:
+        friend class CompressedSeries;
+
+        CompressedSeries const* series_{};
+        size_type block_{};
+        std::uint32_t index_{};
+        std::uint32_t position_{};
+        std::uint64_t delta_{};
+        std::uint64_t bits_{};
+        unsigned leading_{};
+        unsigned trailing_{};
+        CompressedPoint point_{};
+
+        const_iterator(CompressedSeries const* series, size_type block) noexcept
+            : series_{series}
+        {
+            start(block);
+        }
+
+        void start(size_type block) noexcept
+        {
+            block_ = block;
+            index_ = 0;
+            if (block == series_->blocks_.size())
+            {
+                return;
+            }
+            auto const& first = series_->blocks_[block];
+            position_ = 0;
+            delta_ = 0;
+            bits_ = first.value;
+            point_ = {first.time, std::bit_cast<double>(first.value)};
+        }
+
+        std::uint64_t decodeDeltaOfDelta(block_type const& block) noexcept
+        {
+            unsigned prefix = 0;
+            while (prefix < 4 && block.read(position_, 1) != 0)
+            {
+                ++prefix;
+            }
+            if (prefix == 0)
+            {
+                return 0;
+            }
+            if (prefix == 4)
+            {
+                return block.read(position_, 64);
+            }
+            unsigned const lengths[] = {0, 7, 9, 12};
+            auto const length = lengths[prefix];
+            auto const value = block.read(position_, length);
+            return value > (std::uint64_t{1} << (length - 1)) ? value - (std::uint64_t{1} << length) : value;
+        }
+    };
+
+    using iterator = const_iterator;
+
+    CompressedSeries() = default;
+    CompressedSeries(CompressedSeries&&) = delete;
+    CompressedSeries(CompressedSeries const&) = delete;
+    CompressedSeries& operator=(CompressedSeries&&) = delete;
+    CompressedSeries& operator=(CompressedSeries const&) = delete;
+
+    void push(time_type time, double value) noexcept
+    {
+        auto const bits = std::bit_cast<std::uint64_t>(value);
+        if (blocks_.empty() || blocks_.back().bits + maxPointBits > block_type::words * 64)
+        {
+            if (blocks_.full())
+            {
+                size_ -= blocks_.front().count;
+            }
+            auto& block = blocks_.emplace();
+            block.time = time;
+            block.value = bits;
+            block.count = 1;
+            delta_ = 0;
+            leading_ = trailing_ = 64;
+        }
+        else
+        {
+            auto& block = blocks_.back();
+            encodeTime(block, static_cast<std::uint64_t>(time) - static_cast<std::uint64_t>(last_.time));
+            encodeValue(block, bits ^ std::bit_cast<std::uint64_t>(last_.value));
+            ++block.count;
+        }
+        last_ = {time, value};
+        ++size_;
+    }
+
+    void clear() noexcept
+    {
+        blocks_.clear();
+        size_ = 0;
+    }
+
+    [[nodiscard]] const_iterator begin() const noexcept
+    {
+        return const_iterator{this, 0};
+    }
+
+    [[nodiscard]] const_iterator end() const noexcept
+    {
+        return const_iterator{this, blocks_.size()};
+    }
+
+    // The newest point, the series must not be empty
+    [[nodiscard]] CompressedPoint const& back() const noexcept
+    {
+        return last_;
+    }
+
+    // Number of points in the series
+    [[nodiscard]] size_type size() const noexcept
+    {
+        return size_;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    // Number of blocks in use
+    [[nodiscard]] size_type blocks() const noexcept
+    {
+        return blocks_.size();
+    }
+
+    // Number of bytes the points are encoded in, which excludes the unused
+    // part of the newest block
+    [[nodiscard]] size_type encoded_bytes() const noexcept
+    {
+        if (blocks_.empty())
+        {
+            return 0;
+        }
+        return (blocks_.size() - 1) * BlockSize + offsetof(block_type, stream) + (blocks_.back().bits + 7) / 8;
+    }
+
+    [[nodiscard]] size_type capacity() const noexcept
+    {
+        return Blocks;
+    }
+
+    [[nodiscard]] static constexpr size_type block_size() noexcept
+    {
+        return BlockSize;
+    }
+
+  private:
+    ::RB_NAMESPACE_NAME::RingBuffer<block_type, Blocks> blocks_;
+    size_type size_{};
+    CompressedPoint last_{};
+    std::uint64_t delta_{};   // Time between the last two points of the newest block
+    unsigned leading_{64};    // Leading zeros of the last stored XOR, 64 if there is none
+    unsigned trailing_{64};   // Trailing zeros of the last stored XOR
+
+    void encodeTime(block_type& block, std::uint64_t delta) noexcept
+    {
+        auto const deltaOfDelta = static_cast<std::int64_t>(delta - delta_);
+        delta_ = delta;
+        auto const bits = static_cast<std::uint64_t>(deltaOfDelta);
+        if (deltaOfDelta == 0)
+        {
+            block.write(0b0, 1);
+        }
+        else if (deltaOfDelta >= -63 && deltaOfDelta <= 64)
+        {
+            block.write(0b10, 2);
+            block.write(bits & 0x7F, 7);
+        }
+        else if (deltaOfDelta >= -255 && deltaOfDelta <= 256)
+        {
+            block.write(0b110, 3);
+            block.write(bits & 0x1FF, 9);
+        }
+        else if (deltaOfDelta >= -2047 && deltaOfDelta <= 2048)
+        {
+            block.write(0b1110, 4);
+            block.write(bits & 0xFFF, 12);
+        }
+        else
+        {
+            block.write(0b1111, 4);
+            block.write(bits, 64);
+        }
+    }
+
+    void encodeValue(block_type& block, std::uint64_t xored) noexcept
+    {
+        if (xored == 0)
+        {
+            block.write(0b0, 1);
+            return;
+        }
+        auto const leading = std::min(static_cast<unsigned>(std::countl_zero(xored)), 31u);
+        auto const trailing = static_cast<unsigned>(std::countr_zero(xored));
+        if (leading >= leading_ && trailing >= trailing_)
+        {
+            // The meaningful bits fit into the window of the previous value
+            block.write(0b10, 2);
+            block.write(xored >> trailing_, 64 - leading_ - trailing_);
+            return;
+        }
+        auto const meaningful = 64 - leading - trailing;
+        block.write(0b11, 2);
+        block.write(leading, 5);
+        block.write(meaningful - 1, 6);
+        block.write(xored >> trailing, meaningful);
+        leading_ = leading;
+        trailing_ = trailing;
+    }
+};
+
+CS_END_NAMESPACE
+
+#endif // CS_COMPRESSED_SERIES_HPP_INCLUDED
@@ -0,0 +1,190 @@
+//
+// Window of recently seen keys for dropping duplicates
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#ifndef DW_DEDUP_WINDOW_HPP_INCLUDED
+#define DW_DEDUP_WINDOW_HPP_INCLUDED
+
+// Configure namespace preference for DedupWindow.
+// By default namespace utl is used.
+#define DW_NAMESPACE_NAME utl
+
+// clang-format off
+#ifndef DW_BEGIN_NAMESPACE
+#define DW_BEGIN_NAMESPACE namespace DW_NAMESPACE_NAME {
+#endif // DW_BEGIN_NAMESPAC
+#ifndef DW_END_NAMESPACE
+#define DW_END_NAMESPACE }
+#endif // DW_END_NAMESPACE
+// clang-format on
+
+#include "ring_buffer.hpp"
+
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <type_traits>
+
+DW_BEGIN_NAMESPACE
+
+// The last N distinct keys inserted, for dropping retransmitted messages:
+//
+//   auto seen = std::make_unique<DedupWindow<std::uint64_t, 65536>>();
+//   if (seen->insert(message.id))
+//       process(message);
+//
+// insert() returns false for a key which is in the window. A new key enters
+// the window and, if the window is full, the oldest key leaves it. The keys
+// are kept twice: in a RingBuffer, which decides the order of expiry, and in
+// an open addressing hash table with linear probing. The table is at most
+// half full and removes keys by shifting later keys of the probe sequence
+// back, so it needs no tombstones and its lookups do not degrade over time.
+// Both live in inline storage, the window never allocates.
+template<typename Key, std::size_t N, typename Hash = std::hash<Key>>
+class DedupWindow
+{
+  public:
+    static_assert(N > 0, "Template argument N must not be zero");
+    static_assert(N < std::numeric_limits<std::uint32_t>::max() / 2, "Template argument N is too large");
+    static_assert(std::is_trivially_copyable_v<Key>, "DedupWindow requires trivially copyable keys");
+
+    using key_type = Key;
+    using hasher = Hash;
+    using size_type = std::size_t;
+    using ring_buffer_type = ::RB_NAMESPACE_NAME::RingBuffer<Key, N>;
+
+    DedupWindow() = default;
+    DedupWindow(DedupWindow&&) = delete;
+    DedupWindow(DedupWindow const&) = delete;
+    DedupWindow& operator=(DedupWindow&&) = delete;
+    DedupWindow& operator=(DedupWindow const&) = delete;
+
+    // Adds key to the window unless it is in it already. Returns true if key
+    // was added, i.e. has not been seen within the last N distinct keys.
+    bool insert(Key const& key) noexcept
+    {
+        auto position = homeOf(key);
+        while (occupied(position))
+        {
+            if (table_[position] == key)
+            {
+                return false;
+            }
+            position = (position + 1) & mask;
+        }
+        if (keys_.full())
+        {
+            erase(keys_.front());
+            keys_.pop();
+            // The gap may have moved entries of the probe sequence of key
+            position = homeOf(key);
+            while (occupied(position))
+            {
+                position = (position + 1) & mask;
+            }
+        }
+        table_[position] = key;
+        occupied_[position / 64] |= std::uint64_t{1} << (position % 64);
+        keys_.push(key);
+        return true;
+    }
+
+    [[nodiscard]] bool contains(Key const& key) const noexcept
+    {
+        for (auto position = homeOf(key); occupied(position); position = (position + 1) & mask)
+        {
+            if (table_[position] == key)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void clear() noexcept
+    {
+        keys_.clear();
+        for (auto& word : occupied_)
+        {
+            word = 0;
+        }
+    }
+
+    // The keys of the window, oldest first
+    [[nodiscard]] ring_buffer_type const& keys() const noexcept
+    {
+        return keys_;
+    }
+
+    [[nodiscard]] size_type size() const noexcept
+    {
+        return keys_.size();
+    }
+
+    [[nodiscard]] size_type capacity() const noexcept
+    {
+        return N;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return keys_.empty();
+    }
+
+    [[nodiscard]] bool full() const noexcept
+    {
+        return keys_.full();
+    }
+
+  private:
+    static constexpr std::uint32_t tableSize = std::bit_ceil(static_cast<std::uint32_t>(2 * N));
+    static constexpr std::uint32_t mask = tableSize - 1;
+
+    ring_buffer_type keys_;
+    std::uint64_t occupied_[(tableSize + 63) / 64]{};
+    Key table_[tableSize];
+
+    std::uint32_t homeOf(Key const& key) const noexcept
+    {
+        // Fibonacci hashing, so weak hashes like the identity spread evenly
+        auto const hash = static_cast<std::uint64_t>(Hash{}(key)) * 0x9E3779B97F4A7C15ull;
+        return static_cast<std::uint32_t>(hash >> 32) & mask;
+    }
+
+    bool occupied(std::uint32_t position) const noexcept
+    {
+        return (occupied_[position / 64] >> (position % 64) & 1) != 0;
+    }
+
+    // Removes key from the table, it must be in it
+    void erase(Key const& key) noexcept
+    {
+        auto position = homeOf(key);
+        while (!(table_[position] == key))
+        {
+            position = (position + 1) & mask;
+        }
+        // Shift later entries of the probe sequence back into the gap, unless
+        // their home lies cyclically after the gap
+        for (auto next = (position + 1) & mask; occupied(next); next = (next + 1) & mask)
+        {
+            auto const home = homeOf(table_[next]);
+            if (((next - home) & mask) >= ((next - position) & mask))
+            {
+                table_[position] = table_[next];
+                position = next;
+            }
+        }
+        occupied_[position / 64] &= ~(std::uint64_t{1} << (position % 64));
+    }
+};
+
+DW_END_NAMESPACE
+
+#endif // DW_DEDUP_WINDOW_HPP_INCLUDED
@@ -0,0 +1,275 @@
+//
+// Delay line with contiguous windows and SIMD FIR filter kernels
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#ifndef DL_DELAY_LINE_HPP_INCLUDED
+#define DL_DELAY_LINE_HPP_INCLUDED
+
+// Configure namespace preference for DelayLine.
+// By default namespace utl is used.
+#define DL_NAMESPACE_NAME utl
+
+// clang-format off
+#ifndef DL_BEGIN_NAMESPACE
+#define DL_BEGIN_NAMESPACE namespace DL_NAMESPACE_NAME {
+#endif // DL_BEGIN_NAMESPAC
+#ifndef DL_END_NAMESPACE
+#define DL_END_NAMESPACE }
+#endif // DL_END_NAMESPACE
+// clang-format on
+
+#include "simd_level.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <span>
+
+DL_BEGIN_NAMESPACE
+
+namespace detail
+{
+    using DotKernel = float (*)(float const* a, float const* b, std::size_t n) noexcept;
+
+    // Eight independent partial sums, so the additions need not wait for
+    // each other even where the compiler does not vectorize
+    inline float dotScalar(float const* a, float const* b, std::size_t n) noexcept
+    {
+        float sums[8]{};
+        std::size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            for (std::size_t lane = 0; lane < 8; ++lane)
+            {
+                sums[lane] += a[i + lane] * b[i + lane];
+            }
+        }
+        for (; i < n; ++i)
+        {
+            sums[i % 8] += a[i] * b[i];
+        }
+        return ((sums[0] + sums[4]) + (sums[1] + sums[5])) + ((sums[2] + sums[6]) + (sums[3] + sums[7]));
+    }
+
+#ifdef SL_HAS_X86_DISPATCH
+    __attribute__((target("sse2"))) inline float dotSse(float const* a, float const* b, std::size_t n) noexcept
+    {
+        __m128 sums[4]{_mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps()};
+        std::size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            for (std::size_t k = 0; k < 4; ++k)
+            {
+                sums[k] = _mm_add_ps(sums[k], _mm_mul_ps(_mm_loadu_ps(a + i + 4 * k), _mm_loadu_ps(b + i + 4 * k)));
+            }
+        }
+        for (; i + 4 <= n; i += 4)
+        {
+            sums[0] = _mm_add_ps(sums[0], _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        }
+        auto const sum = _mm_add_ps(_mm_add_ps(sums[0], sums[1]), _mm_add_ps(sums[2], sums[3]));
+        alignas(16) float lanes[4];
+        _mm_store_ps(lanes, sum);
+        auto result = (lanes[0] + lanes[2]) + (lanes[1] + lanes[3]);
+        for (; i < n; ++i)
+        {
+            result += a[i] * b[i];
+        }
+        return result;
+    }
+
+    __attribute__((target("avx2,fma"))) inline float dotAvx2(float const* a, float const* b, std::size_t n) noexcept
+    {
+        __m256 sums[4]{_mm256_setzero_ps(), _mm256_setzero_ps(), _mm256_setzero_ps(), _mm256_setzero_ps()};
+        std::size_t i = 0;
+        for (; i + 32 <= n; i += 32)
+        {
+            for (std::size_t k = 0; k < 4; ++k)
+            {
+                sums[k] = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8 * k), _mm256_loadu_ps(b + i + 8 * k), sums[k]);
+            }
+        }
+        for (; i + 8 <= n; i += 8)
+        {
+            sums[0] = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), sums[0]);
+        }
+        auto const sum8 = _mm256_add_ps(_mm256_add_ps(sums[0], sums[1]), _mm256_add_ps(sums[2], sums[3]));
+        auto const sum4 = _mm_add_ps(_mm256_castps256_ps128(sum8), _mm256_extractf128_ps(sum8, 1));
+        alignas(16) float lanes[4];
+        _mm_store_ps(lanes, sum4);
+        auto result = (lanes[0] + lanes[2]) + (lanes[1] + lanes[3]);
+        for (; i < n; ++i)
+        {
+            result += a[i] * b[i];
+        }
+        return result;
+    }
+#endif // SL_HAS_X86_DISPATCH
+
+    inline DotKernel dotKernel(::SL_NAMESPACE_NAME::SimdLevel level) noexcept
+    {
+        switch (level)
+        {
+#ifdef SL_HAS_X86_DISPATCH
+            case ::SL_NAMESPACE_NAME::SimdLevel::avx512:
+            case ::SL_NAMESPACE_NAME::SimdLevel::avx2:
+                return &dotAvx2;
+            case ::SL_NAMESPACE_NAME::SimdLevel::sse:
+                return &dotSse;
+#endif // SL_HAS_X86_DISPATCH
+            default:
+                return &dotScalar;
+        }
+    }
+} // namespace detail
+
+// Dot product of a and b, computed by the kernel of level, which must not
+// exceed simd_level(). The kernels sum in different orders, so their results
+// may differ in the last bits.
+[[nodiscard]] inline float dot(::SL_NAMESPACE_NAME::SimdLevel level, std::span<float const> a, std::span<float const> b) noexcept
+{
+    return detail::dotKernel(level)(a.data(), b.data(), std::min(a.size(), b.size()));
+}
+
+// Dot product of a and b by the best kernel of the processor
+[[nodiscard]] inline float dot(std::span<float const> a, std::span<float const> b) noexcept
+{
+    static detail::DotKernel const kernel = detail::dotKernel(::SL_NAMESPACE_NAME::simd_level());
+    return kernel(a.data(), b.data(), std::min(a.size(), b.size()));
+}
+
+// The last N samples of a stream, oldest first, as one contiguous span:
+//
+//   DelayLine<float, 512> line;
+//   line.push(sample);
+//   auto const output = dot(line.last(taps.size()), reversedTaps);
+//
+// Every sample is stored twice, at slot i and i + N of a storage of 2 * N
+// samples, so the window starting after the slot written last never wraps
+// around. Unlike iterating a RingBuffer, the kernels see plain arrays they
+// can load with vector instructions, at the cost of a second store per push.
+// A new delay line holds N value initialized samples.
+template<typename T, std::size_t N>
+class DelayLine
+{
+  public:
+    static_assert(N > 0, "Template argument N must not be zero");
+
+    using value_type = T;
+    using size_type = std::size_t;
+
+    DelayLine() = default;
+    DelayLine(DelayLine&&) = delete;
+    DelayLine(DelayLine const&) = delete;
+    DelayLine& operator=(DelayLine&&) = delete;
+    DelayLine& operator=(DelayLine const&) = delete;
+
+    void push(T const& sample) noexcept
+    {
+        storage_[write_] = sample;
+        storage_[write_ + N] = sample;
+        write_ = write_ + 1 == N ? 0 : write_ + 1;
+    }
+
+    // The last N samples, oldest first
+    [[nodiscard]] std::span<T const, N> window() const noexcept
+    {
+        return std::span<T const, N>{storage_ + write_, N};
+    }
+
+    // The last count samples (at most N), oldest first
+    [[nodiscard]] std::span<T const> last(size_type count) const noexcept
+    {
+        return {storage_ + write_ + N - count, count};
+    }
+
+    // The sample pushed delay pushes ago, 0 is the newest one
+    [[nodiscard]] T const& operator[](size_type delay) const noexcept
+    {
+        return storage_[write_ + N - 1 - delay];
+    }
+
+    // Resets all samples to value
+    void fill(T const& value) noexcept
+    {
+        std::fill(std::begin(storage_), std::end(storage_), value);
+        write_ = 0;
+    }
+
+    [[nodiscard]] constexpr size_type size() const noexcept
+    {
+        return N;
+    }
+
+  private:
+    T storage_[2 * N]{};
+    size_type write_{}; // Slot receiving the next sample, the window starts there
+};
+
+// Finite impulse response filter of up to N taps on a DelayLine:
+//
+//   FirFilter<512> smoothing{coefficients};
+//   auto const smoothed = smoothing.process(sample);
+//
+// process() returns the sum of coefficient k times the sample pushed k
+// pushes ago, computed by the best dot product kernel of the processor.
+template<std::size_t N>
+class FirFilter
+{
+  public:
+    using size_type = std::size_t;
+
+    // At most N coefficients, the first one applies to the newest sample
+    explicit FirFilter(std::span<float const> coefficients) noexcept
+        : taps_{std::min(coefficients.size(), N)}
+    {
+        std::reverse_copy(coefficients.begin(), coefficients.begin() + static_cast<std::ptrdiff_t>(taps_), reversed_);
+    }
+
+    FirFilter(FirFilter&&) = delete;
+    FirFilter(FirFilter const&) = delete;
+    FirFilter& operator=(FirFilter&&) = delete;
+    FirFilter& operator=(FirFilter const&) = delete;
+
+    // Pushes sample and returns the filter output
+    float process(float sample) noexcept
+    {
+        line_.push(sample);
+        return dot(line_.last(taps_), {reversed_, taps_});
+    }
+
+    // Like process(), computed by the kernel of level
+    float process(::SL_NAMESPACE_NAME::SimdLevel level, float sample) noexcept
+    {
+        line_.push(sample);
+        return dot(level, line_.last(taps_), {reversed_, taps_});
+    }
+
+    void reset() noexcept
+    {
+        line_.fill(0.0f);
+    }
+
+    [[nodiscard]] size_type taps() const noexcept
+    {
+        return taps_;
+    }
+
+    [[nodiscard]] DelayLine<float, N> const& line() const noexcept
+    {
+        return line_;
+    }
+
+  private:
+    DelayLine<float, N> line_;
+    float reversed_[N]{}; // Coefficients, the one of the oldest sample first
+    size_type taps_;
+};
+
+DL_END_NAMESPACE
+
+#endif // DL_DELAY_LINE_HPP_INCLUDED
@@ -0,0 +1,198 @@
+//
+// Memory resource backed by huge pages
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#ifndef HP_HUGE_PAGE_RESOURCE_HPP_INCLUDED
+#define HP_HUGE_PAGE_RESOURCE_HPP_INCLUDED
+
+// Configure namespace preference for HugePageResource.
+// By default namespace utl is used.
+#define HP_NAMESPACE_NAME utl
+
+// clang-format off
+#ifndef HP_BEGIN_NAMESPACE
+#define HP_BEGIN_NAMESPACE namespace HP_NAMESPACE_NAME {
+#endif // HP_BEGIN_NAMESPAC
+#ifndef HP_END_NAMESPACE
+#define HP_END_NAMESPACE }
+#endif // HP_END_NAMESPACE
+// clang-format on
+
+#include <memory_resource>
+#include <cstdint>
+#include <atomic>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+#endif // __linux__
+
+HP_BEGIN_NAMESPACE
+
+enum class HugePageSize : std::size_t
+{
+    Size2MB = std::size_t{2} << 20,
+    Size1GB = std::size_t{1} << 30,
+};
+
+// Allocates memory in multiples of huge pages to reduce TLB misses when large
+// buffers are scanned. Every allocation is a separate mapping, so the resource
+// is meant for few large buffers such as the storage of a UniqueBuffer or a big
+// RingBuffer constructed in place:
+//
+//   HugePageResource memres{{HugePageSize::Size2MB, true}};
+//   UniqueBuffer ub{sizeof(RingBuffer<Tick, 1 << 24>), memres};
+//   auto rb = std::construct_at(static_cast<RingBuffer<Tick, 1 << 24>*>(ub.get()));
+//
+// On Linux, memory is first requested from the hugetlbfs pool via
+// mmap(MAP_HUGETLB). If the pool is exhausted or not configured the mapping is
+// made of regular pages, aligned to the huge page size and madvise(MADV_HUGEPAGE)
+// asks the kernel to back it with transparent huge pages. With prefault set, all
+// pages are populated during allocation so that first touch page faults do not
+// happen on the hot path later on. Other platforms use the upstream resource.
+class HugePageResource : public std::pmr::memory_resource
+{
+  public:
+    struct Options
+    {
+        HugePageSize pageSize{HugePageSize::Size2MB};
+        bool prefault{false};
+        bool transparentFallback{true}; // Fall back to madvise(MADV_HUGEPAGE) if MAP_HUGETLB fails
+    };
+
+    HugePageResource() noexcept = default;
+    HugePageResource(HugePageResource const&) = delete;
+    HugePageResource& operator=(HugePageResource const&) = delete;
+
+    explicit HugePageResource(Options options, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()) noexcept
+        : options_{options}
+        , upstream_{upstream}
+    {
+    }
+
+    [[nodiscard]] std::size_t pageSize() const noexcept
+    {
+        return static_cast<std::size_t>(options_.pageSize);
+    }
+
+    // Number of allocations served by the hugetlbfs pool
+    [[nodiscard]] std::size_t hugetlbAllocations() const noexcept
+    {
+        return hugetlbAllocations_.load(std::memory_order_relaxed);
+    }
+
+    // Number of allocations served by transparent huge pages or the upstream resource
+    [[nodiscard]] std::size_t fallbackAllocations() const noexcept
+    {
+        return fallbackAllocations_.load(std::memory_order_relaxed);
+    }
+
+  private:
+    Options options_{};
+    [[maybe_unused]] std::pmr::memory_resource* upstream_{std::pmr::new_delete_resource()};
+    std::atomic<std::size_t> hugetlbAllocations_{};
+    std::atomic<std::size_t> fallbackAllocations_{};
+
+    std::size_t roundUp(std::size_t bytes) const noexcept
+    {
+        return (bytes + pageSize() - 1) & ~(pageSize() - 1);
+    }
+
+#if defined(__linux__)
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        if (alignment > pageSize())
+        {
+            throw std::bad_alloc();
+        }
+        auto const size = roundUp(bytes);
+        auto const log2PageSize = options_.pageSize == HugePageSize::Size1GB ? 30 : 21;
+        auto flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (log2PageSize << MAP_HUGE_SHIFT);
+        if (options_.prefault)
+        {
+            flags |= MAP_POPULATE;
+        }
+        auto p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+        if (p != MAP_FAILED)
+        {
+            hugetlbAllocations_.fetch_add(1, std::memory_order_relaxed);
+            return p;
+        }
+        if (!options_.transparentFallback)
+        {
+            throw std::bad_alloc();
+        }
+
+        // Over-allocate regular pages to be able to cut out a huge page aligned region
+        auto const mapped = size + pageSize();
+        p = ::mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED)
+        {
+            throw std::bad_alloc();
+        }
+        auto const begin = reinterpret_cast<std::uintptr_t>(p);
+        auto const aligned = (begin + pageSize() - 1) & ~std::uintptr_t{pageSize() - 1};
+        if (aligned != begin)
+        {
+            ::munmap(p, aligned - begin);
+        }
+        if (auto const tail = begin + mapped - (aligned + size); tail != 0)
+        {
+            ::munmap(reinterpret_cast<void*>(aligned + size), tail);
+        }
+        p = reinterpret_cast<void*>(aligned);
+        ::madvise(p, size, MADV_HUGEPAGE);
+        if (options_.prefault)
+        {
+            prefault(static_cast<std::byte*>(p), size);
+        }
+        fallbackAllocations_.fetch_add(1, std::memory_order_relaxed);
+        return p;
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t) override
+    {
+        ::munmap(p, roundUp(bytes));
+    }
+
+    static void prefault(std::byte* p, std::size_t size) noexcept
+    {
+        // Writing is required, reading would map the shared zero page
+        static auto const basePageSize = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        for (std::size_t offset = 0; offset < size; offset += basePageSize)
+        {
+            *static_cast<std::byte volatile*>(p + offset) = std::byte{};
+        }
+    }
+#else  // __linux__
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        auto p = upstream_->allocate(bytes, alignment);
+        fallbackAllocations_.fetch_add(1, std::memory_order_relaxed);
+        return p;
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+    {
+        upstream_->deallocate(p, bytes, alignment);
+    }
+#endif // __linux__
+
+    bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+HP_END_NAMESPACE
+
+#endif // HP_HUGE_PAGE_RESOURCE_HPP_INCLUDED
@@ -0,0 +1,246 @@
+//
+// Lock-free log-linear latency histogram and RingBuffer latency instrumentation
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#ifndef LH_LATENCY_HISTOGRAM_HPP_INCLUDED
+#define LH_LATENCY_HISTOGRAM_HPP_INCLUDED
+
+// Configure namespace preference for LatencyHistogram.
+// By default namespace utl is used.
+#define LH_NAMESPACE_NAME utl
+
+// clang-format off
+#ifndef LH_BEGIN_NAMESPACE
+#define LH_BEGIN_NAMESPACE namespace LH_NAMESPACE_NAME {
+#endif // LH_BEGIN_NAMESPAC
+#ifndef LH_END_NAMESPACE
+#define LH_END_NAMESPACE }
+#endif // LH_END_NAMESPACE
+// clang-format on
+
+#include "tick_clock.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <limits>
+
+LH_BEGIN_NAMESPACE
+
+// Histogram of unsigned 64 bit values (typically clock ticks) in the spirit of
+// HdrHistogram. Values below 32 are counted exactly, larger values fall into one
+// of 32 linear sub-buckets per power of two, which bounds the relative error of
+// any reported value to about 3%. Recording is lock-free and may happen from any
+// number of threads while another thread takes snapshots.
+class LatencyHistogram
+{
+  public:
+    static constexpr unsigned subBucketBits = 5;
+    static constexpr std::size_t subBucketCount = std::size_t{1} << subBucketBits;
+    static constexpr std::size_t bucketCount = (64 - subBucketBits + 1) * subBucketCount;
+
+    // Immutable copy of a histogram. All values are multiplied by the scale
+    // the snapshot has been taken with, e.g. to convert ticks into nanoseconds.
+    class Snapshot
+    {
+      public:
+        [[nodiscard]] std::uint64_t count() const noexcept
+        {
+            return count_;
+        }
+
+        [[nodiscard]] double min() const noexcept
+        {
+            return count_ == 0 ? 0.0 : static_cast<double>(min_) * scale_;
+        }
+
+        [[nodiscard]] double max() const noexcept
+        {
+            return static_cast<double>(max_) * scale_;
+        }
+
+        [[nodiscard]] double mean() const noexcept
+        {
+            return count_ == 0 ? 0.0 : static_cast<double>(sum_) / static_cast<double>(count_) * scale_;
+        }
+
+        // Returns the value below or at which percentile percent of all recorded values fall
+        [[nodiscard]] double percentile(double percent) const noexcept
+        {
+            if (count_ == 0)
+            {
+                return 0.0;
+            }
+            auto const rank = std::max<std::uint64_t>(
+                1, static_cast<std::uint64_t>(std::clamp(percent, 0.0, 100.0) / 100.0 * static_cast<double>(count_) + 0.5));
+            std::uint64_t seen = 0;
+            for (std::size_t index = 0; index < bucketCount; ++index)
+            {
+                seen += counts_[index];
+                if (seen >= rank)
+                {
+                    return static_cast<double>(std::clamp(upperBound(index), min_, max_)) * scale_;
+                }
+            }
+            return max();
+        }
+
+      private:
+        friend class LatencyHistogram;
+
+        std::array<std::uint64_t, bucketCount> counts_{};
+        std::uint64_t count_{};
+        std::uint64_t sum_{};
+        std::uint64_t min_{};
+        std::uint64_t max_{};
+        double scale_{1.0};
+    };
+
+    LatencyHistogram() noexcept = default;
+    LatencyHistogram(LatencyHistogram&&) = delete;
+    LatencyHistogram(LatencyHistogram const&) = delete;
+    LatencyHistogram& operator=(LatencyHistogram&&) = delete;
+    LatencyHistogram& operator=(LatencyHistogram const&) = delete;
+
+    void record(std::uint64_t value) noexcept
+    {
+        counts_[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(value, std::memory_order_relaxed);
+        auto min = min_.load(std::memory_order_relaxed);
+        while (value < min && !min_.compare_exchange_weak(min, value, std::memory_order_relaxed))
+        {
+        }
+        auto max = max_.load(std::memory_order_relaxed);
+        while (value > max && !max_.compare_exchange_weak(max, value, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    [[nodiscard]] Snapshot snapshot(double scale = 1.0) const noexcept
+    {
+        Snapshot snapshot;
+        for (std::size_t index = 0; index < bucketCount; ++index)
+        {
+            snapshot.counts_[index] = counts_[index].load(std::memory_order_relaxed);
+            snapshot.count_ += snapshot.counts_[index];
+        }
+        snapshot.sum_ = sum_.load(std::memory_order_relaxed);
+        snapshot.min_ = min_.load(std::memory_order_relaxed);
+        snapshot.max_ = max_.load(std::memory_order_relaxed);
+        snapshot.scale_ = scale;
+        return snapshot;
+    }
+
+    // Reads and resets the histogram. Every recorded value ends up in exactly
+    // one snapshot, even if values are recorded concurrently.
+    [[nodiscard]] Snapshot takeSnapshot(double scale = 1.0) noexcept
+    {
+        Snapshot snapshot;
+        for (std::size_t index = 0; index < bucketCount; ++index)
+        {
+            snapshot.counts_[index] = counts_[index].exchange(0, std::memory_order_relaxed);
+            snapshot.count_ += snapshot.counts_[index];
+        }
+        snapshot.sum_ = sum_.exchange(0, std::memory_order_relaxed);
+        snapshot.min_ = min_.exchange(std::numeric_limits<std::uint64_t>::max(), std::memory_order_relaxed);
+        snapshot.max_ = max_.exchange(0, std::memory_order_relaxed);
+        snapshot.scale_ = scale;
+        return snapshot;
+    }
+
+    void reset() noexcept
+    {
+        static_cast<void>(takeSnapshot());
+    }
+
+    [[nodiscard]] static constexpr std::size_t bucketIndex(std::uint64_t value) noexcept
+    {
+        if (value < subBucketCount)
+        {
+            return static_cast<std::size_t>(value);
+        }
+        auto const group = static_cast<std::size_t>(std::bit_width(value)) - subBucketBits;
+        return (group << subBucketBits) + static_cast<std::size_t>((value >> (group - 1)) - subBucketCount);
+    }
+
+    // Largest value counted in the bucket at index
+    [[nodiscard]] static constexpr std::uint64_t upperBound(std::size_t index) noexcept
+    {
+        if (index < subBucketCount)
+        {
+            return index;
+        }
+        auto const group = index >> subBucketBits;
+        auto const subBucket = index & (subBucketCount - 1);
+        return ((std::uint64_t{subBucketCount + subBucket + 1}) << (group - 1)) - 1;
+    }
+
+  private:
+    std::atomic<std::uint64_t> counts_[bucketCount]{};
+    std::atomic<std::uint64_t> sum_{};
+    std::atomic<std::uint64_t> min_{std::numeric_limits<std::uint64_t>::max()};
+    std::atomic<std::uint64_t> max_{};
+};
+
+// RingBuffer policy measuring how long elements stay in the ring buffer. The
+// enqueue time of every element is stamped into an array parallel to the ring
+// buffer's storage and on pop() the sojourn time is recorded in a histogram.
+// Overwritten elements are not recorded. Snapshots are in nanoseconds.
+//
+//   RingBuffer<Order, 1024, RingBufferLatency> rb;
+//   ...
+//   auto const p99 = rb.policy().snapshot().percentile(99.0);
+template<std::size_t Slots, typename Clock = ::TC_NAMESPACE_NAME::DefaultTickClock>
+class RingBufferLatency
+{
+  public:
+    void pushed(std::size_t slot, std::size_t) noexcept
+    {
+        stamps_[slot] = Clock::now();
+    }
+
+    void popped(std::size_t slot, std::size_t) noexcept
+    {
+        histogram_.record(Clock::now() - stamps_[slot]);
+    }
+
+    constexpr void overwritten(std::size_t, std::size_t) noexcept
+    {
+    }
+
+    [[nodiscard]] LatencyHistogram::Snapshot snapshot() const noexcept
+    {
+        return histogram_.snapshot(Clock::nanosecondsPerTick());
+    }
+
+    [[nodiscard]] LatencyHistogram::Snapshot takeSnapshot() noexcept
+    {
+        return histogram_.takeSnapshot(Clock::nanosecondsPerTick());
+    }
+
+    void reset() noexcept
+    {
+        histogram_.reset();
+    }
+
+    // Raw histogram in ticks of Clock
+    [[nodiscard]] LatencyHistogram& histogram() noexcept
+    {
+        return histogram_;
+    }
+
+  private:
+    std::uint64_t stamps_[Slots]{};
+    LatencyHistogram histogram_;
+};
+
+LH_END_NAMESPACE
+
+#endif // LH_LATENCY_HISTOGRAM_HPP_INCLUDED
@@ -0,0 +1,270 @@
+//
+// Fixed size pool of objects in inline storage
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#ifndef OP_OBJECT_POOL_HPP_INCLUDED
+#define OP_OBJECT_POOL_HPP_INCLUDED
+
+// Configure namespace preference for ObjectPool.
+// By default namespace utl is used.
+#define OP_NAMESPACE_NAME utl
+
+// clang-format off
+#ifndef OP_BEGIN_NAMESPACE
+#define OP_BEGIN_NAMESPACE namespace OP_NAMESPACE_NAME {
+#endif // OP_BEGIN_NAMESPAC
+#ifndef OP_END_NAMESPACE
+#define OP_END_NAMESPACE }
+#endif // OP_END_NAMESPACE
+// clang-format on
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+OP_BEGIN_NAMESPACE
+
+namespace detail
+{
+    // Stack of free slot indices of a pool used by one thread. Slots which have
+    // never been handed out are not on the stack but taken in storage order, so
+    // construction is O(1) and memory is touched sequentially at first.
+    template<std::size_t N, bool Shared>
+    class ObjectPoolFreeList
+    {
+      public:
+        static constexpr std::uint32_t npos = std::numeric_limits<std::uint32_t>::max();
+
+        std::uint32_t pop() noexcept
+        {
+            if (top_ != 0)
+            {
+                return free_[--top_];
+            }
+            return fresh_ < N ? fresh_++ : npos;
+        }
+
+        void push(std::uint32_t index) noexcept
+        {
+            free_[top_++] = index;
+        }
+
+      private:
+        std::uint32_t top_{};
+        std::uint32_t fresh_{};
+        std::uint32_t free_[N];
+    };
+
+    // Lock-free stack of free slot indices (Treiber stack). The head holds the
+    // index of the top slot and a tag incremented on every update, which rules
+    // out the ABA problem.
+    template<std::size_t N>
+    class ObjectPoolFreeList<N, true>
+    {
+      public:
+        static constexpr std::uint32_t npos = std::numeric_limits<std::uint32_t>::max();
+
+        ObjectPoolFreeList() noexcept
+        {
+            for (std::uint32_t index = 0; index < N; ++index)
+            {
+                next_[index].store(index + 1 < N ? index + 1 : npos, std::memory_order_relaxed);
+            }
+        }
+
+        std::uint32_t pop() noexcept
+        {
+            auto head = head_.load(std::memory_order_acquire);
+            std::uint64_t top;
+            do
+            {
+                if (indexOf(head) == npos)
+                {
+                    return npos;
+                }
+                top = make(next_[indexOf(head)].load(std::memory_order_relaxed), head);
+            } while (!head_.compare_exchange_weak(head, top, std::memory_order_acquire, std::memory_order_acquire));
+            return indexOf(head);
+        }
+
+        void push(std::uint32_t index) noexcept
+        {
+            auto head = head_.load(std::memory_order_relaxed);
+            std::uint64_t top;
+            do
+            {
+                next_[index].store(indexOf(head), std::memory_order_relaxed);
+                top = make(index, head);
+            } while (!head_.compare_exchange_weak(head, top, std::memory_order_release, std::memory_order_relaxed));
+        }
+
+      private:
+        static constexpr std::size_t cacheLineSize = 64;
+
+        alignas(cacheLineSize) std::atomic<std::uint64_t> head_{0};
+        alignas(cacheLineSize) std::atomic<std::uint32_t> next_[N];
+
+        static std::uint32_t indexOf(std::uint64_t head) noexcept
+        {
+            return static_cast<std::uint32_t>(head);
+        }
+
+        static std::uint64_t make(std::uint32_t index, std::uint64_t previous) noexcept
+        {
+            return ((previous >> 32) + 1) << 32 | index;
+        }
+    };
+} // namespace detail
+
+// Deleter of the handles returned by ObjectPool::acquire()
+template<typename Pool>
+class ObjectPoolDeleter
+{
+  public:
+    ObjectPoolDeleter() noexcept = default;
+
+    explicit ObjectPoolDeleter(Pool* pool) noexcept
+        : pool_{pool}
+    {
+    }
+
+    void operator()(typename Pool::pointer p) const noexcept
+    {
+        pool_->release(p);
+    }
+
+  private:
+    Pool* pool_{};
+};
+
+// Pool of up to N objects of type T which live in inline storage of the pool
+// itself. acquire() constructs an object in a free slot and release() destroys
+// it and returns the slot, both in O(1) without touching the heap:
+//
+//   auto pool = std::make_unique<ObjectPool<Order, 65536>>();
+//   if (auto order = pool->acquire(id, price, quantity))
+//   {
+//       ...
+//   } // Released by the handle
+//
+// acquire() returns a std::unique_ptr with a deleter referring to the pool or
+// an empty handle if all slots are in use. Handles may be release()d to keep
+// raw pointers in intrusive structures, these are returned with pool.release(p).
+// All objects must be released before the pool is destroyed.
+//
+// BasicObjectPool<T, N, false> (ObjectPool) is for single threaded use.
+// BasicObjectPool<T, N, true> (LockFreeObjectPool) is lock-free and objects
+// may be acquired and released from any thread, e.g. released by a consumer
+// thread after they were handed over by the thread which acquired them.
+template<typename T, std::size_t N, bool Shared>
+class BasicObjectPool
+{
+  public:
+    static_assert(N > 0, "Template argument N must not be zero");
+    static_assert(N < std::numeric_limits<std::uint32_t>::max(), "Template argument N is too large");
+
+    using value_type = T;
+    using pointer = T*;
+    using const_pointer = T const*;
+    using size_type = std::size_t;
+    using deleter_type = ObjectPoolDeleter<BasicObjectPool>;
+    using handle_type = std::unique_ptr<T, deleter_type>;
+
+    BasicObjectPool() = default;
+    BasicObjectPool(BasicObjectPool&&) = delete;
+    BasicObjectPool(BasicObjectPool const&) = delete;
+    BasicObjectPool& operator=(BasicObjectPool&&) = delete;
+    BasicObjectPool& operator=(BasicObjectPool const&) = delete;
+
+    // Constructs an object from args in a free slot. Returns an empty handle
+    // if the pool is exhausted.
+    template<typename... Args>
+    [[nodiscard]] handle_type acquire(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>)
+    {
+        return handle_type{construct(std::forward<Args>(args)...), deleter_type{this}};
+    }
+
+    // Like acquire() but returns a raw pointer, nullptr if the pool is exhausted
+    template<typename... Args>
+    [[nodiscard]] pointer construct(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>)
+    {
+        auto const index = free_.pop();
+        if (index == free_.npos)
+        {
+            return nullptr;
+        }
+        if constexpr (std::is_nothrow_constructible_v<T, Args...>)
+        {
+            return std::construct_at(static_cast<T*>(storageAt(index)), std::forward<Args>(args)...);
+        }
+        else
+        {
+            try
+            {
+                return std::construct_at(static_cast<T*>(storageAt(index)), std::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                free_.push(index);
+                throw;
+            }
+        }
+    }
+
+    // Destroys an object acquired from this pool and returns its slot
+    void release(pointer p) noexcept
+    {
+        if (p != nullptr)
+        {
+            std::destroy_at(p);
+            free_.push(indexOf(p));
+        }
+    }
+
+    // Whether p points into the storage of this pool
+    [[nodiscard]] bool owns(const_pointer p) const noexcept
+    {
+        auto const begin = static_cast<void const*>(&storage_[0]);
+        auto const end = static_cast<void const*>(&storage_[N]);
+        auto const less = std::less<void const*>{};
+        return !less(p, begin) && less(p, end);
+    }
+
+    [[nodiscard]] size_type capacity() const noexcept
+    {
+        return N;
+    }
+
+  private:
+    detail::ObjectPoolFreeList<N, Shared> free_;
+    std::aligned_storage_t<sizeof(T), alignof(T)> storage_[N];
+
+    void* storageAt(std::uint32_t index) noexcept
+    {
+        return static_cast<void*>(&storage_[index]);
+    }
+
+    std::uint32_t indexOf(const_pointer p) const noexcept
+    {
+        return static_cast<std::uint32_t>(reinterpret_cast<decltype(&storage_[0])>(p) - &storage_[0]);
+    }
+};
+
+template<typename T, std::size_t N>
+using ObjectPool = BasicObjectPool<T, N, false>;
+
+template<typename T, std::size_t N>
+using LockFreeObjectPool = BasicObjectPool<T, N, true>;
+
+OP_END_NAMESPACE
+
+#endif // OP_OBJECT_POOL_HPP_INCLUDED
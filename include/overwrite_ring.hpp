@@ -0,0 +1,245 @@
+//
+// Lock-free multi-producer ring buffer which overwrites the oldest elements
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#ifndef OW_OVERWRITE_RING_HPP_INCLUDED
+#define OW_OVERWRITE_RING_HPP_INCLUDED
+
+// Configure namespace preference for OverwriteRing.
+// By default namespace utl is used.
+#define OW_NAMESPACE_NAME utl
+
+// clang-format off
+#ifndef OW_BEGIN_NAMESPACE
+#define OW_BEGIN_NAMESPACE namespace OW_NAMESPACE_NAME {
+#endif // OW_BEGIN_NAMESPAC
+#ifndef OW_END_NAMESPACE
+#define OW_END_NAMESPACE }
+#endif // OW_END_NAMESPACE
+// clang-format on
+
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+OW_BEGIN_NAMESPACE
+
+// Lossy ring of the last N elements pushed by any number of threads, for
+// telemetry which must never block its producers:
+//
+//   OverwriteRing<Sample, 4096> samples;
+//   samples.push(sample);                      // Any thread, never blocks
+//
+//   OverwriteRing<Sample, 4096>::Reader reader{samples};
+//   Sample sample;
+//   while (reader.try_read(sample))            // Oldest first
+//       record(sample);
+//
+// Like RingBuffer::emplace() on a full ring buffer, push() overwrites the
+// oldest element, but it is safe to call concurrently. A producer claims the
+// next ticket with a single fetch_add; the ticket's slot carries a sequence
+// stamp which is odd while the producer writes and even once the element is
+// published. Readers copy a slot like a seqlock: they check its stamp before
+// and after copying and skip the slot if a newer element overwrote it in the
+// meantime, so they never see torn elements. Elements are stored as relaxed
+// atomic words, T must be trivially copyable.
+//
+// Every Reader has its own position, so any number of readers see all elements
+// which are not overwritten before they get to them. Elements are lost if
+// a reader falls behind by more than N, or if a producer finds the slot of its
+// ticket still being written by a producer one lap behind, which then drops
+// its own element (dropped()). A producer which is preempted between claiming
+// and publishing its slot holds up the readers at that slot until it finishes
+// or the producers have moved on by N elements.
+template<typename T, std::size_t N>
+class OverwriteRing
+{
+  public:
+    static_assert(std::is_trivially_copyable_v<T>, "Template argument T must be trivially copyable");
+    static_assert(std::has_single_bit(N), "Template argument N must be a power of two");
+
+    using value_type = T;
+    using size_type = std::size_t;
+
+    class Reader;
+
+    OverwriteRing() = default;
+    OverwriteRing(OverwriteRing&&) = delete;
+    OverwriteRing(OverwriteRing const&) = delete;
+    OverwriteRing& operator=(OverwriteRing&&) = delete;
+    OverwriteRing& operator=(OverwriteRing const&) = delete;
+
+    void push(T const& element) noexcept
+    {
+        auto const ticket = head_.fetch_add(1, std::memory_order_relaxed);
+        auto& slot = slots_[ticket & (N - 1)];
+        auto stamp = slot.stamp.load(std::memory_order_relaxed);
+        do
+        {
+            // A newer producer claimed the slot, or an older one still writes it
+            if (stamp >= writing(ticket) || (stamp & 1) != 0)
+            {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        } while (!slot.stamp.compare_exchange_weak(stamp, writing(ticket), std::memory_order_relaxed));
+        std::atomic_thread_fence(std::memory_order_release);
+
+        std::uint64_t words[wordCount]{};
+        std::memcpy(words, &element, sizeof(T));
+        for (size_type i = 0; i < wordCount; ++i)
+        {
+            slot.words[i].store(words[i], std::memory_order_relaxed);
+        }
+        slot.stamp.store(published(ticket), std::memory_order_release);
+    }
+
+    // Number of elements pushed so far
+    [[nodiscard]] std::uint64_t pushed() const noexcept
+    {
+        return head_.load(std::memory_order_relaxed);
+    }
+
+    // Number of elements producers dropped, see above
+    [[nodiscard]] std::uint64_t dropped() const noexcept
+    {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] constexpr size_type capacity() const noexcept
+    {
+        return N;
+    }
+
+  private:
+    static constexpr std::size_t cacheLineSize = 64;
+    static constexpr size_type wordCount = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+    // Each slot on a cache line of its own, so producers of adjacent tickets
+    // do not contend for the same line
+    struct alignas(cacheLineSize) Slot
+    {
+        std::atomic<std::uint64_t> stamp{};
+        std::atomic<std::uint64_t> words[wordCount]{};
+    };
+
+    static constexpr std::uint64_t writing(std::uint64_t ticket) noexcept
+    {
+        return 2 * ticket + 1;
+    }
+
+    static constexpr std::uint64_t published(std::uint64_t ticket) noexcept
+    {
+        return 2 * ticket + 2;
+    }
+
+    alignas(cacheLineSize) std::atomic<std::uint64_t> head_{}; // The next ticket
+    alignas(cacheLineSize) std::atomic<std::uint64_t> dropped_{};
+    Slot slots_[N];
+};
+
+// Reads the elements of an OverwriteRing in the order of their tickets. A
+// Reader is used by one thread at a time.
+template<typename T, std::size_t N>
+class OverwriteRing<T, N>::Reader
+{
+  public:
+    // Starts at the oldest element still in ring
+    explicit Reader(OverwriteRing const& ring) noexcept
+        : ring_{&ring}
+    {
+        auto const head = ring.head_.load(std::memory_order_acquire);
+        next_ = head > N ? head - N : 0;
+    }
+
+    Reader(Reader&&) = delete;
+    Reader(Reader const&) = delete;
+    Reader& operator=(Reader&&) = delete;
+    Reader& operator=(Reader const&) = delete;
+
+    // Copies the next element into element, skipping the ones overwritten.
+    // Returns false if there is none or it is not published yet.
+    bool try_read(T& element) noexcept
+    {
+        for (;;)
+        {
+            auto const head = ring_->head_.load(std::memory_order_acquire);
+            if (next_ == head)
+            {
+                return false;
+            }
+            if (head - next_ > N)
+            {
+                lost_ += head - N - next_;
+                next_ = head - N;
+            }
+
+            auto const& slot = ring_->slots_[next_ & (N - 1)];
+            auto const expected = published(next_);
+            auto const stamp = slot.stamp.load(std::memory_order_acquire);
+            if (stamp < expected)
+            {
+                return false;
+            }
+            if (stamp == expected)
+            {
+                std::uint64_t words[wordCount];
+                for (size_type i = 0; i < wordCount; ++i)
+                {
+                    words[i] = slot.words[i].load(std::memory_order_relaxed);
+                }
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.stamp.load(std::memory_order_relaxed) == expected)
+                {
+                    std::memcpy(&element, words, sizeof(T));
+                    ++next_;
+                    return true;
+                }
+            }
+            // Overwritten before or while copying
+            ++lost_;
+            ++next_;
+        }
+    }
+
+    // Calls fn for each element available, returns their number
+    template<typename Fn>
+    size_type drain(Fn&& fn) noexcept(std::is_nothrow_invocable_v<Fn, T const&>)
+    {
+        size_type result = 0;
+        T element;
+        for (; try_read(element); ++result)
+        {
+            fn(static_cast<T const&>(element));
+        }
+        return result;
+    }
+
+    // Number of elements skipped because they were overwritten
+    [[nodiscard]] std::uint64_t lost() const noexcept
+    {
+        return lost_;
+    }
+
+    // The ticket of the next element to read
+    [[nodiscard]] std::uint64_t position() const noexcept
+    {
+        return next_;
+    }
+
+  private:
+    OverwriteRing const* ring_;
+    std::uint64_t next_;
+    std::uint64_t lost_{};
+};
+
+OW_END_NAMESPACE
+
+#endif // OW_OVERWRITE_RING_HPP_INCLUDED
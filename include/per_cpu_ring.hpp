@@ -0,0 +1,351 @@
+//
+// Ring buffers per CPU, appended to with restartable sequences
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#ifndef PC_PER_CPU_RING_HPP_INCLUDED
+#define PC_PER_CPU_RING_HPP_INCLUDED
+
+// Configure namespace preference for PerCpuRing.
+// By default namespace utl is used.
+#define PC_NAMESPACE_NAME utl
+
+// clang-format off
+#ifndef PC_BEGIN_NAMESPACE
+#define PC_BEGIN_NAMESPACE namespace PC_NAMESPACE_NAME {
+#endif // PC_BEGIN_NAMESPAC
+#ifndef PC_END_NAMESPACE
+#define PC_END_NAMESPACE }
+#endif // PC_END_NAMESPACE
+// clang-format on
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <type_traits>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+// Restartable sequences need glibc 2.35 or later, which registers them for
+// every thread, and an x86-64 processor, for which push() is written in
+// assembly
+#if defined(__linux__) && defined(__x86_64__) && defined(__GNUC__) && __has_include(<sys/rseq.h>)
+#include <sys/rseq.h>
+#if defined(RSEQ_SIG)
+#define PC_HAS_RSEQ 1
+#endif
+#endif
+
+PC_BEGIN_NAMESPACE
+
+namespace detail
+{
+#ifdef PC_HAS_RSEQ
+    // The rseq area glibc registered for the calling thread, nullptr if none
+    inline struct rseq* rseqArea() noexcept
+    {
+        if (__rseq_size == 0)
+        {
+            return nullptr;
+        }
+        return reinterpret_cast<struct rseq*>(static_cast<char*>(__builtin_thread_pointer()) + __rseq_offset);
+    }
+#endif // PC_HAS_RSEQ
+
+    // Number of CPUs the rings are indexed by
+    inline std::size_t cpuCount() noexcept
+    {
+#if defined(__linux__)
+        if (auto const count = ::sysconf(_SC_NPROCESSORS_CONF); count > 0)
+        {
+            return static_cast<std::size_t>(count);
+        }
+#endif
+        return std::max<std::size_t>(1, std::thread::hardware_concurrency());
+    }
+
+    // The CPU the calling thread runs on, or a stand-in which is stable per thread
+    inline std::size_t currentCpu() noexcept
+    {
+#if defined(__linux__)
+        if (auto const cpu = ::sched_getcpu(); cpu >= 0)
+        {
+            return static_cast<std::size_t>(cpu);
+        }
+#endif
+        return std::hash<std::thread::id>{}(std::this_thread::get_id());
+    }
+} // namespace detail
+
+// One ring of N elements per CPU, for many threads producing into rings
+// without sharing them:
+//
+//   PerCpuRing<Sample, 1024> samples;
+//   samples.push(sample);                                  // Any thread
+//   samples.drain([](Sample const& sample) { ... });      // The collector
+//
+// Per-thread rings cost memory for every thread, a single ring makes all
+// threads contend for its tail. Here the threads running on a CPU share its
+// ring, whose tail only one of them can update at a time. push() appends in a
+// restartable sequence (rseq): it reads the current CPU from the area the
+// kernel keeps up to date for each thread, copies the element into that CPU's
+// ring and commits it with a single store to the tail. If the thread is
+// preempted, migrated or interrupted by a signal before that store, the
+// kernel restarts the sequence, so it needs no atomic instruction at all.
+//
+// Where rseq is unavailable (other platforms, glibc before 2.35, disabled by
+// the glibc.pthread.rseq tunable) or not requested, push() selects the ring by
+// sched_getcpu() and reserves a slot by a compare-and-swap of the tail. The
+// slot is published by a sequence stamp instead, so a producer preempted
+// while writing holds up the collector at its slot but no other producer.
+//
+// The rings use the layout of RingBuffer<T, N>: a storage of N slots and
+// counters for the head and tail, the collector being their single consumer.
+// A full ring rejects elements, counted by dropped(), as does a thread
+// without an rseq registration of its own. T must be trivially copyable and
+// N a power of two.
+template<typename T, std::size_t N>
+class PerCpuRing
+{
+  public:
+    static_assert(std::is_trivially_copyable_v<T>, "Template argument T must be trivially copyable");
+    static_assert(std::has_single_bit(N) && N <= (std::size_t{1} << 30), "Template argument N must be a power of two up to 2^30");
+
+    using value_type = T;
+    using size_type = std::size_t;
+
+    // Uses rseq if requested and available
+    explicit PerCpuRing(bool useRseq = true)
+        : count_{detail::cpuCount()}
+        , cpus_{new Cpu[count_]}
+    {
+#ifdef PC_HAS_RSEQ
+        rseq_ = useRseq && detail::rseqArea() != nullptr;
+#else
+        static_cast<void>(useRseq);
+#endif
+    }
+
+    PerCpuRing(PerCpuRing&&) = delete;
+    PerCpuRing(PerCpuRing const&) = delete;
+    PerCpuRing& operator=(PerCpuRing&&) = delete;
+    PerCpuRing& operator=(PerCpuRing const&) = delete;
+
+    // Appends element to the ring of the current CPU, false if it is full
+    bool push(T const& element) noexcept
+    {
+        std::uint64_t words[wordCount]{};
+        std::memcpy(words, &element, sizeof(T));
+#ifdef PC_HAS_RSEQ
+        if (rseq_)
+        {
+            if (pushRseq(words))
+            {
+                return true;
+            }
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+#endif
+        auto& cpu = cpus_[detail::currentCpu() % count_];
+        auto tail = cpu.tail.load(std::memory_order_relaxed);
+        do
+        {
+            if (tail - cpu.head.load(std::memory_order_acquire) >= N)
+            {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        } while (!cpu.tail.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed));
+        auto& slot = cpu.slots[tail & (N - 1)];
+        std::memcpy(slot.words, words, sizeof words);
+        slot.stamp.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Calls fn for the elements of every CPU, each CPU's in the order they
+    // were pushed, and removes them. Returns their number. Only one thread at
+    // a time may drain.
+    template<typename Fn>
+    size_type drain(Fn&& fn) noexcept(std::is_nothrow_invocable_v<Fn, T const&>)
+    {
+        size_type result = 0;
+        for (size_type i = 0; i < count_; ++i)
+        {
+            auto& cpu = cpus_[i];
+            auto head = cpu.head.load(std::memory_order_relaxed);
+            auto const tail = cpu.tail.load(std::memory_order_acquire);
+            for (; head != tail; ++head, ++result)
+            {
+                // Without rseq the tail counts reserved slots, the stamp tells
+                // whether the element has been written
+                auto const& slot = cpu.slots[head & (N - 1)];
+                if (!rseq_ && slot.stamp.load(std::memory_order_acquire) != head + 1)
+                {
+                    break;
+                }
+                T element;
+                std::memcpy(&element, slot.words, sizeof(T));
+                fn(static_cast<T const&>(element));
+                cpu.head.store(head + 1, std::memory_order_release);
+            }
+        }
+        return result;
+    }
+
+    // Number of elements pushed, or being pushed, but not drained yet
+    [[nodiscard]] size_type size() const noexcept
+    {
+        size_type result = 0;
+        for (size_type i = 0; i < count_; ++i)
+        {
+            result += cpus_[i].tail.load(std::memory_order_acquire) - cpus_[i].head.load(std::memory_order_relaxed);
+        }
+        return result;
+    }
+
+    // Number of elements rejected, see above
+    [[nodiscard]] std::uint64_t dropped() const noexcept
+    {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] bool uses_rseq() const noexcept
+    {
+        return rseq_;
+    }
+
+    [[nodiscard]] size_type cpu_count() const noexcept
+    {
+        return count_;
+    }
+
+    [[nodiscard]] constexpr size_type capacity() const noexcept
+    {
+        return N;
+    }
+
+  private:
+    static constexpr std::size_t cacheLineSize = 64;
+    static constexpr size_type wordCount = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+    struct Slot
+    {
+        std::atomic<std::uint64_t> stamp; // Ticket + 1 once written, used without rseq
+        std::uint64_t words[wordCount];
+    };
+
+    // The tail is written by the producers, the head by the collector, so
+    // they are on different cache lines
+    struct alignas(cacheLineSize) Cpu
+    {
+        std::atomic<std::uint64_t> tail{};
+        alignas(cacheLineSize) std::atomic<std::uint64_t> head{};
+        alignas(cacheLineSize) Slot slots[N]{};
+    };
+
+    size_type count_;
+    std::unique_ptr<Cpu[]> cpus_;
+    bool rseq_{};
+    alignas(cacheLineSize) std::atomic<std::uint64_t> dropped_{};
+
+#ifdef PC_HAS_RSEQ
+    // The critical section runs from label 1 up to the commit at label 2.
+    // Its descriptor (3) is stored in the thread's rseq area first, so that
+    // the kernel moves a preempted, migrated or signaled thread to the abort
+    // handler (4), which starts over. The handler must be preceded by
+    // RSEQ_SIG, encoded as part of an undefined instruction. Returns false
+    // if the ring is full or the CPU has none.
+    bool pushRseq(std::uint64_t const* words) noexcept
+    {
+        static_assert(std::is_standard_layout_v<Cpu>);
+        static_assert(sizeof(Cpu) < (std::size_t{1} << 31), "A ring must be addressable by a 32 bit offset");
+        int pushed;
+        // clang-format off
+        __asm__ __volatile__(
+            ".pushsection __rseq_cs, \"aw\"\n\t"
+            ".balign 32\n\t"
+            "3:\n\t"
+            ".long 0, 0\n\t"
+            ".quad 1f, 2f - 1f, 4f\n\t"
+            ".popsection\n\t"
+            "6:\n\t"
+            "leaq 3b(%%rip), %%rax\n\t"
+            "movq %%rax, %c[csOffset](%[area])\n\t"
+            "1:\n\t"
+            "movl %c[cpuOffset](%[area]), %%eax\n\t"
+            "cmpq %[count], %%rax\n\t"
+            "jae 7f\n\t"
+            "imulq $%c[stride], %%rax, %%rax\n\t"
+            "addq %[cpus], %%rax\n\t"
+            "movq %c[tailOffset](%%rax), %%rcx\n\t"
+            "movq %%rcx, %%rdx\n\t"
+            "subq %c[headOffset](%%rax), %%rdx\n\t"
+            "cmpq $%c[capacity], %%rdx\n\t"
+            "jae 8f\n\t"
+            "movq %%rcx, %%rdx\n\t"
+            "andq $%c[mask], %%rdx\n\t"
+            "imulq $%c[slotSize], %%rdx, %%rdx\n\t"
+            "leaq %c[wordsOffset](%%rax, %%rdx), %%rdi\n\t"
+            "xorl %%edx, %%edx\n\t"
+            "5:\n\t"
+            "movq (%[words], %%rdx, 8), %%r8\n\t"
+            "movq %%r8, (%%rdi, %%rdx, 8)\n\t"
+            "incq %%rdx\n\t"
+            "cmpq $%c[wordCount], %%rdx\n\t"
+            "jb 5b\n\t"
+            "incq %%rcx\n\t"
+            "movq %%rcx, %c[tailOffset](%%rax)\n\t"
+            "2:\n\t"
+            "movl $1, %[pushed]\n\t"
+            "jmp 9f\n\t"
+            "7:\n\t"
+            "8:\n\t"
+            "xorl %[pushed], %[pushed]\n\t"
+            "jmp 9f\n\t"
+            ".pushsection __rseq_failure, \"ax\"\n\t"
+            ".byte 0x0f, 0xb9, 0x3d\n\t"
+            ".long %c[signature]\n\t"
+            "4:\n\t"
+            "jmp 6b\n\t"
+            ".popsection\n\t"
+            "9:\n\t"
+            : [pushed] "=&r"(pushed)
+            : [area] "r"(detail::rseqArea()),
+              [cpus] "r"(cpus_.get()),
+              [count] "r"(static_cast<std::uint64_t>(count_)),
+              [words] "r"(words),
+              [csOffset] "i"(offsetof(struct rseq, rseq_cs)),
+              [cpuOffset] "i"(offsetof(struct rseq, cpu_id)),
+              [stride] "i"(sizeof(Cpu)),
+              [tailOffset] "i"(offsetof(Cpu, tail)),
+              [headOffset] "i"(offsetof(Cpu, head)),
+              [wordsOffset] "i"(offsetof(Cpu, slots) + offsetof(Slot, words)),
+              [capacity] "i"(N),
+              [mask] "i"(N - 1),
+              [slotSize] "i"(sizeof(Slot)),
+              [wordCount] "i"(wordCount),
+              [signature] "i"(RSEQ_SIG)
+            : "rax", "rcx", "rdx", "rdi", "r8", "memory", "cc");
+        // clang-format on
+        return pushed != 0;
+    }
+#endif // PC_HAS_RSEQ
+};
+
+PC_END_NAMESPACE
+
+#endif // PC_PER_CPU_RING_HPP_INCLUDED
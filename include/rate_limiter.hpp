@@ -0,0 +1,231 @@
+//
+// Sliding window and token bucket rate limiters
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#ifndef RL_RATE_LIMITER_HPP_INCLUDED
+#define RL_RATE_LIMITER_HPP_INCLUDED
+
+// Configure namespace preference for the rate limiters.
+// By default namespace utl is used.
+#define RL_NAMESPACE_NAME utl
+
+// clang-format off
+#ifndef RL_BEGIN_NAMESPACE
+#define RL_BEGIN_NAMESPACE namespace RL_NAMESPACE_NAME {
+#endif // RL_BEGIN_NAMESPAC
+#ifndef RL_END_NAMESPACE
+#define RL_END_NAMESPACE }
+#endif // RL_END_NAMESPACE
+// clang-format on
+
+#include "ring_buffer.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+RL_BEGIN_NAMESPACE
+
+// Exact limit of at most N events within any window of window ticks, e.g.
+// 500 messages per rolling second:
+//
+//   SlidingWindowRateLimiter<500> limiter{ticksPerSecond};
+//   if (limiter.try_acquire(now))
+//       send(message);
+//
+// The times of the granted events are kept in a RingBuffer, oldest first. An
+// event granted at time t counts until now - window reaches t, then it is
+// popped from the front, so try_acquire() is O(1) amortized and the limiter
+// never allocates. Time must not go backwards, an earlier time than that of
+// the newest event is treated as that time.
+template<std::size_t N>
+class SlidingWindowRateLimiter
+{
+  public:
+    using size_type = std::size_t;
+    using time_type = std::uint64_t;
+    using ring_buffer_type = ::RB_NAMESPACE_NAME::RingBuffer<time_type, N>;
+
+    explicit SlidingWindowRateLimiter(time_type window) noexcept
+        : window_{window}
+    {
+    }
+
+    SlidingWindowRateLimiter(SlidingWindowRateLimiter&&) = delete;
+    SlidingWindowRateLimiter(SlidingWindowRateLimiter const&) = delete;
+    SlidingWindowRateLimiter& operator=(SlidingWindowRateLimiter&&) = delete;
+    SlidingWindowRateLimiter& operator=(SlidingWindowRateLimiter const&) = delete;
+
+    // Grants count events at time now if the window has room for all of them
+    bool try_acquire(time_type now, size_type count = 1) noexcept
+    {
+        now = expire(now);
+        if (count > N - times_.size())
+        {
+            return false;
+        }
+        while (count-- != 0)
+        {
+            times_.push(now);
+        }
+        return true;
+    }
+
+    // The earliest time at which count events (at most N) can be granted
+    [[nodiscard]] time_type next_available(time_type now, size_type count = 1) noexcept
+    {
+        now = expire(now);
+        count = std::min(count, N);
+        auto const free = N - times_.size();
+        if (count <= free)
+        {
+            return now;
+        }
+        // The event which has to leave the window last
+        return times_[count - free - 1] + window_;
+    }
+
+    // Number of events granted within the window ending at now
+    [[nodiscard]] size_type size(time_type now) noexcept
+    {
+        expire(now);
+        return times_.size();
+    }
+
+    void clear() noexcept
+    {
+        times_.clear();
+    }
+
+    // The times of the events granted, oldest first, including the ones not
+    // evicted yet although their window has passed
+    [[nodiscard]] ring_buffer_type const& times() const noexcept
+    {
+        return times_;
+    }
+
+    [[nodiscard]] time_type window() const noexcept
+    {
+        return window_;
+    }
+
+    [[nodiscard]] size_type capacity() const noexcept
+    {
+        return N;
+    }
+
+  private:
+    ring_buffer_type times_;
+    time_type window_;
+
+    // Evicts the events which have left the window, returns now clamped to
+    // the time of the newest event
+    time_type expire(time_type now) noexcept
+    {
+        if (times_.empty())
+        {
+            return now;
+        }
+        now = std::max(now, times_.back());
+        while (!times_.empty() && now - times_.front() >= window_)
+        {
+            times_.pop();
+        }
+        return now;
+    }
+};
+
+// Token bucket holding at most burst tokens and refilled with one token every
+// interval ticks, for limits shared between threads:
+//
+//   TokenBucket bucket{ticksPerSecond / 500, 500};
+//   if (bucket.try_acquire(now))
+//       send(message);
+//
+// The bucket is a single atomic: the theoretical arrival time (TAT) of the
+// generic cell rate algorithm, i.e. the time at which the bucket would be full
+// again. A token is granted if advancing the TAT by interval keeps it within
+// burst * interval of now, which one compare-and-swap publishes. Unlike
+// SlidingWindowRateLimiter it needs no storage for past events, at the price
+// of spreading the limit evenly instead of counting events exactly.
+class TokenBucket
+{
+  public:
+    using time_type = std::uint64_t;
+
+    // The bucket starts full
+    TokenBucket(time_type interval, std::uint64_t burst) noexcept
+        : interval_{interval}
+        , limit_{interval * burst}
+    {
+    }
+
+    TokenBucket(TokenBucket&&) = delete;
+    TokenBucket(TokenBucket const&) = delete;
+    TokenBucket& operator=(TokenBucket&&) = delete;
+    TokenBucket& operator=(TokenBucket const&) = delete;
+
+    // Takes count tokens at time now if the bucket holds that many
+    bool try_acquire(time_type now, std::uint64_t count = 1) noexcept
+    {
+        auto tat = tat_.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            auto const next = std::max(tat, now) + count * interval_;
+            if (next - now > limit_)
+            {
+                return false;
+            }
+            if (tat_.compare_exchange_weak(tat, next, std::memory_order_relaxed))
+            {
+                return true;
+            }
+        }
+    }
+
+    // Number of tokens in the bucket at time now
+    [[nodiscard]] std::uint64_t available(time_type now) const noexcept
+    {
+        auto const tat = tat_.load(std::memory_order_relaxed);
+        return interval_ == 0 ? ~std::uint64_t{} : (limit_ - (std::max(tat, now) - now)) / interval_;
+    }
+
+    // The earliest time at which count tokens (at most burst) are available
+    [[nodiscard]] time_type next_available(time_type now, std::uint64_t count = 1) const noexcept
+    {
+        auto const next = std::max(tat_.load(std::memory_order_relaxed), now) + count * interval_;
+        return next - now <= limit_ ? now : next - limit_;
+    }
+
+    // Refills the bucket
+    void reset() noexcept
+    {
+        tat_.store(0, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] time_type interval() const noexcept
+    {
+        return interval_;
+    }
+
+    [[nodiscard]] std::uint64_t burst() const noexcept
+    {
+        return interval_ == 0 ? ~std::uint64_t{} : limit_ / interval_;
+    }
+
+  private:
+    static constexpr std::size_t cacheLineSize = 64;
+
+    alignas(cacheLineSize) std::atomic<time_type> tat_{};
+    time_type interval_;
+    time_type limit_; // burst * interval
+};
+
+RL_END_NAMESPACE
+
+#endif // RL_RATE_LIMITER_HPP_INCLUDED
@@ -0,0 +1,405 @@
+//
+// Ring buffer of variable length records
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#ifndef RR_RECORD_RING_HPP_INCLUDED
+#define RR_RECORD_RING_HPP_INCLUDED
+
+// Configure namespace preference for RecordRing.
+// By default namespace utl is used.
+#define RR_NAMESPACE_NAME utl
+
+// clang-format off
+#ifndef RR_BEGIN_NAMESPACE
+#define RR_BEGIN_NAMESPACE namespace RR_NAMESPACE_NAME {
+#endif // RR_BEGIN_NAMESPAC
+#ifndef RR_END_NAMESPACE
+#define RR_END_NAMESPACE }
+#endif // RR_END_NAMESPACE
+// clang-format on
+
+#include "unique_buffer.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <span>
+
+RR_BEGIN_NAMESPACE
+
+// A record as seen by the consumer. The payload refers directly into the ring's storage.
+struct RecordView
+{
+    std::uint32_t type;
+    std::span<std::byte const> payload;
+
+    template<typename T, typename = std::enable_if_t<std::is_trivial_v<T> && std::is_standard_layout_v<T>>>
+    [[nodiscard]] T const* as() const noexcept
+    {
+        return std::bit_cast<T const*>(payload.data());
+    }
+};
+
+namespace detail
+{
+    // Position counter shared between producer and consumer
+    template<bool Shared>
+    class RecordRingIndex
+    {
+      public:
+        std::uint64_t load(std::memory_order order) const noexcept
+        {
+            return value_.load(order);
+        }
+
+        void store(std::uint64_t value, std::memory_order order) noexcept
+        {
+            value_.store(value, order);
+        }
+
+      private:
+        std::atomic<std::uint64_t> value_{};
+    };
+
+    // Position counter of a single threaded ring
+    template<>
+    class RecordRingIndex<false>
+    {
+      public:
+        std::uint64_t load(std::memory_order) const noexcept
+        {
+            return value_;
+        }
+
+        void store(std::uint64_t value, std::memory_order) noexcept
+        {
+            value_ = value;
+        }
+
+      private:
+        std::uint64_t value_{};
+    };
+} // namespace detail
+
+// Byte oriented ring buffer holding records of variable length. Each record is
+// an 8 byte header (payload length and a type tag) followed by the payload and
+// padding up to the next multiple of 8 bytes, hence every payload is 8 byte
+// aligned. A record which would wrap around the end of the storage is preceded
+// by a skip record covering the rest of the storage, so every payload is
+// contiguous and can be read in place.
+//
+// Producers reserve space, write the payload and commit:
+//
+//   if (auto payload = ring.reserve(sizeof(Order)); !payload.empty())
+//   {
+//       std::construct_at(reinterpret_cast<Order*>(payload.data()), ...);
+//       ring.commit(orderType);
+//   }
+//
+// Consumers access the oldest record with front()/pop() or a batch of records
+// with consume(), which releases their space in one step:
+//
+//   ring.consume([](RecordView record) { handle(record.type, record.payload); });
+//
+// BasicRecordRing<false> (RecordRing) is for single threaded use.
+// BasicRecordRing<true> (SpscRecordRing) is safe to use from one producer
+// thread and one consumer thread concurrently.
+template<bool Shared>
+class BasicRecordRing
+{
+  public:
+    static constexpr std::size_t alignment = 8;
+    static constexpr std::size_t headerSize = 8;
+    static constexpr std::uint32_t skipType = std::numeric_limits<std::uint32_t>::max();
+
+    class const_iterator
+    {
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = RecordView;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = RecordView;
+
+        const_iterator() noexcept = default;
+
+        const_iterator(BasicRecordRing const* ring, std::uint64_t position) noexcept
+            : ring_{ring}
+            , position_{position}
+        {
+            skipPadding();
+        }
+
+        [[nodiscard]] RecordView operator*() const noexcept
+        {
+            return ring_->recordAt(position_);
+        }
+
+        const_iterator& operator++() noexcept
+        {
+            position_ += recordSize(ring_->headerAt(position_).length);
+            skipPadding();
+            return *this;
+        }
+
+        const_iterator operator++(int) noexcept
+        {
+            auto temp{*this};
+            ++*this;
+            return temp;
+        }
+
+        [[nodiscard]] bool operator==(const_iterator const& rhs) const noexcept
+        {
+            return position_ == rhs.position_;
+        }
+
+        [[nodiscard]] bool operator!=(const_iterator const& rhs) const noexcept
+        {
+            return !(*this == rhs);
+        }
+
+      private:
+        BasicRecordRing const* ring_{};
+        std::uint64_t position_{};
+
+        void skipPadding() noexcept
+        {
+            if (position_ != ring_->tail_.load(std::memory_order_acquire))
+            {
+                position_ = ring_->skipPadding(position_);
+            }
+        }
+    };
+
+    BasicRecordRing(BasicRecordRing&&) = delete;
+    BasicRecordRing(BasicRecordRing const&) = delete;
+    BasicRecordRing& operator=(BasicRecordRing&&) = delete;
+    BasicRecordRing& operator=(BasicRecordRing const&) = delete;
+
+    // The capacity in bytes is rounded up to the next power of two
+    explicit BasicRecordRing(
+        std::size_t capacity,
+        std::pmr::memory_resource* memres = std::pmr::get_default_resource())
+        : buffer_{std::bit_ceil(std::max(capacity, 2 * headerSize)), memres, cacheLineSize}
+        , mask_{buffer_.size() - 1}
+    {
+    }
+
+    // Producer: returns space for a payload of length bytes or an empty span if
+    // the ring is too full or length exceeds maxPayload(). The reservation becomes visible with commit().
+    [[nodiscard]] std::span<std::byte> reserve(std::size_t length) noexcept
+    {
+        if (length > maxPayload())
+        {
+            return {};
+        }
+        auto const size = recordSize(length);
+        auto tail = tail_.load(std::memory_order_relaxed);
+        if constexpr (!Shared)
+        {
+            // An empty ring starts over at offset 0, so any record up to the capacity fits
+            if (tail == head_.load(std::memory_order_relaxed) && tail != 0)
+            {
+                tail = 0;
+                head_.store(0, std::memory_order_relaxed);
+                tail_.store(0, std::memory_order_relaxed);
+                cachedHead_ = 0;
+            }
+        }
+        auto const offset = tail & mask_;
+        auto const padding = capacity() - offset < size ? capacity() - offset : 0;
+        auto const end = tail + padding + size;
+        if (end - cachedHead_ > capacity())
+        {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            if (end - cachedHead_ > capacity())
+            {
+                return {};
+            }
+        }
+        if (padding != 0)
+        {
+            writeHeader(tail, static_cast<std::uint32_t>(padding - headerSize), skipType);
+        }
+        reserved_ = tail + padding;
+        reservedLength_ = length;
+        return {payloadAt(reserved_), length};
+    }
+
+    // Producer: publishes the last reservation as a record of the given type
+    void commit(std::uint32_t type) noexcept
+    {
+        commit(type, reservedLength_);
+    }
+
+    // Producer: publishes the first length bytes of the last reservation
+    void commit(std::uint32_t type, std::size_t length) noexcept
+    {
+        writeHeader(reserved_, static_cast<std::uint32_t>(length), type);
+        tail_.store(reserved_ + recordSize(length), std::memory_order_release);
+    }
+
+    // Producer: copies payload into a new record. Returns false if the ring is too full.
+    bool push(std::uint32_t type, std::span<std::byte const> payload) noexcept
+    {
+        auto space = reserve(payload.size());
+        if (space.data() == nullptr)
+        {
+            return false;
+        }
+        std::memcpy(space.data(), payload.data(), payload.size());
+        commit(type);
+        return true;
+    }
+
+    // Consumer: the oldest record, the ring must not be empty
+    [[nodiscard]] RecordView front() const noexcept
+    {
+        return recordAt(skipPadding(head_.load(std::memory_order_relaxed)));
+    }
+
+    // Consumer: removes the oldest record, the ring must not be empty
+    void pop() noexcept
+    {
+        auto const head = skipPadding(head_.load(std::memory_order_relaxed));
+        head_.store(head + recordSize(headerAt(head).length), std::memory_order_release);
+    }
+
+    // Consumer: calls fn(RecordView) for up to maxRecords of the oldest records
+    // and removes them afterwards. Returns the number of records consumed.
+    template<typename Fn>
+    std::size_t consume(Fn&& fn, std::size_t maxRecords = std::numeric_limits<std::size_t>::max())
+    {
+        auto head = head_.load(std::memory_order_relaxed);
+        auto const tail = tail_.load(std::memory_order_acquire);
+        std::size_t count = 0;
+        while (head != tail && count < maxRecords)
+        {
+            auto const header = headerAt(head);
+            if (header.type != skipType)
+            {
+                fn(recordAt(head));
+                ++count;
+            }
+            head += recordSize(header.length);
+        }
+        head_.store(head, std::memory_order_release);
+        return count;
+    }
+
+    // Consumer: iterates the records in place without removing them
+    [[nodiscard]] const_iterator begin() const noexcept
+    {
+        return const_iterator{this, head_.load(std::memory_order_relaxed)};
+    }
+
+    [[nodiscard]] const_iterator end() const noexcept
+    {
+        return const_iterator{this, tail_.load(std::memory_order_acquire)};
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return head_.load(std::memory_order_relaxed) == tail_.load(std::memory_order_acquire);
+    }
+
+    // Bytes occupied by records including headers and padding
+    [[nodiscard]] std::size_t bytes() const noexcept
+    {
+        return static_cast<std::size_t>(tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire));
+    }
+
+    [[nodiscard]] std::size_t capacity() const noexcept
+    {
+        return buffer_.size();
+    }
+
+    // Largest payload a record can have. A shared ring cannot rewind an empty
+    // ring to offset 0, so a record there may take at most half the capacity:
+    // larger records would not fit at the end nor in front of the skip record
+    // padding it.
+    [[nodiscard]] std::size_t maxPayload() const noexcept
+    {
+        auto const maxRecord = Shared ? capacity() / 2 : capacity();
+        return std::min<std::size_t>(maxRecord - headerSize, std::numeric_limits<std::uint32_t>::max());
+    }
+
+    // Space a record with a payload of length bytes occupies
+    [[nodiscard]] static constexpr std::size_t recordSize(std::size_t length) noexcept
+    {
+        return (headerSize + length + alignment - 1) & ~(alignment - 1);
+    }
+
+  private:
+    static constexpr std::size_t cacheLineSize = 64;
+
+    struct Header
+    {
+        std::uint32_t length;
+        std::uint32_t type;
+    };
+
+    ::UB_NAMESPACE_NAME::UniqueBuffer buffer_;
+    std::size_t mask_;
+
+    // Written by the consumer
+    alignas(cacheLineSize) detail::RecordRingIndex<Shared> head_;
+
+    // Written by the producer
+    alignas(cacheLineSize) detail::RecordRingIndex<Shared> tail_;
+    std::uint64_t cachedHead_{};
+    std::uint64_t reserved_{};
+    std::size_t reservedLength_{};
+
+    std::byte* storageAt(std::uint64_t position) const noexcept
+    {
+        return static_cast<std::byte*>(buffer_.get()) + (position & mask_);
+    }
+
+    Header headerAt(std::uint64_t position) const noexcept
+    {
+        Header header;
+        std::memcpy(&header, storageAt(position), sizeof(header));
+        return header;
+    }
+
+    void writeHeader(std::uint64_t position, std::uint32_t length, std::uint32_t type) noexcept
+    {
+        Header const header{length, type};
+        std::memcpy(storageAt(position), &header, sizeof(header));
+    }
+
+    std::byte* payloadAt(std::uint64_t position) const noexcept
+    {
+        return storageAt(position) + headerSize;
+    }
+
+    RecordView recordAt(std::uint64_t position) const noexcept
+    {
+        auto const header = headerAt(position);
+        return {header.type, {payloadAt(position), header.length}};
+    }
+
+    std::uint64_t skipPadding(std::uint64_t position) const noexcept
+    {
+        auto const header = headerAt(position);
+        return header.type == skipType ? position + recordSize(header.length) : position;
+    }
+};
+
+using RecordRing = BasicRecordRing<false>;
+using SpscRecordRing = BasicRecordRing<true>;
+
+RR_END_NAMESPACE
+
+#endif // RR_RECORD_RING_HPP_INCLUDED
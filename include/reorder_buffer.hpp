@@ -0,0 +1,283 @@
+//
+// Buffer releasing out of order arrivals in sequence
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#ifndef RO_REORDER_BUFFER_HPP_INCLUDED
+#define RO_REORDER_BUFFER_HPP_INCLUDED
+
+// Configure namespace preference for ReorderBuffer.
+// By default namespace utl is used.
+#define RO_NAMESPACE_NAME utl
+
+// clang-format off
+#ifndef RO_BEGIN_NAMESPACE
+#define RO_BEGIN_NAMESPACE namespace RO_NAMESPACE_NAME {
+#endif // RO_BEGIN_NAMESPAC
+#ifndef RO_END_NAMESPACE
+#define RO_END_NAMESPACE }
+#endif // RO_END_NAMESPACE
+// clang-format on
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+RO_BEGIN_NAMESPACE
+
+enum class ReorderStatus
+{
+    accepted,  // Buffered until the sequence numbers before it have been released
+    duplicate, // The sequence number is buffered already
+    late,      // The sequence number has been released or skipped already
+    ahead      // The sequence number is N or more ahead of the expected one
+};
+
+// Buffer for elements numbered by a sequence, which arrive out of order and
+// are released in order. Element seq is constructed in place in slot seq % N,
+// which a presence bit marks as occupied. drain() releases the contiguous run
+// of elements starting at the expected sequence number:
+//
+//   ReorderBuffer<Packet, 1024> packets;
+//   packets.push(packet.seq, packet);
+//   packets.drain(now, timeout, [](Packet&& p) { handle(p); },
+//                 [](std::uint64_t first, std::uint64_t last) { report(first, last); });
+//
+// While an element is missing, the ones after it wait. Given a timeout,
+// drain() gives up on a gap which has been open for that long: it reports
+// the missing sequence numbers [first, last) and releases the elements after
+// the gap. Only sequence numbers less than expected() + N can be buffered.
+template<typename T, std::size_t N>
+class ReorderBuffer
+{
+  public:
+    static_assert(N > 0, "Template argument N must not be zero");
+
+    using value_type = T;
+    using size_type = std::size_t;
+    using sequence_type = std::uint64_t;
+    using time_type = std::uint64_t;
+
+    // first is the sequence number expected first
+    explicit ReorderBuffer(sequence_type first = 0) noexcept
+        : expected_{first}
+    {
+    }
+
+    ReorderBuffer(ReorderBuffer&&) = delete;
+    ReorderBuffer(ReorderBuffer const&) = delete;
+    ReorderBuffer& operator=(ReorderBuffer&&) = delete;
+    ReorderBuffer& operator=(ReorderBuffer const&) = delete;
+
+    ~ReorderBuffer() noexcept
+    {
+        clear();
+    }
+
+    template<typename... Args>
+    ReorderStatus emplace(sequence_type seq, Args&&... args)
+    {
+        if (seq < expected_)
+        {
+            return ReorderStatus::late;
+        }
+        if (seq - expected_ >= N)
+        {
+            return ReorderStatus::ahead;
+        }
+        auto const slot = slotOf(seq);
+        if (present(slot))
+        {
+            return ReorderStatus::duplicate;
+        }
+        std::construct_at(static_cast<T*>(storageAt(slot)), std::forward<Args>(args)...);
+        present_[slot / 64] |= std::uint64_t{1} << (slot % 64);
+        ++size_;
+        return ReorderStatus::accepted;
+    }
+
+    ReorderStatus push(sequence_type seq, T const& element)
+    {
+        return emplace(seq, element);
+    }
+
+    ReorderStatus push(sequence_type seq, T&& element)
+    {
+        return emplace(seq, std::move(element));
+    }
+
+    // Passes the elements from the expected sequence number on to fn as long
+    // as there is no gap. Returns the number of elements released.
+    template<typename Fn>
+    size_type drain(Fn&& fn)
+    {
+        size_type released = 0;
+        for (auto slot = slotOf(expected_); present(slot); slot = slotOf(expected_))
+        {
+            release(slot, fn);
+            ++released;
+        }
+        if (released != 0)
+        {
+            gapSince_ = none;
+        }
+        return released;
+    }
+
+    // Like drain(fn), but a gap which has been open for timeout ticks at time
+    // now, counted from the first call which found it, is skipped: its
+    // sequence numbers [first, last) are reported to onGap and the elements
+    // after it are released.
+    template<typename Fn, typename GapFn>
+    size_type drain(time_type now, time_type timeout, Fn&& fn, GapFn&& onGap)
+    {
+        auto released = drain(fn);
+        while (size_ != 0)
+        {
+            if (gapSince_ == none)
+            {
+                gapSince_ = now;
+            }
+            if (now - gapSince_ < timeout)
+            {
+                break;
+            }
+            auto const first = expected_;
+            skip_to(nextPresent());
+            onGap(first, expected_);
+            released += drain(fn);
+        }
+        return released;
+    }
+
+    // Gives up on all sequence numbers before seq, the elements buffered for
+    // them are destroyed
+    void skip_to(sequence_type seq) noexcept
+    {
+        while (expected_ < seq && size_ != 0)
+        {
+            if (auto const slot = slotOf(expected_); present(slot))
+            {
+                destruct(slot);
+            }
+            ++expected_;
+        }
+        expected_ = std::max(expected_, seq);
+        gapSince_ = none;
+    }
+
+    void clear() noexcept
+    {
+        while (size_ != 0)
+        {
+            destruct(slotOf(nextPresent()));
+        }
+        gapSince_ = none;
+    }
+
+    [[nodiscard]] bool contains(sequence_type seq) const noexcept
+    {
+        return seq >= expected_ && seq - expected_ < N && present(slotOf(seq));
+    }
+
+    // The sequence number to be released next
+    [[nodiscard]] sequence_type expected() const noexcept
+    {
+        return expected_;
+    }
+
+    // Number of buffered elements
+    [[nodiscard]] size_type size() const noexcept
+    {
+        return size_;
+    }
+
+    [[nodiscard]] size_type capacity() const noexcept
+    {
+        return N;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+  private:
+    static constexpr time_type none = ~time_type{};
+
+    std::aligned_storage_t<sizeof(T), alignof(T)> storage_[N];
+    std::uint64_t present_[(N + 63) / 64]{};
+    sequence_type expected_;
+    size_type size_{};
+    time_type gapSince_{none}; // When the current gap was first seen by drain()
+
+    static size_type slotOf(sequence_type seq) noexcept
+    {
+        return static_cast<size_type>(seq % N);
+    }
+
+    bool present(size_type slot) const noexcept
+    {
+        return (present_[slot / 64] >> (slot % 64) & 1) != 0;
+    }
+
+    // Sequence number of the first buffered element, the buffer must not be empty
+    sequence_type nextPresent() const noexcept
+    {
+        auto seq = expected_;
+        auto slot = slotOf(seq);
+        for (;;)
+        {
+            // Skip the absent slots of the current word at once
+            auto const bits = present_[slot / 64] >> (slot % 64);
+            if (bits != 0)
+            {
+                auto const skip = static_cast<size_type>(std::countr_zero(bits));
+                if (slot + skip < N)
+                {
+                    return seq + skip;
+                }
+            }
+            auto const skip = std::min(64 - slot % 64, N - slot);
+            seq += skip;
+            slot = slot + skip == N ? 0 : slot + skip;
+        }
+    }
+
+    template<typename Fn>
+    void release(size_type slot, Fn& fn)
+    {
+        fn(std::move(*objectAt(slot)));
+        destruct(slot);
+        ++expected_;
+    }
+
+    void* storageAt(size_type slot) noexcept
+    {
+        return &storage_[slot];
+    }
+
+    T* objectAt(size_type slot) noexcept
+    {
+        return std::launder(static_cast<T*>(storageAt(slot)));
+    }
+
+    void destruct(size_type slot) noexcept
+    {
+        std::destroy_at(objectAt(slot));
+        present_[slot / 64] &= ~(std::uint64_t{1} << (slot % 64));
+        --size_;
+    }
+};
+
+RO_END_NAMESPACE
+
+#endif // RO_REORDER_BUFFER_HPP_INCLUDED
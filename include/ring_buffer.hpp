@@ -26,13 +26,276 @@
 #include <iterator>
 #include <utility>
 #include <memory>
+#include <algorithm>
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <limits>
+#include <bit>
+#include <vector>
+#include <span>
+
+#if __has_include(<sys/uio.h>)
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#define RB_HAS_VECTORED_IO 1
+#endif
 
 RB_BEGIN_NAMESPACE
 
-template<typename T, std::size_t N>
+// A policy observes the life cycle of the elements stored in a RingBuffer. It is a
+// class template parameterized with the number of storage slots (N + 1), which
+// allows it to keep per slot data parallel to the ring buffer's storage. The hooks
+// are called after the ring buffer has updated its state; size is the number of
+// elements in the ring buffer at that time.
+//
+//   pushed(slot, size)      A new element has been constructed in slot
+//   popped(slot, size)      The element in slot has been removed by pop() or clear()
+//   overwritten(slot, size) emplace() on a full ring buffer dropped the element in slot
+//
+// RingBufferNullPolicy is the default and compiles to nothing.
+template<std::size_t Slots>
+struct RingBufferNullPolicy
+{
+    constexpr void pushed(std::size_t, std::size_t) noexcept
+    {
+    }
+
+    constexpr void popped(std::size_t, std::size_t) noexcept
+    {
+    }
+
+    constexpr void overwritten(std::size_t, std::size_t) noexcept
+    {
+    }
+};
+
+// Policy numbering the elements of a RingBuffer with 64 bit sequence numbers,
+// which enables the sequenced mode of RingBuffer: the n-th element pushed,
+// counting from 0, keeps sequence number n until it is popped or overwritten,
+// and at_seq() and iterate_from() find it in O(1).
+//
+//   RingBuffer<Message, 4096, RingBufferSequence> journal;
+//   ...
+//   for (auto it = journal.iterate_from(resumeSeq); it != journal.end(); ++it) ...
+template<std::size_t Slots>
+class RingBufferSequence
+{
+  public:
+    void pushed(std::size_t, std::size_t) noexcept
+    {
+        ++head_;
+    }
+
+    void popped(std::size_t, std::size_t) noexcept
+    {
+        ++tail_;
+    }
+
+    void overwritten(std::size_t, std::size_t) noexcept
+    {
+        ++tail_;
+    }
+
+    // Sequence number of the next element pushed
+    [[nodiscard]] std::uint64_t head_seq() const noexcept
+    {
+        return head_;
+    }
+
+    // Sequence number of the front element, head_seq() if the ring buffer is empty
+    [[nodiscard]] std::uint64_t tail_seq() const noexcept
+    {
+        return tail_;
+    }
+
+    // Renumbers the elements so that the front element gets sequence number
+    // first, e.g. after the contents of a ring buffer have been restored
+    void renumber(std::uint64_t first) noexcept
+    {
+        head_ = first + (head_ - tail_);
+        tail_ = first;
+    }
+
+  private:
+    std::uint64_t head_{};
+    std::uint64_t tail_{};
+};
+
+#ifdef RB_HAS_VECTORED_IO
+// Leads the file written by RingBuffer::save_to(). The payload following it holds
+// the elements oldest first, either as raw bytes or, for elements saved through a
+// serializer, as records of an 8 byte length followed by the serialized bytes. All
+// fields are in native byte order, snapshots are not meant to move across hosts.
+struct RingBufferSnapshotHeader
+{
+    static constexpr std::uint64_t signature = 0x31474E4952425455; // "UTBRING1"
+
+    std::uint64_t magic;
+    std::uint64_t capacity;    // N of the ring buffer saved
+    std::uint64_t elementSize; // sizeof(T), 0 for serialized elements
+    std::uint64_t count;       // Number of elements
+    std::uint64_t payloadSize; // Number of bytes following the header
+    std::uint64_t checksum;    // Checksum of the payload
+};
+
+namespace detail
+{
+    // 64 bit checksum of a byte stream, computed in four independent lanes of 8
+    // bytes like xxHash64. Bytes not filling a stripe are carried over, so the
+    // result does not depend on how the stream is split into update() calls.
+    class SnapshotChecksum
+    {
+      public:
+        void update(void const* data, std::size_t size) noexcept
+        {
+            if (size == 0)
+            {
+                return;
+            }
+            auto bytes = static_cast<unsigned char const*>(data);
+            total_ += size;
+            if (buffered_ != 0)
+            {
+                auto const take = std::min(size, sizeof pending_ - buffered_);
+                std::memcpy(pending_ + buffered_, bytes, take);
+                buffered_ += take;
+                bytes += take;
+                size -= take;
+                if (buffered_ != sizeof pending_)
+                {
+                    return;
+                }
+                stripe(pending_);
+                buffered_ = 0;
+            }
+            for (; size >= sizeof pending_; bytes += sizeof pending_, size -= sizeof pending_)
+            {
+                stripe(bytes);
+            }
+            std::memcpy(pending_, bytes, size);
+            buffered_ = size;
+        }
+
+        [[nodiscard]] std::uint64_t value() const noexcept
+        {
+            auto hash = std::rotl(lanes_[0], 1) + std::rotl(lanes_[1], 7) + std::rotl(lanes_[2], 12) + std::rotl(lanes_[3], 18) + total_;
+            for (std::size_t i = 0; i < buffered_; ++i)
+            {
+                hash = std::rotl(hash ^ pending_[i] * prime5, 11) * prime1;
+            }
+            hash ^= hash >> 33;
+            hash *= prime2;
+            hash ^= hash >> 29;
+            hash *= prime3;
+            return hash ^ hash >> 32;
+        }
+
+      private:
+        static constexpr std::uint64_t prime1 = 0x9E3779B185EBCA87ull;
+        static constexpr std::uint64_t prime2 = 0xC2B2AE3D27D4EB4Full;
+        static constexpr std::uint64_t prime3 = 0x165667B19E3779F9ull;
+        static constexpr std::uint64_t prime5 = 0x27D4EB2F165667C5ull;
+
+        std::uint64_t lanes_[4]{prime1 + prime2, prime2, 0, 0 - prime1};
+        std::uint64_t total_{};
+        unsigned char pending_[32];
+        std::size_t buffered_{};
+
+        void stripe(unsigned char const* bytes) noexcept
+        {
+            for (std::size_t lane = 0; lane < 4; ++lane)
+            {
+                std::uint64_t word;
+                std::memcpy(&word, bytes + lane * 8, sizeof word);
+                lanes_[lane] = std::rotl(lanes_[lane] + word * prime2, 31) * prime1;
+            }
+        }
+    };
+
+    // Writes all of iov, continuing after partial writes and interrupts.
+    // Returns false with errno set on error.
+    inline bool writeFully(int fd, iovec* iov, int count) noexcept
+    {
+        while (count != 0)
+        {
+            auto const result = ::writev(fd, iov, count);
+            if (result < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                return false;
+            }
+            auto written = static_cast<std::size_t>(result);
+            for (; count != 0 && written >= iov->iov_len; ++iov, --count)
+            {
+                written -= iov->iov_len;
+            }
+            if (count != 0)
+            {
+                iov->iov_base = static_cast<char*>(iov->iov_base) + written;
+                iov->iov_len -= written;
+            }
+        }
+        return true;
+    }
+
+    // Reads exactly size bytes, continuing after partial reads and interrupts.
+    // Returns false with errno set on error, errno is EINVAL at end of file.
+    inline bool readFully(int fd, void* data, std::size_t size) noexcept
+    {
+        auto bytes = static_cast<char*>(data);
+        while (size != 0)
+        {
+            iovec iov{bytes, size};
+            auto const result = ::readv(fd, &iov, 1);
+            if (result < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                return false;
+            }
+            if (result == 0)
+            {
+                errno = EINVAL;
+                return false;
+            }
+            bytes += result;
+            size -= static_cast<std::size_t>(result);
+        }
+        return true;
+    }
+
+    // Bytes between the position of fd and the end of the file if fd refers to
+    // a regular file, otherwise the maximum as the size is unknown
+    inline std::uint64_t bytesLeft(int fd) noexcept
+    {
+        struct stat status;
+        if (::fstat(fd, &status) != 0 || !S_ISREG(status.st_mode))
+        {
+            return std::numeric_limits<std::uint64_t>::max();
+        }
+        auto const position = ::lseek(fd, 0, SEEK_CUR);
+        if (position < 0)
+        {
+            return std::numeric_limits<std::uint64_t>::max();
+        }
+        return position < status.st_size ? static_cast<std::uint64_t>(status.st_size - position) : 0;
+    }
+} // namespace detail
+#endif // RB_HAS_VECTORED_IO
+
+template<typename T, std::size_t N, template<std::size_t> class Policy = RingBufferNullPolicy>
 class RingBuffer;
 
-template<class T, std::size_t N>
+template<class T, std::size_t N, template<std::size_t> class Policy = RingBufferNullPolicy>
 class RingBufferConstIterator
 {
   public:
@@ -42,7 +305,7 @@ class RingBufferConstIterator
     using pointer = T const*;
     using reference = T const&;
 
-    constexpr explicit RingBufferConstIterator(RingBuffer<T, N> const* rb, std::size_t current = 0)
+    constexpr explicit RingBufferConstIterator(RingBuffer<T, N, Policy> const* rb, std::size_t current = 0)
         : rb_{rb}
         , current_{current}
     {
@@ -149,15 +412,15 @@ class RingBufferConstIterator
     }
 
   private:
-    RingBuffer<T, N> const* rb_;
+    RingBuffer<T, N, Policy> const* rb_;
     std::size_t current_;
 };
 
-template<class T, std::size_t N>
-class RingBufferIterator : public RingBufferConstIterator<T, N>
+template<class T, std::size_t N, template<std::size_t> class Policy = RingBufferNullPolicy>
+class RingBufferIterator : public RingBufferConstIterator<T, N, Policy>
 {
   public:
-    using BaseClass = RingBufferConstIterator<T, N>;
+    using BaseClass = RingBufferConstIterator<T, N, Policy>;
 
     using iterator_category = std::random_access_iterator_tag;
     using value_type = T;
@@ -165,7 +428,7 @@ class RingBufferIterator : public RingBufferConstIterator<T, N>
     using pointer = T*;
     using reference = T&;
 
-    constexpr explicit RingBufferIterator(RingBuffer<T, N>* rb, std::size_t current = 0)
+    constexpr explicit RingBufferIterator(RingBuffer<T, N, Policy>* rb, std::size_t current = 0)
         : BaseClass(rb, current)
     {
     }
@@ -238,7 +501,7 @@ class RingBufferIterator : public RingBufferConstIterator<T, N>
     }
 };
 
-template<typename T, std::size_t N>
+template<typename T, std::size_t N, template<std::size_t> class Policy>
 class RingBuffer
 {
   public:
@@ -251,11 +514,15 @@ class RingBuffer
     using const_reference = T const&;
     using size_type = std::size_t;
     using difference_type = std::ptrdiff_t;
-    using iterator = RingBufferIterator<T, N>;
+    using iterator = RingBufferIterator<T, N, Policy>;
     using reverse_iterator = std::reverse_iterator<iterator>;
-    using const_iterator = RingBufferConstIterator<T, N>;    
+    using const_iterator = RingBufferConstIterator<T, N, Policy>;
+    using policy_type = Policy<N + 1>;
     using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
+    // True if the policy numbers the elements, like RingBufferSequence does
+    static constexpr bool sequenced = requires(policy_type const& policy) { policy.tail_seq(); };
+
     RingBuffer() = default;
     RingBuffer(RingBuffer&&) = delete;
     RingBuffer(RingBuffer const&) = delete;
@@ -273,9 +540,12 @@ class RingBuffer
         auto element = std::construct_at(static_cast<T*>(storageAt(write_)), std::forward<Args>(args)...);
         if (full())
         {
-            destruct(increment(read_));
+            auto const slot = increment(read_);
+            destruct(slot);
+            policy_.overwritten(slot, size());
         }
-        increment(write_);
+        auto const slot = increment(write_);
+        policy_.pushed(slot, size());
         return *element;
     }
 
@@ -291,7 +561,26 @@ class RingBuffer
 
     void pop() noexcept
     {
-        destruct(increment(read_));
+        auto const slot = increment(read_);
+        destruct(slot);
+        policy_.popped(slot, size());
+    }
+
+    // Removes the count oldest elements, at most size()
+    void pop(size_type count) noexcept
+    {
+        count = std::min(count, size());
+        if constexpr (std::is_trivially_destructible_v<T>)
+        {
+            consumed(count);
+        }
+        else
+        {
+            while (count-- != 0)
+            {
+                pop();
+            }
+        }
     }
 
     void clear() noexcept
@@ -333,6 +622,33 @@ class RingBuffer
         return *objectAt(calculateIndex(read_ + index));
     }
 
+    // The element with sequence number seq, or nullptr if it has been removed
+    // already or has not been pushed yet
+    [[nodiscard]] pointer at_seq(std::uint64_t seq) noexcept requires sequenced
+    {
+        auto const offset = seq - policy_.tail_seq();
+        return offset < size() ? &(*this)[static_cast<size_type>(offset)] : nullptr;
+    }
+
+    [[nodiscard]] const_pointer at_seq(std::uint64_t seq) const noexcept requires sequenced
+    {
+        auto const offset = seq - policy_.tail_seq();
+        return offset < size() ? &(*this)[static_cast<size_type>(offset)] : nullptr;
+    }
+
+    // Iterator to the element with sequence number seq. Iteration starts at
+    // front() if that element has been removed already and at end() if it has
+    // not been pushed yet.
+    [[nodiscard]] iterator iterate_from(std::uint64_t seq) noexcept requires sequenced
+    {
+        return iterator{this, offsetOf(seq)};
+    }
+
+    [[nodiscard]] const_iterator iterate_from(std::uint64_t seq) const noexcept requires sequenced
+    {
+        return const_iterator{this, offsetOf(seq)};
+    }
+
     [[nodiscard]] iterator begin() noexcept
     {
         return iterator{this};
@@ -413,10 +729,238 @@ class RingBuffer
         return calculateIndex(write_ + 1) == read_;
     }
 
+    // The elements as up to two contiguous segments, oldest first. The second
+    // segment is empty unless the elements wrap around the end of the storage.
+    [[nodiscard]] std::span<T> array_one() noexcept
+    {
+        return {objectAt(read_), static_cast<size_type>(read_ <= write_ ? write_ - read_ : N + 1 - read_)};
+    }
+
+    [[nodiscard]] std::span<T const> array_one() const noexcept
+    {
+        return {objectAt(read_), static_cast<size_type>(read_ <= write_ ? write_ - read_ : N + 1 - read_)};
+    }
+
+    [[nodiscard]] std::span<T> array_two() noexcept
+    {
+        return {objectAt(0), static_cast<size_type>(read_ <= write_ ? 0 : write_)};
+    }
+
+    [[nodiscard]] std::span<T const> array_two() const noexcept
+    {
+        return {objectAt(0), static_cast<size_type>(read_ <= write_ ? 0 : write_)};
+    }
+
+#ifdef RB_HAS_VECTORED_IO
+    // Fills the free space of a byte ring buffer with at most max bytes read from
+    // fd by a single readv() over up to two iovecs. Only the bytes actually read
+    // are appended. Returns the result of readv(), i.e. -1 on error with errno set
+    // and 0 on end of file. Nothing is read and 0 is returned if the ring buffer is
+    // full or max is 0.
+    std::ptrdiff_t read_from(int fd, size_type max = N) noexcept requires(std::is_same_v<T, std::byte> || std::is_same_v<T, char>)
+    {
+        auto const count = std::min(max, N - size());
+        if (count == 0)
+        {
+            return 0;
+        }
+        auto const first = std::min(count, N + 1 - static_cast<size_type>(write_));
+        iovec iov[2]{{storageAt(write_), first}, {storageAt(0), count - first}};
+        auto const result = ::readv(fd, iov, count == first ? 1 : 2);
+        if (result > 0)
+        {
+            produced(static_cast<size_type>(result));
+        }
+        return result;
+    }
+
+    // Drains at most max bytes from the front of a byte ring buffer into fd by a
+    // single writev() over up to two iovecs. Only the bytes actually written are
+    // removed. Returns the result of writev(). Nothing is written and 0 is
+    // returned if the ring buffer is empty or max is 0.
+    std::ptrdiff_t write_to(int fd, size_type max = N) noexcept requires(std::is_same_v<T, std::byte> || std::is_same_v<T, char>)
+    {
+        auto const count = std::min(max, size());
+        if (count == 0)
+        {
+            return 0;
+        }
+        auto const first = std::min(count, N + 1 - static_cast<size_type>(read_));
+        iovec iov[2]{{storageAt(read_), first}, {storageAt(0), count - first}};
+        auto const result = ::writev(fd, iov, count == first ? 1 : 2);
+        if (result > 0)
+        {
+            consumed(static_cast<size_type>(result));
+        }
+        return result;
+    }
+
+    // Writes a snapshot of the elements to fd: a RingBufferSnapshotHeader followed
+    // by the elements, oldest first, gathered from the two contiguous segments by
+    // writev(). The ring buffer is unchanged. Returns false with errno set on error.
+    bool save_to(int fd) const noexcept requires(std::is_trivially_copyable_v<T>)
+    {
+        auto const one = array_one();
+        auto const two = array_two();
+        detail::SnapshotChecksum checksum;
+        checksum.update(one.data(), one.size_bytes());
+        checksum.update(two.data(), two.size_bytes());
+        RingBufferSnapshotHeader header{RingBufferSnapshotHeader::signature, N, sizeof(T), size(), one.size_bytes() + two.size_bytes(), checksum.value()};
+        iovec iov[3]{{&header, sizeof header},
+                     {const_cast<T*>(one.data()), one.size_bytes()},
+                     {const_cast<T*>(two.data()), two.size_bytes()}};
+        return detail::writeFully(fd, iov, two.empty() ? 2 : 3);
+    }
+
+    // Replaces the elements by a snapshot read from fd, which save_to() of a ring
+    // buffer of the same element type and a capacity of at most N has written. The
+    // payload is read straight into the storage from slot 0 on, no element is
+    // constructed. Returns false with errno set on error, errno is EINVAL if the
+    // snapshot does not match or its checksum is wrong. The ring buffer is empty
+    // after a failure.
+    bool restore_from(int fd) noexcept requires(std::is_trivially_copyable_v<T>)
+    {
+        clear();
+        RingBufferSnapshotHeader header;
+        if (!detail::readFully(fd, &header, sizeof header))
+        {
+            return false;
+        }
+        if (header.magic != RingBufferSnapshotHeader::signature || header.capacity > N || header.elementSize != sizeof(T) ||
+            header.count > header.capacity || header.payloadSize != header.count * sizeof(T))
+        {
+            errno = EINVAL;
+            return false;
+        }
+        auto const bytes = static_cast<size_type>(header.payloadSize);
+        if (!detail::readFully(fd, storageAt(0), bytes))
+        {
+            return false;
+        }
+        detail::SnapshotChecksum checksum;
+        checksum.update(storageAt(0), bytes);
+        if (checksum.value() != header.checksum)
+        {
+            errno = EINVAL;
+            return false;
+        }
+        produced(static_cast<size_type>(header.count));
+        return true;
+    }
+
+    // Writes a snapshot of elements which are not trivially copyable. serialize is
+    // called with each element, oldest first, and returns its bytes as anything
+    // convertible to std::span<std::byte const>. The records are gathered in a
+    // temporary buffer and written with the header by a single writev().
+    template<typename Serialize>
+    bool save_to(int fd, Serialize&& serialize) const
+    {
+        std::vector<std::byte> payload;
+        for (auto const& element : *this)
+        {
+            std::span<std::byte const> const bytes = serialize(element);
+            std::uint64_t const length = bytes.size();
+            auto const offset = payload.size();
+            payload.resize(offset + sizeof length + bytes.size());
+            std::memcpy(payload.data() + offset, &length, sizeof length);
+            if (!bytes.empty())
+            {
+                std::memcpy(payload.data() + offset + sizeof length, bytes.data(), bytes.size());
+            }
+        }
+        detail::SnapshotChecksum checksum;
+        checksum.update(payload.data(), payload.size());
+        RingBufferSnapshotHeader header{RingBufferSnapshotHeader::signature, N, 0, size(), payload.size(), checksum.value()};
+        iovec iov[2]{{&header, sizeof header}, {payload.data(), payload.size()}};
+        return detail::writeFully(fd, iov, 2);
+    }
+
+    // Replaces the elements by a snapshot which save_to(fd, serialize) of a ring
+    // buffer with a capacity of at most N has written. deserialize is called with
+    // the bytes of each element as a std::span<std::byte const>, oldest first,
+    // and returns the element to be pushed. A payload larger than the rest of a
+    // regular file is rejected before anything is allocated. Failures are
+    // reported like by restore_from(fd).
+    template<typename Deserialize>
+    bool restore_from(int fd, Deserialize&& deserialize)
+    {
+        clear();
+        RingBufferSnapshotHeader header;
+        if (!detail::readFully(fd, &header, sizeof header))
+        {
+            return false;
+        }
+        if (header.magic != RingBufferSnapshotHeader::signature || header.capacity > N || header.elementSize != 0 ||
+            header.count > header.capacity || header.payloadSize < header.count * sizeof(std::uint64_t) ||
+            header.payloadSize > detail::bytesLeft(fd) || header.payloadSize > std::numeric_limits<size_type>::max())
+        {
+            errno = EINVAL;
+            return false;
+        }
+        // The size of a pipe or socket cannot be checked up front, so the payload
+        // grows in chunks as it arrives rather than trusting payloadSize
+        constexpr size_type chunkSize = 1 << 20;
+        std::vector<std::byte> payload;
+        while (payload.size() < header.payloadSize)
+        {
+            auto const offset = payload.size();
+            payload.resize(offset + std::min<size_type>(chunkSize, static_cast<size_type>(header.payloadSize) - offset));
+            if (!detail::readFully(fd, payload.data() + offset, payload.size() - offset))
+            {
+                return false;
+            }
+        }
+        detail::SnapshotChecksum checksum;
+        checksum.update(payload.data(), payload.size());
+        if (checksum.value() != header.checksum)
+        {
+            errno = EINVAL;
+            return false;
+        }
+        std::span<std::byte const> rest{payload};
+        for (std::uint64_t i = 0; i < header.count; ++i)
+        {
+            std::uint64_t length{};
+            if (rest.size() >= sizeof length)
+            {
+                std::memcpy(&length, rest.data(), sizeof length);
+            }
+            if (rest.size() < sizeof length || length > rest.size() - sizeof length)
+            {
+                clear();
+                errno = EINVAL;
+                return false;
+            }
+            emplace(deserialize(rest.subspan(sizeof length, static_cast<size_type>(length))));
+            rest = rest.subspan(sizeof length + static_cast<size_type>(length));
+        }
+        return true;
+    }
+#endif // RB_HAS_VECTORED_IO
+
+    [[nodiscard]] policy_type& policy() noexcept
+    {
+        return policy_;
+    }
+
+    [[nodiscard]] policy_type const& policy() const noexcept
+    {
+        return policy_;
+    }
+
   private:
+    static constexpr bool hasPolicy = !std::is_same_v<policy_type, RingBufferNullPolicy<N + 1>>;
+
     std::ptrdiff_t read_{};  // Storage index of object referenced by front()
     std::ptrdiff_t write_{}; // Storage index to created the next object in
     std::aligned_storage_t<sizeof(T), alignof(T)> storage_[N + 1];
+    [[no_unique_address]] policy_type policy_;
+
+    size_type offsetOf(std::uint64_t seq) const noexcept
+    {
+        auto const tail = policy_.tail_seq();
+        return seq <= tail ? 0 : static_cast<size_type>(std::min<std::uint64_t>(seq - tail, size()));
+    }
 
     // index must be zero or higher
     auto calculateIndex(std::ptrdiff_t index) const noexcept
@@ -453,6 +997,40 @@ class RingBuffer
     {
         std::destroy_at(objectAt(index));
     }
+
+    // Appends count elements written directly into the free storage (trivial types only)
+    void produced(size_type count) noexcept
+    {
+        if constexpr (hasPolicy)
+        {
+            while (count-- != 0)
+            {
+                auto const slot = increment(write_);
+                policy_.pushed(slot, size());
+            }
+        }
+        else
+        {
+            write_ = calculateIndex(write_ + static_cast<std::ptrdiff_t>(count));
+        }
+    }
+
+    // Removes count elements from the front without destructing them (trivial types only)
+    void consumed(size_type count) noexcept
+    {
+        if constexpr (hasPolicy)
+        {
+            while (count-- != 0)
+            {
+                auto const slot = increment(read_);
+                policy_.popped(slot, size());
+            }
+        }
+        else
+        {
+            read_ = calculateIndex(read_ + static_cast<std::ptrdiff_t>(count));
+        }
+    }
 };
 
 RB_END_NAMESPACE
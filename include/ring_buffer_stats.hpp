@@ -0,0 +1,130 @@
+//
+// Occupancy statistics policy for RingBuffer<T, N>
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#ifndef RS_RING_BUFFER_STATS_HPP_INCLUDED
+#define RS_RING_BUFFER_STATS_HPP_INCLUDED
+
+// Configure namespace preference for RingBufferStats.
+// By default namespace utl is used.
+#define RS_NAMESPACE_NAME utl
+
+// clang-format off
+#ifndef RS_BEGIN_NAMESPACE
+#define RS_BEGIN_NAMESPACE namespace RS_NAMESPACE_NAME {
+#endif // RS_BEGIN_NAMESPAC
+#ifndef RS_END_NAMESPACE
+#define RS_END_NAMESPACE }
+#endif // RS_END_NAMESPACE
+// clang-format on
+
+#include "tick_clock.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+RS_BEGIN_NAMESPACE
+
+struct RingBufferStatistics
+{
+    std::uint64_t pushes{};     // Elements added, including those which caused an overwrite
+    std::uint64_t pops{};       // Elements removed by pop() or clear()
+    std::uint64_t overwrites{}; // Elements dropped by emplace() because the ring buffer was full
+    std::size_t size{};         // Current number of elements
+    std::size_t highWaterMark{};
+    std::size_t capacity{};
+    double averageOccupancy{}; // Time-weighted mean number of elements since construction or reset()
+
+    [[nodiscard]] double averageUtilization() const noexcept
+    {
+        return averageOccupancy / static_cast<double>(capacity);
+    }
+};
+
+// RingBuffer policy keeping track of how full a ring buffer gets. Use it to size
+// N and to detect overwrites, which RingBuffer::emplace() performs silently.
+// The time-weighted occupancy reads Clock on every push and pop; pass a cheaper
+// clock via an alias template if that is too expensive:
+//
+//   template<std::size_t Slots>
+//   using SteadyStats = RingBufferStats<Slots, SteadyTickClock>;
+//
+//   RingBuffer<Order, 1024, RingBufferStats> rb;
+//   ...
+//   if (rb.policy().snapshot().overwrites > 0) ...
+template<std::size_t Slots, typename Clock = ::TC_NAMESPACE_NAME::DefaultTickClock>
+class RingBufferStats
+{
+  public:
+    void pushed(std::size_t, std::size_t size) noexcept
+    {
+        ++pushes_;
+        update(size);
+        highWaterMark_ = std::max(highWaterMark_, size);
+    }
+
+    void popped(std::size_t, std::size_t size) noexcept
+    {
+        ++pops_;
+        update(size);
+    }
+
+    void overwritten(std::size_t, std::size_t) noexcept
+    {
+        ++overwrites_;
+    }
+
+    [[nodiscard]] RingBufferStatistics snapshot() const noexcept
+    {
+        auto const now = Clock::now();
+        auto const occupancy = occupancy_ + static_cast<double>(size_) * static_cast<double>(now - last_);
+        auto const elapsed = now - start_;
+
+        RingBufferStatistics statistics;
+        statistics.pushes = pushes_;
+        statistics.pops = pops_;
+        statistics.overwrites = overwrites_;
+        statistics.size = size_;
+        statistics.highWaterMark = highWaterMark_;
+        statistics.capacity = Slots - 1;
+        statistics.averageOccupancy = elapsed == 0 ? static_cast<double>(size_) : occupancy / static_cast<double>(elapsed);
+        return statistics;
+    }
+
+    // Restarts all counters and the averaging period. The high water mark
+    // starts over at the current size.
+    void reset() noexcept
+    {
+        pushes_ = pops_ = overwrites_ = 0;
+        highWaterMark_ = size_;
+        occupancy_ = 0.0;
+        start_ = last_ = Clock::now();
+    }
+
+  private:
+    std::uint64_t pushes_{};
+    std::uint64_t pops_{};
+    std::uint64_t overwrites_{};
+    std::size_t size_{};
+    std::size_t highWaterMark_{};
+    double occupancy_{}; // Sum of size_ * ticks
+    std::uint64_t start_{Clock::now()};
+    std::uint64_t last_{start_};
+
+    void update(std::size_t size) noexcept
+    {
+        auto const now = Clock::now();
+        occupancy_ += static_cast<double>(size_) * static_cast<double>(now - last_);
+        last_ = now;
+        size_ = size;
+    }
+};
+
+RS_END_NAMESPACE
+
+#endif // RS_RING_BUFFER_STATS_HPP_INCLUDED
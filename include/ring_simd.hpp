@@ -0,0 +1,609 @@
+//
+// Vectorized reductions and searches over the contents of ring buffers
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#ifndef RV_RING_SIMD_HPP_INCLUDED
+#define RV_RING_SIMD_HPP_INCLUDED
+
+// Configure namespace preference for the ring_simd kernels.
+// By default namespace utl is used.
+#define RV_NAMESPACE_NAME utl
+
+// clang-format off
+#ifndef RV_BEGIN_NAMESPACE
+#define RV_BEGIN_NAMESPACE namespace RV_NAMESPACE_NAME {
+#endif // RV_BEGIN_NAMESPAC
+#ifndef RV_END_NAMESPACE
+#define RV_END_NAMESPACE }
+#endif // RV_END_NAMESPACE
+// clang-format on
+
+#include "ring_buffer.hpp"
+#include "simd_level.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <ranges>
+#include <span>
+
+RV_BEGIN_NAMESPACE
+
+// Kernels for RingBuffer<double, N> and contiguous arrays of doubles:
+//
+//   auto const high = ring_simd::max(prices);
+//   auto const first = ring_simd::find_if(prices, ring_simd::Compare::greater, limit);
+//
+// A ring buffer is processed as its two contiguous segments, indices refer to
+// the logical order, 0 being the front. The kernels for AVX2 and AVX-512 are
+// selected at runtime by simd_level(), a scalar kernel is the fallback. Each
+// function takes the level explicitly as its last argument, e.g. for testing.
+//
+// Comparisons, searches, minimum, maximum and histograms are exact and agree
+// with their std algorithm counterparts. sum() adds in a different order than
+// std::accumulate, so its result may differ in the last bits. NaNs are not
+// supported by min(), max(), argmin() and argmax().
+namespace ring_simd
+{
+    using ::SL_NAMESPACE_NAME::SimdLevel;
+
+    // Comparison of an element (left) with a threshold (right)
+    enum class Compare
+    {
+        less,
+        less_equal,
+        greater,
+        greater_equal,
+        equal,
+        not_equal
+    };
+
+    // The elements as up to two contiguous segments
+    struct Segments
+    {
+        std::span<double const> one;
+        std::span<double const> two;
+
+        template<std::ranges::contiguous_range R>
+        Segments(R const& range) noexcept
+            : one{std::ranges::data(range), std::ranges::size(range)}
+        {
+        }
+
+        template<std::size_t N, template<std::size_t> class Policy>
+        Segments(::RB_NAMESPACE_NAME::RingBuffer<double, N, Policy> const& ring) noexcept
+            : one{ring.array_one()}
+            , two{ring.array_two()}
+        {
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept
+        {
+            return one.size() + two.size();
+        }
+    };
+
+    namespace detail
+    {
+        using SumFn = double (*)(double const* data, std::size_t n) noexcept;
+        using SearchFn = std::size_t (*)(double const* data, std::size_t n, double threshold) noexcept;
+        using HistogramFn = std::size_t (*)(double const* data, std::size_t n, double low, double high, double scale,
+                                            std::uint64_t* bins, std::size_t count) noexcept;
+
+        // The kernels of one level, searches indexed by Compare
+        struct Kernels
+        {
+            SumFn sum;
+            SumFn min;
+            SumFn max;
+            SearchFn find[6];  // Index of the first match or n
+            SearchFn count[6]; // Number of matches
+            HistogramFn histogram;
+        };
+
+        template<Compare C>
+        constexpr bool compare(double x, double threshold) noexcept
+        {
+            switch (C)
+            {
+                case Compare::less:
+                    return x < threshold;
+                case Compare::less_equal:
+                    return x <= threshold;
+                case Compare::greater:
+                    return x > threshold;
+                case Compare::greater_equal:
+                    return x >= threshold;
+                case Compare::equal:
+                    return x == threshold;
+                default:
+                    return x != threshold;
+            }
+        }
+
+        // The bin of x in [low, high). The vector kernels truncate in the same
+        // way, so values on bin boundaries land in the same bin at every level.
+        inline std::size_t binOf(double x, double low, double scale, std::size_t count) noexcept
+        {
+            return std::min(static_cast<std::size_t>((x - low) * scale), count - 1);
+        }
+
+        inline double sumScalar(double const* data, std::size_t n) noexcept
+        {
+            double sums[4]{};
+            std::size_t i = 0;
+            for (; i + 4 <= n; i += 4)
+            {
+                for (std::size_t lane = 0; lane < 4; ++lane)
+                {
+                    sums[lane] += data[i + lane];
+                }
+            }
+            for (; i < n; ++i)
+            {
+                sums[0] += data[i];
+            }
+            return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+        }
+
+        inline double minScalar(double const* data, std::size_t n) noexcept
+        {
+            auto result = std::numeric_limits<double>::infinity();
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                result = data[i] < result ? data[i] : result;
+            }
+            return result;
+        }
+
+        inline double maxScalar(double const* data, std::size_t n) noexcept
+        {
+            auto result = -std::numeric_limits<double>::infinity();
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                result = data[i] > result ? data[i] : result;
+            }
+            return result;
+        }
+
+        template<Compare C>
+        std::size_t findScalar(double const* data, std::size_t n, double threshold) noexcept
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                if (compare<C>(data[i], threshold))
+                {
+                    return i;
+                }
+            }
+            return n;
+        }
+
+        template<Compare C>
+        std::size_t countScalar(double const* data, std::size_t n, double threshold) noexcept
+        {
+            std::size_t result = 0;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                result += compare<C>(data[i], threshold);
+            }
+            return result;
+        }
+
+        inline std::size_t histogramScalar(double const* data, std::size_t n, double low, double high, double scale,
+                                           std::uint64_t* bins, std::size_t count) noexcept
+        {
+            std::size_t result = 0;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                if (data[i] >= low && data[i] < high)
+                {
+                    ++bins[binOf(data[i], low, scale, count)];
+                    ++result;
+                }
+            }
+            return result;
+        }
+
+        inline constexpr Kernels scalarKernels{
+            &sumScalar,
+            &minScalar,
+            &maxScalar,
+            {&findScalar<Compare::less>, &findScalar<Compare::less_equal>, &findScalar<Compare::greater>,
+             &findScalar<Compare::greater_equal>, &findScalar<Compare::equal>, &findScalar<Compare::not_equal>},
+            {&countScalar<Compare::less>, &countScalar<Compare::less_equal>, &countScalar<Compare::greater>,
+             &countScalar<Compare::greater_equal>, &countScalar<Compare::equal>, &countScalar<Compare::not_equal>},
+            &histogramScalar};
+
+#ifdef SL_HAS_X86_DISPATCH
+        // Predicate of _mm256_cmp_pd() and _mm512_cmp_pd_mask(), ordered like
+        // the C++ operators except for not_equal, which holds for NaNs
+        template<Compare C>
+        constexpr int predicate = C == Compare::less            ? _CMP_LT_OQ
+                                  : C == Compare::less_equal    ? _CMP_LE_OQ
+                                  : C == Compare::greater       ? _CMP_GT_OQ
+                                  : C == Compare::greater_equal ? _CMP_GE_OQ
+                                  : C == Compare::equal         ? _CMP_EQ_OQ
+                                                                : _CMP_NEQ_UQ;
+
+        __attribute__((target("avx2"))) inline double sumAvx2(double const* data, std::size_t n) noexcept
+        {
+            __m256d sums[4]{_mm256_setzero_pd(), _mm256_setzero_pd(), _mm256_setzero_pd(), _mm256_setzero_pd()};
+            std::size_t i = 0;
+            for (; i + 16 <= n; i += 16)
+            {
+                for (std::size_t k = 0; k < 4; ++k)
+                {
+                    sums[k] = _mm256_add_pd(sums[k], _mm256_loadu_pd(data + i + 4 * k));
+                }
+            }
+            for (; i + 4 <= n; i += 4)
+            {
+                sums[0] = _mm256_add_pd(sums[0], _mm256_loadu_pd(data + i));
+            }
+            auto const sum = _mm256_add_pd(_mm256_add_pd(sums[0], sums[1]), _mm256_add_pd(sums[2], sums[3]));
+            alignas(32) double lanes[4];
+            _mm256_store_pd(lanes, sum);
+            auto result = (lanes[0] + lanes[2]) + (lanes[1] + lanes[3]);
+            for (; i < n; ++i)
+            {
+                result += data[i];
+            }
+            return result;
+        }
+
+        template<bool Min>
+        __attribute__((target("avx2"))) double extremeAvx2(double const* data, std::size_t n) noexcept
+        {
+            auto const initial = Min ? std::numeric_limits<double>::infinity() : -std::numeric_limits<double>::infinity();
+            __m256d results[2]{_mm256_set1_pd(initial), _mm256_set1_pd(initial)};
+            std::size_t i = 0;
+            for (; i + 8 <= n; i += 8)
+            {
+                auto const a = _mm256_loadu_pd(data + i);
+                auto const b = _mm256_loadu_pd(data + i + 4);
+                results[0] = Min ? _mm256_min_pd(results[0], a) : _mm256_max_pd(results[0], a);
+                results[1] = Min ? _mm256_min_pd(results[1], b) : _mm256_max_pd(results[1], b);
+            }
+            alignas(32) double lanes[4];
+            _mm256_store_pd(lanes, Min ? _mm256_min_pd(results[0], results[1]) : _mm256_max_pd(results[0], results[1]));
+            auto result = initial;
+            for (auto const lane : lanes)
+            {
+                result = Min ? std::min(result, lane) : std::max(result, lane);
+            }
+            for (; i < n; ++i)
+            {
+                result = Min ? std::min(result, data[i]) : std::max(result, data[i]);
+            }
+            return result;
+        }
+
+        template<Compare C>
+        __attribute__((target("avx2"))) std::size_t findAvx2(double const* data, std::size_t n, double threshold) noexcept
+        {
+            auto const t = _mm256_set1_pd(threshold);
+            std::size_t i = 0;
+            for (; i + 16 <= n; i += 16)
+            {
+                __m256d matches[4];
+                for (std::size_t k = 0; k < 4; ++k)
+                {
+                    matches[k] = _mm256_cmp_pd(_mm256_loadu_pd(data + i + 4 * k), t, predicate<C>);
+                }
+                auto const any = _mm256_or_pd(_mm256_or_pd(matches[0], matches[1]), _mm256_or_pd(matches[2], matches[3]));
+                if (_mm256_movemask_pd(any) != 0)
+                {
+                    for (std::size_t k = 0;; ++k)
+                    {
+                        if (auto const mask = static_cast<unsigned>(_mm256_movemask_pd(matches[k])); mask != 0)
+                        {
+                            return i + 4 * k + static_cast<std::size_t>(std::countr_zero(mask));
+                        }
+                    }
+                }
+            }
+            for (; i + 4 <= n; i += 4)
+            {
+                if (auto const mask = static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(data + i), t, predicate<C>))); mask != 0)
+                {
+                    return i + static_cast<std::size_t>(std::countr_zero(mask));
+                }
+            }
+            return i + findScalar<C>(data + i, n - i, threshold);
+        }
+
+        template<Compare C>
+        __attribute__((target("avx2"))) std::size_t countAvx2(double const* data, std::size_t n, double threshold) noexcept
+        {
+            // A match is all ones, i.e. -1 as a 64 bit integer
+            auto const t = _mm256_set1_pd(threshold);
+            __m256i counts[2]{_mm256_setzero_si256(), _mm256_setzero_si256()};
+            std::size_t i = 0;
+            for (; i + 8 <= n; i += 8)
+            {
+                counts[0] = _mm256_sub_epi64(counts[0], _mm256_castpd_si256(_mm256_cmp_pd(_mm256_loadu_pd(data + i), t, predicate<C>)));
+                counts[1] = _mm256_sub_epi64(counts[1], _mm256_castpd_si256(_mm256_cmp_pd(_mm256_loadu_pd(data + i + 4), t, predicate<C>)));
+            }
+            alignas(32) std::uint64_t lanes[4];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), _mm256_add_epi64(counts[0], counts[1]));
+            return static_cast<std::size_t>(lanes[0] + lanes[1] + lanes[2] + lanes[3]) + countScalar<C>(data + i, n - i, threshold);
+        }
+
+        __attribute__((target("avx2"))) inline std::size_t histogramAvx2(double const* data, std::size_t n, double low, double high,
+                                                                          double scale, std::uint64_t* bins, std::size_t count) noexcept
+        {
+            auto const lowV = _mm256_set1_pd(low);
+            auto const highV = _mm256_set1_pd(high);
+            auto const scaleV = _mm256_set1_pd(scale);
+            auto const last = static_cast<std::uint32_t>(count - 1);
+            std::size_t result = 0;
+            std::size_t i = 0;
+            for (; i + 4 <= n; i += 4)
+            {
+                auto const x = _mm256_loadu_pd(data + i);
+                auto const inside = _mm256_and_pd(_mm256_cmp_pd(x, lowV, _CMP_GE_OQ), _mm256_cmp_pd(x, highV, _CMP_LT_OQ));
+                auto mask = static_cast<unsigned>(_mm256_movemask_pd(inside));
+                if (mask == 0)
+                {
+                    continue;
+                }
+                alignas(16) std::uint32_t lanes[4];
+                _mm_store_si128(reinterpret_cast<__m128i*>(lanes), _mm256_cvttpd_epi32(_mm256_mul_pd(_mm256_sub_pd(x, lowV), scaleV)));
+                result += static_cast<std::size_t>(std::popcount(mask));
+                for (; mask != 0; mask &= mask - 1)
+                {
+                    ++bins[std::min(lanes[std::countr_zero(mask)], last)];
+                }
+            }
+            return result + histogramScalar(data + i, n - i, low, high, scale, bins, count);
+        }
+
+        inline constexpr Kernels avx2Kernels{
+            &sumAvx2,
+            &extremeAvx2<true>,
+            &extremeAvx2<false>,
+            {&findAvx2<Compare::less>, &findAvx2<Compare::less_equal>, &findAvx2<Compare::greater>, &findAvx2<Compare::greater_equal>,
+             &findAvx2<Compare::equal>, &findAvx2<Compare::not_equal>},
+            {&countAvx2<Compare::less>, &countAvx2<Compare::less_equal>, &countAvx2<Compare::greater>,
+             &countAvx2<Compare::greater_equal>, &countAvx2<Compare::equal>, &countAvx2<Compare::not_equal>},
+            &histogramAvx2};
+
+        // GCC 12 reports the undefined vectors, which the intrinsics use for
+        // lanes they overwrite anyway, as uninitialized
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+        __attribute__((target("avx512f"))) inline double sumAvx512(double const* data, std::size_t n) noexcept
+        {
+            __m512d sums[4]{_mm512_setzero_pd(), _mm512_setzero_pd(), _mm512_setzero_pd(), _mm512_setzero_pd()};
+            std::size_t i = 0;
+            for (; i + 32 <= n; i += 32)
+            {
+                for (std::size_t k = 0; k < 4; ++k)
+                {
+                    sums[k] = _mm512_add_pd(sums[k], _mm512_loadu_pd(data + i + 8 * k));
+                }
+            }
+            for (; i + 8 <= n; i += 8)
+            {
+                sums[0] = _mm512_add_pd(sums[0], _mm512_loadu_pd(data + i));
+            }
+            if (i != n)
+            {
+                auto const tail = static_cast<__mmask8>((1u << (n - i)) - 1);
+                sums[1] = _mm512_add_pd(sums[1], _mm512_maskz_loadu_pd(tail, data + i));
+            }
+            return _mm512_reduce_add_pd(_mm512_add_pd(_mm512_add_pd(sums[0], sums[1]), _mm512_add_pd(sums[2], sums[3])));
+        }
+
+        template<bool Min>
+        __attribute__((target("avx512f"))) double extremeAvx512(double const* data, std::size_t n) noexcept
+        {
+            auto const initial = _mm512_set1_pd(Min ? std::numeric_limits<double>::infinity() : -std::numeric_limits<double>::infinity());
+            __m512d results[2]{initial, initial};
+            std::size_t i = 0;
+            for (; i + 16 <= n; i += 16)
+            {
+                auto const a = _mm512_loadu_pd(data + i);
+                auto const b = _mm512_loadu_pd(data + i + 8);
+                results[0] = Min ? _mm512_min_pd(results[0], a) : _mm512_max_pd(results[0], a);
+                results[1] = Min ? _mm512_min_pd(results[1], b) : _mm512_max_pd(results[1], b);
+            }
+            for (; i < n; i += 8)
+            {
+                // The lanes beyond n keep the initial value
+                auto const x = _mm512_mask_loadu_pd(initial, static_cast<__mmask8>(n - i >= 8 ? 0xFF : (1u << (n - i)) - 1), data + i);
+                results[0] = Min ? _mm512_min_pd(results[0], x) : _mm512_max_pd(results[0], x);
+            }
+            return Min ? _mm512_reduce_min_pd(_mm512_min_pd(results[0], results[1])) : _mm512_reduce_max_pd(_mm512_max_pd(results[0], results[1]));
+        }
+
+        template<Compare C>
+        __attribute__((target("avx512f"))) std::size_t findAvx512(double const* data, std::size_t n, double threshold) noexcept
+        {
+            auto const t = _mm512_set1_pd(threshold);
+            std::size_t i = 0;
+            for (; i + 32 <= n; i += 32)
+            {
+                auto const matches = static_cast<std::uint32_t>(_mm512_cmp_pd_mask(_mm512_loadu_pd(data + i), t, predicate<C>)) |
+                                     static_cast<std::uint32_t>(_mm512_cmp_pd_mask(_mm512_loadu_pd(data + i + 8), t, predicate<C>)) << 8 |
+                                     static_cast<std::uint32_t>(_mm512_cmp_pd_mask(_mm512_loadu_pd(data + i + 16), t, predicate<C>)) << 16 |
+                                     static_cast<std::uint32_t>(_mm512_cmp_pd_mask(_mm512_loadu_pd(data + i + 24), t, predicate<C>)) << 24;
+                if (matches != 0)
+                {
+                    return i + static_cast<std::size_t>(std::countr_zero(matches));
+                }
+            }
+            for (; i < n; i += 8)
+            {
+                auto const valid = static_cast<__mmask8>(n - i >= 8 ? 0xFF : (1u << (n - i)) - 1);
+                auto const matches = static_cast<unsigned>(_mm512_mask_cmp_pd_mask(valid, _mm512_maskz_loadu_pd(valid, data + i), t, predicate<C>));
+                if (matches != 0)
+                {
+                    return i + static_cast<std::size_t>(std::countr_zero(matches));
+                }
+            }
+            return n;
+        }
+
+        template<Compare C>
+        __attribute__((target("avx512f"))) std::size_t countAvx512(double const* data, std::size_t n, double threshold) noexcept
+        {
+            auto const t = _mm512_set1_pd(threshold);
+            std::size_t result = 0;
+            std::size_t i = 0;
+            for (; i + 8 <= n; i += 8)
+            {
+                result += static_cast<std::size_t>(std::popcount(static_cast<unsigned>(_mm512_cmp_pd_mask(_mm512_loadu_pd(data + i), t, predicate<C>))));
+            }
+            if (i != n)
+            {
+                auto const valid = static_cast<__mmask8>((1u << (n - i)) - 1);
+                auto const matches = _mm512_mask_cmp_pd_mask(valid, _mm512_maskz_loadu_pd(valid, data + i), t, predicate<C>);
+                result += static_cast<std::size_t>(std::popcount(static_cast<unsigned>(matches)));
+            }
+            return result;
+        }
+
+        __attribute__((target("avx512f"))) inline std::size_t histogramAvx512(double const* data, std::size_t n, double low, double high,
+                                                                               double scale, std::uint64_t* bins, std::size_t count) noexcept
+        {
+            auto const lowV = _mm512_set1_pd(low);
+            auto const highV = _mm512_set1_pd(high);
+            auto const scaleV = _mm512_set1_pd(scale);
+            auto const last = static_cast<std::uint32_t>(count - 1);
+            std::size_t result = 0;
+            std::size_t i = 0;
+            for (; i + 8 <= n; i += 8)
+            {
+                auto const x = _mm512_loadu_pd(data + i);
+                auto mask = static_cast<unsigned>(_mm512_mask_cmp_pd_mask(_mm512_cmp_pd_mask(x, lowV, _CMP_GE_OQ), x, highV, _CMP_LT_OQ));
+                if (mask == 0)
+                {
+                    continue;
+                }
+                alignas(32) std::uint32_t lanes[8];
+                _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), _mm512_cvttpd_epi32(_mm512_mul_pd(_mm512_sub_pd(x, lowV), scaleV)));
+                result += static_cast<std::size_t>(std::popcount(mask));
+                for (; mask != 0; mask &= mask - 1)
+                {
+                    ++bins[std::min(lanes[std::countr_zero(mask)], last)];
+                }
+            }
+            return result + histogramScalar(data + i, n - i, low, high, scale, bins, count);
+        }
+
+        inline constexpr Kernels avx512Kernels{
+            &sumAvx512,
+            &extremeAvx512<true>,
+            &extremeAvx512<false>,
+            {&findAvx512<Compare::less>, &findAvx512<Compare::less_equal>, &findAvx512<Compare::greater>,
+             &findAvx512<Compare::greater_equal>, &findAvx512<Compare::equal>, &findAvx512<Compare::not_equal>},
+            {&countAvx512<Compare::less>, &countAvx512<Compare::less_equal>, &countAvx512<Compare::greater>,
+             &countAvx512<Compare::greater_equal>, &countAvx512<Compare::equal>, &countAvx512<Compare::not_equal>},
+            &histogramAvx512};
+#pragma GCC diagnostic pop
+#endif // SL_HAS_X86_DISPATCH
+
+        // The kernels of level, there are none for SSE
+        inline Kernels const& kernels(SimdLevel level) noexcept
+        {
+            switch (level)
+            {
+#ifdef SL_HAS_X86_DISPATCH
+                case SimdLevel::avx512:
+                    return avx512Kernels;
+                case SimdLevel::avx2:
+                    return avx2Kernels;
+#endif // SL_HAS_X86_DISPATCH
+                default:
+                    return scalarKernels;
+            }
+        }
+
+        // Index of the first element of segments for which search finds a match
+        template<typename Search>
+        std::size_t firstOf(Segments const& segments, Search search) noexcept
+        {
+            if (auto const index = search(segments.one); index != segments.one.size())
+            {
+                return index;
+            }
+            return segments.one.size() + search(segments.two);
+        }
+    } // namespace detail
+
+    [[nodiscard]] inline double sum(Segments const& segments, SimdLevel level = ::SL_NAMESPACE_NAME::simd_level()) noexcept
+    {
+        auto const& kernels = detail::kernels(level);
+        return kernels.sum(segments.one.data(), segments.one.size()) + kernels.sum(segments.two.data(), segments.two.size());
+    }
+
+    // The smallest element, +infinity if there is none
+    [[nodiscard]] inline double min(Segments const& segments, SimdLevel level = ::SL_NAMESPACE_NAME::simd_level()) noexcept
+    {
+        auto const& kernels = detail::kernels(level);
+        return std::min(kernels.min(segments.one.data(), segments.one.size()), kernels.min(segments.two.data(), segments.two.size()));
+    }
+
+    // The largest element, -infinity if there is none
+    [[nodiscard]] inline double max(Segments const& segments, SimdLevel level = ::SL_NAMESPACE_NAME::simd_level()) noexcept
+    {
+        auto const& kernels = detail::kernels(level);
+        return std::max(kernels.max(segments.one.data(), segments.one.size()), kernels.max(segments.two.data(), segments.two.size()));
+    }
+
+    // Index of the first element comparing to threshold as given, size() if none does
+    [[nodiscard]] inline std::size_t find_if(Segments const& segments, Compare compare, double threshold,
+                                             SimdLevel level = ::SL_NAMESPACE_NAME::simd_level()) noexcept
+    {
+        auto const find = detail::kernels(level).find[static_cast<int>(compare)];
+        return detail::firstOf(segments, [&](std::span<double const> data) { return find(data.data(), data.size(), threshold); });
+    }
+
+    // Number of elements comparing to threshold as given
+    [[nodiscard]] inline std::size_t count_if(Segments const& segments, Compare compare, double threshold,
+                                              SimdLevel level = ::SL_NAMESPACE_NAME::simd_level()) noexcept
+    {
+        auto const count = detail::kernels(level).count[static_cast<int>(compare)];
+        return count(segments.one.data(), segments.one.size(), threshold) + count(segments.two.data(), segments.two.size(), threshold);
+    }
+
+    // Index of the first smallest element like std::min_element(), size() if there is none
+    [[nodiscard]] inline std::size_t argmin(Segments const& segments, SimdLevel level = ::SL_NAMESPACE_NAME::simd_level()) noexcept
+    {
+        return segments.size() == 0 ? 0 : find_if(segments, Compare::equal, min(segments, level), level);
+    }
+
+    // Index of the first largest element like std::max_element(), size() if there is none
+    [[nodiscard]] inline std::size_t argmax(Segments const& segments, SimdLevel level = ::SL_NAMESPACE_NAME::simd_level()) noexcept
+    {
+        return segments.size() == 0 ? 0 : find_if(segments, Compare::equal, max(segments, level), level);
+    }
+
+    // Adds the elements in [low, high) to bins of equal width, which divide the
+    // range. Returns the number of elements added.
+    inline std::size_t histogram(Segments const& segments, double low, double high, std::span<std::uint64_t> bins,
+                                 SimdLevel level = ::SL_NAMESPACE_NAME::simd_level()) noexcept
+    {
+        if (bins.empty() || !(low < high))
+        {
+            return 0;
+        }
+        auto const histogram = detail::kernels(level).histogram;
+        auto const scale = static_cast<double>(bins.size()) / (high - low);
+        return histogram(segments.one.data(), segments.one.size(), low, high, scale, bins.data(), bins.size()) +
+               histogram(segments.two.data(), segments.two.size(), low, high, scale, bins.data(), bins.size());
+    }
+} // namespace ring_simd
+
+RV_END_NAMESPACE
+
+#endif // RV_RING_SIMD_HPP_INCLUDED
@@ -0,0 +1,248 @@
+//
+// Multi resolution store of consolidated samples in the style of RRDtool
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#ifndef RD_ROUND_ROBIN_STORE_HPP_INCLUDED
+#define RD_ROUND_ROBIN_STORE_HPP_INCLUDED
+
+// Configure namespace preference for RoundRobinStore.
+// By default namespace utl is used.
+#define RD_NAMESPACE_NAME utl
+
+// clang-format off
+#ifndef RD_BEGIN_NAMESPACE
+#define RD_BEGIN_NAMESPACE namespace RD_NAMESPACE_NAME {
+#endif // RD_BEGIN_NAMESPAC
+#ifndef RD_END_NAMESPACE
+#define RD_END_NAMESPACE }
+#endif // RD_END_NAMESPACE
+// clang-format on
+
+#include "ring_buffer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <span>
+
+RD_BEGIN_NAMESPACE
+
+// Samples consolidated over one step of a RoundRobinStore level
+template<typename T>
+struct RoundRobinRow
+{
+    std::uint64_t time; // Start of the step
+    T min;
+    T max;
+    T last;
+    double sum;
+    std::uint32_t count;
+
+    [[nodiscard]] double average() const noexcept
+    {
+        return sum / static_cast<double>(count);
+    }
+
+    void merge(RoundRobinRow const& row) noexcept
+    {
+        min = std::min(min, row.min);
+        max = std::max(max, row.max);
+        last = row.last;
+        sum += row.sum;
+        count += row.count;
+    }
+};
+
+// Rows of one level within a time range, as up to two contiguous segments
+template<typename T>
+struct RoundRobinRange
+{
+    std::size_t level;
+    std::span<RoundRobinRow<T> const> first;
+    std::span<RoundRobinRow<T> const> second;
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return first.size() + second.size();
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+};
+
+// Cascade of Levels RingBuffers of N rows each. Level l consolidates the
+// samples of steps[l] ticks into one row holding min, max, average and last
+// value. Every level is fed by the level below: when a step of level l is
+// complete, its row is appended to the ring buffer of level l and merged into
+// the open row of level l + 1. The oldest rows are overwritten, so memory is
+// fixed and coarser levels reach further back:
+//
+//   // 1 second rows for 24 minutes, 1 minute rows for a day, 1 hour rows for 60 days
+//   auto rrd = std::make_unique<RoundRobinStore<double, 1440, 3>>(std::array<std::uint64_t, 3>{1, 60, 3600});
+//   rrd->push(seconds, value);
+//   ...
+//   auto const rows = rrd->query(seconds - 6 * 3600, seconds);
+//
+// Steps must increase and each must be a multiple of the one below. Time must
+// not go backwards. Rows of steps without samples are omitted, i.e. gaps show
+// in the row times. Open rows are not visible to queries until their step is
+// complete or flush() is called. Samples pushed after flush() within the same
+// step are merged into the row flush() completed.
+template<typename T, std::size_t N, std::size_t Levels>
+class RoundRobinStore
+{
+  public:
+    static_assert(Levels > 0, "Template argument Levels must not be zero");
+
+    using value_type = T;
+    using time_type = std::uint64_t;
+    using row_type = RoundRobinRow<T>;
+    using range_type = RoundRobinRange<T>;
+    using ring_buffer_type = ::RB_NAMESPACE_NAME::RingBuffer<row_type, N>;
+
+    explicit RoundRobinStore(std::array<time_type, Levels> const& steps) noexcept
+        : steps_{steps}
+    {
+    }
+
+    RoundRobinStore(RoundRobinStore&&) = delete;
+    RoundRobinStore(RoundRobinStore const&) = delete;
+    RoundRobinStore& operator=(RoundRobinStore&&) = delete;
+    RoundRobinStore& operator=(RoundRobinStore const&) = delete;
+
+    void push(time_type time, T const& value) noexcept
+    {
+        merge(0, row_type{time, value, value, value, static_cast<double>(value), 1});
+    }
+
+    // Completes the open rows of all levels
+    void flush() noexcept
+    {
+        for (std::size_t level = 0; level < Levels; ++level)
+        {
+            if (open_[level].count != 0)
+            {
+                close(level);
+            }
+        }
+    }
+
+    // Rows of the finest level which reaches back to from, otherwise of the
+    // coarsest level, with a step starting in [from, to). If maxRows is given,
+    // the finest level with no more rows than that in the range is used.
+    [[nodiscard]] range_type query(time_type from, time_type to, std::size_t maxRows = N) const noexcept
+    {
+        for (std::size_t level = 0; level < Levels; ++level)
+        {
+            auto const& ring = levels_[level];
+            if (level + 1 == Levels || (!ring.empty() && ring.front().time <= from))
+            {
+                auto const range = rows(level, from, to);
+                if (range.size() <= maxRows || level + 1 == Levels)
+                {
+                    return range;
+                }
+            }
+        }
+        return {};
+    }
+
+    // Rows of a level with a step starting in [from, to)
+    [[nodiscard]] range_type rows(std::size_t level, time_type from, time_type to) const noexcept
+    {
+        auto const& ring = levels_[level];
+        return {level, slice(ring.array_one(), from, to), slice(ring.array_two(), from, to)};
+    }
+
+    // The completed rows of a level, oldest first
+    [[nodiscard]] ring_buffer_type const& level(std::size_t level) const noexcept
+    {
+        return levels_[level];
+    }
+
+    // The row of a level which is being consolidated, its count is 0 if
+    // there is none
+    [[nodiscard]] row_type const& open(std::size_t level) const noexcept
+    {
+        return open_[level];
+    }
+
+    [[nodiscard]] time_type step(std::size_t level) const noexcept
+    {
+        return steps_[level];
+    }
+
+    [[nodiscard]] std::size_t levels() const noexcept
+    {
+        return Levels;
+    }
+
+    [[nodiscard]] std::size_t capacity() const noexcept
+    {
+        return N;
+    }
+
+  private:
+    std::array<time_type, Levels> steps_;
+    std::array<row_type, Levels> open_{};
+    std::array<ring_buffer_type, Levels> levels_;
+
+    // Adds a row of the level below or a sample to the open row of level
+    void merge(std::size_t level, row_type const& row) noexcept
+    {
+        auto& open = open_[level];
+        auto const start = row.time - row.time % steps_[level];
+        if (open.count != 0 && open.time != start)
+        {
+            close(level);
+        }
+        if (open.count == 0)
+        {
+            open = row;
+            open.time = start;
+        }
+        else
+        {
+            open.merge(row);
+        }
+    }
+
+    void close(std::size_t level) noexcept
+    {
+        auto& open = open_[level];
+        auto& ring = levels_[level];
+        if (!ring.empty() && ring.back().time == open.time)
+        {
+            // flush() completed this step before, the later samples extend its row
+            ring.back().merge(open);
+        }
+        else
+        {
+            ring.push(open);
+        }
+        if (level + 1 < Levels)
+        {
+            merge(level + 1, open);
+        }
+        open.count = 0;
+    }
+
+    static std::span<row_type const> slice(std::span<row_type const> rows, time_type from, time_type to) noexcept
+    {
+        auto const before = [](row_type const& row, time_type time) { return row.time < time; };
+        auto const first = std::lower_bound(rows.begin(), rows.end(), from, before);
+        auto const last = std::lower_bound(first, rows.end(), to, before);
+        return {first, last};
+    }
+};
+
+RD_END_NAMESPACE
+
+#endif // RD_ROUND_ROBIN_STORE_HPP_INCLUDED
@@ -0,0 +1,69 @@
+//
+// Runtime detection of the SIMD instruction sets of the processor
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#ifndef SL_SIMD_LEVEL_HPP_INCLUDED
+#define SL_SIMD_LEVEL_HPP_INCLUDED
+
+// Configure namespace preference for SimdLevel.
+// By default namespace utl is used.
+#define SL_NAMESPACE_NAME utl
+
+// clang-format off
+#ifndef SL_BEGIN_NAMESPACE
+#define SL_BEGIN_NAMESPACE namespace SL_NAMESPACE_NAME {
+#endif // SL_BEGIN_NAMESPAC
+#ifndef SL_END_NAMESPACE
+#define SL_END_NAMESPACE }
+#endif // SL_END_NAMESPACE
+// clang-format on
+
+// Kernels for x86 instruction sets beyond the compiler's target are compiled
+// with function attributes and selected at runtime, which needs GCC or Clang
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define SL_HAS_X86_DISPATCH 1
+#endif
+
+SL_BEGIN_NAMESPACE
+
+// Instruction set of a kernel, in increasing order of preference. A kernel
+// family without a kernel for a level uses the one of the next lower level.
+enum class SimdLevel
+{
+    scalar,
+    sse,    // SSE2
+    avx2,   // AVX2 and FMA
+    avx512  // AVX-512 F
+};
+
+// The best instruction set the processor supports, detected once
+[[nodiscard]] inline SimdLevel simd_level() noexcept
+{
+#ifdef SL_HAS_X86_DISPATCH
+    static SimdLevel const level = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        {
+            return SimdLevel::avx512;
+        }
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        {
+            return SimdLevel::avx2;
+        }
+        return __builtin_cpu_supports("sse2") ? SimdLevel::sse : SimdLevel::scalar;
+    }();
+    return level;
+#else
+    return SimdLevel::scalar;
+#endif // SL_HAS_X86_DISPATCH
+}
+
+SL_END_NAMESPACE
+
+#endif // SL_SIMD_LEVEL_HPP_INCLUDED
@@ -0,0 +1,97 @@
+//
+// Low overhead tick sources for timestamping on hot paths
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#ifndef TC_TICK_CLOCK_HPP_INCLUDED
+#define TC_TICK_CLOCK_HPP_INCLUDED
+
+// Configure namespace preference for the tick clocks.
+// By default namespace utl is used.
+#define TC_NAMESPACE_NAME utl
+
+// clang-format off
+#ifndef TC_BEGIN_NAMESPACE
+#define TC_BEGIN_NAMESPACE namespace TC_NAMESPACE_NAME {
+#endif // TC_BEGIN_NAMESPAC
+#ifndef TC_END_NAMESPACE
+#define TC_END_NAMESPACE }
+#endif // TC_END_NAMESPACE
+// clang-format on
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define TC_HAS_TSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define TC_HAS_TSC 1
+#endif
+
+#include <chrono>
+#include <cstdint>
+
+TC_BEGIN_NAMESPACE
+
+// A tick clock returns an unsigned 64 bit tick count from now() and converts
+// ticks into nanoseconds via nanosecondsPerTick(). Only differences between two
+// tick counts are meaningful.
+
+// Portable tick clock based on std::chrono::steady_clock
+struct SteadyTickClock
+{
+    [[nodiscard]] static std::uint64_t now() noexcept
+    {
+        return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    }
+
+    [[nodiscard]] static double nanosecondsPerTick() noexcept
+    {
+        using Period = std::chrono::steady_clock::period;
+        return 1e9 * static_cast<double>(Period::num) / static_cast<double>(Period::den);
+    }
+};
+
+#ifdef TC_HAS_TSC
+// Tick clock reading the time stamp counter. Requires an invariant TSC, which
+// is the norm on x86 processors of the last decade. The tick rate is calibrated
+// once against std::chrono::steady_clock on first use of nanosecondsPerTick().
+struct TscTickClock
+{
+    [[nodiscard]] static std::uint64_t now() noexcept
+    {
+        return __rdtsc();
+    }
+
+    [[nodiscard]] static double nanosecondsPerTick() noexcept
+    {
+        static double const nanoseconds = calibrate();
+        return nanoseconds;
+    }
+
+  private:
+    static double calibrate() noexcept
+    {
+        using namespace std::chrono;
+        auto const start = steady_clock::now();
+        auto const startTicks = now();
+        auto stop = start;
+        while ((stop = steady_clock::now()) - start < milliseconds{10})
+        {
+        }
+        auto const ticks = now() - startTicks;
+        return static_cast<double>(duration_cast<nanoseconds>(stop - start).count()) / static_cast<double>(ticks);
+    }
+};
+
+using DefaultTickClock = TscTickClock;
+#else  // TC_HAS_TSC
+using DefaultTickClock = SteadyTickClock;
+#endif // TC_HAS_TSC
+
+TC_END_NAMESPACE
+
+#endif // TC_TICK_CLOCK_HPP_INCLUDED
@@ -0,0 +1,273 @@
+//
+// Ring buffer of timestamped samples covering a time window
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#ifndef TM_TIME_WINDOW_HPP_INCLUDED
+#define TM_TIME_WINDOW_HPP_INCLUDED
+
+// Configure namespace preference for TimeWindow.
+// By default namespace utl is used.
+#define TM_NAMESPACE_NAME utl
+
+// clang-format off
+#ifndef TM_BEGIN_NAMESPACE
+#define TM_BEGIN_NAMESPACE namespace TM_NAMESPACE_NAME {
+#endif // TM_BEGIN_NAMESPAC
+#ifndef TM_END_NAMESPACE
+#define TM_END_NAMESPACE }
+#endif // TM_END_NAMESPACE
+// clang-format on
+
+#include "ring_buffer.hpp"
+#include "windowed_aggregate.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <type_traits>
+
+TM_BEGIN_NAMESPACE
+
+template<typename T>
+struct TimeWindowStatistics
+{
+    using sum_type = std::conditional_t<std::is_floating_point_v<T>, double, T>;
+
+    std::size_t count{};
+    sum_type sum{};
+    T min{}; // Meaningless if count is 0
+    T max{}; // Meaningless if count is 0
+
+    [[nodiscard]] double mean() const noexcept
+    {
+        return count == 0 ? 0.0 : static_cast<double>(sum) / static_cast<double>(count);
+    }
+};
+
+// Samples of the last window ticks, at most N of them, with their count, sum,
+// minimum and maximum maintained as samples enter and leave the window:
+//
+//   TimeWindow<double, 65536> trades{5 * ticksPerSecond};
+//   trades.push(now, price);
+//   ...
+//   auto const last5s = trades.statistics(now);
+//
+// A sample pushed at time t belongs to the window until now - window reaches
+// t. Samples are evicted when newer ones are pushed and by expire() or
+// statistics(now); if N samples are in the window, push() evicts the oldest
+// one regardless of its age. Time must not go backwards, samples with an
+// earlier time than the newest one are treated as if pushed at that time.
+//
+// Expired samples are found by exponential and binary search on the contiguous
+// segments of the ring buffer and removed in one step, so expiring many samples
+// at once does not pay the per element overhead of pop().
+template<typename T, std::size_t N>
+class TimeWindow
+{
+  public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using time_type = std::uint64_t;
+    using statistics_type = TimeWindowStatistics<T>;
+
+    struct Sample
+    {
+        time_type time;
+        T value;
+    };
+
+    using ring_buffer_type = ::RB_NAMESPACE_NAME::RingBuffer<Sample, N>;
+
+    static_assert(std::is_trivially_destructible_v<T>, "TimeWindow requires trivially destructible values");
+
+    explicit TimeWindow(time_type window) noexcept
+        : window_{window}
+    {
+    }
+
+    TimeWindow(TimeWindow&&) = delete;
+    TimeWindow(TimeWindow const&) = delete;
+    TimeWindow& operator=(TimeWindow&&) = delete;
+    TimeWindow& operator=(TimeWindow const&) = delete;
+
+    void push(time_type time, T const& value)
+    {
+        if (!samples_.empty())
+        {
+            time = std::max(time, samples_.back().time);
+        }
+        expire(time);
+        if (samples_.full())
+        {
+            evict(1);
+        }
+        samples_.push(Sample{time, value});
+        add(value);
+        minimum_.push(value, pushed_);
+        maximum_.push(value, pushed_);
+        ++pushed_;
+    }
+
+    // Evicts all samples which are out of the window at time now
+    void expire(time_type now) noexcept
+    {
+        if (now >= window_ && !samples_.empty() && samples_.front().time <= now - window_)
+        {
+            evict(expiredAt(now - window_));
+        }
+    }
+
+    // Statistics of the window at time now
+    [[nodiscard]] statistics_type statistics(time_type now) noexcept
+    {
+        expire(now);
+        return statistics();
+    }
+
+    // Statistics of the window as of the last push() or expire()
+    [[nodiscard]] statistics_type statistics() const noexcept
+    {
+        statistics_type statistics;
+        statistics.count = samples_.size();
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            statistics.sum = sum_.value();
+        }
+        else
+        {
+            statistics.sum = sum_;
+        }
+        if (!samples_.empty())
+        {
+            statistics.min = minimum_.front();
+            statistics.max = maximum_.front();
+        }
+        return statistics;
+    }
+
+    void clear() noexcept
+    {
+        samples_.clear();
+        sum_ = {};
+        minimum_.clear();
+        maximum_.clear();
+    }
+
+    // The samples of the window, oldest first
+    [[nodiscard]] ring_buffer_type const& samples() const noexcept
+    {
+        return samples_;
+    }
+
+    [[nodiscard]] time_type window() const noexcept
+    {
+        return window_;
+    }
+
+    [[nodiscard]] size_type size() const noexcept
+    {
+        return samples_.size();
+    }
+
+    [[nodiscard]] size_type capacity() const noexcept
+    {
+        return N;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return samples_.empty();
+    }
+
+  private:
+    using sum_type = std::conditional_t<std::is_floating_point_v<T>, ::WA_NAMESPACE_NAME::detail::CompensatedSum, T>;
+
+    ring_buffer_type samples_;
+    time_type window_;
+    std::uint64_t pushed_{}; // Sequence number of the next sample
+    sum_type sum_{};
+    ::WA_NAMESPACE_NAME::detail::MonotonicQueue<T, N, std::less<T>> minimum_;
+    ::WA_NAMESPACE_NAME::detail::MonotonicQueue<T, N, std::greater<T>> maximum_;
+
+    // Number of samples at the front with a time up to cutoff
+    size_type expiredAt(time_type cutoff) const noexcept
+    {
+        auto const one = samples_.array_one();
+        auto const expired = expiredIn(one, cutoff);
+        if (expired != one.size())
+        {
+            return expired;
+        }
+        return expired + expiredIn(samples_.array_two(), cutoff);
+    }
+
+    // Exponential search followed by a binary search, which costs O(log k)
+    // for k expired samples. Usually only a few samples expire at a time.
+    static size_type expiredIn(std::span<Sample const> samples, time_type cutoff) noexcept
+    {
+        size_type bound = 1;
+        while (bound <= samples.size() && samples[bound - 1].time <= cutoff)
+        {
+            bound *= 2;
+        }
+        auto const first = samples.begin() + static_cast<std::ptrdiff_t>(bound / 2);
+        auto const last = samples.begin() + static_cast<std::ptrdiff_t>(std::min(bound, samples.size()));
+        auto const later = [](time_type cutoff, Sample const& sample) { return cutoff < sample.time; };
+        return static_cast<size_type>(std::upper_bound(first, last, cutoff, later) - samples.begin());
+    }
+
+    // Removes the count oldest samples
+    void evict(size_type count) noexcept
+    {
+        if (count == samples_.size())
+        {
+            clear();
+            return;
+        }
+        auto const one = samples_.array_one();
+        auto const first = std::min(count, one.size());
+        auto removed = sum(one.first(first));
+        if (count > first)
+        {
+            removed += sum(samples_.array_two().first(count - first));
+        }
+        add(-removed);
+        auto const oldest = pushed_ - samples_.size() + count;
+        minimum_.evict(oldest);
+        maximum_.evict(oldest);
+        samples_.pop(count);
+    }
+
+    static auto sum(std::span<Sample const> samples) noexcept
+    {
+        std::conditional_t<std::is_floating_point_v<T>, double, T> result{};
+        for (auto const& sample : samples)
+        {
+            result += sample.value;
+        }
+        return result;
+    }
+
+    template<typename U>
+    void add(U value) noexcept
+    {
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            sum_.add(static_cast<double>(value));
+        }
+        else
+        {
+            sum_ += value;
+        }
+    }
+};
+
+TM_END_NAMESPACE
+
+#endif // TM_TIME_WINDOW_HPP_INCLUDED
@@ -0,0 +1,450 @@
+//
+// Hierarchical timing wheel
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#ifndef TW_TIMING_WHEEL_HPP_INCLUDED
+#define TW_TIMING_WHEEL_HPP_INCLUDED
+
+// Configure namespace preference for TimingWheel.
+// By default namespace utl is used.
+#define TW_NAMESPACE_NAME utl
+
+// clang-format off
+#ifndef TW_BEGIN_NAMESPACE
+#define TW_BEGIN_NAMESPACE namespace TW_NAMESPACE_NAME {
+#endif // TW_BEGIN_NAMESPAC
+#ifndef TW_END_NAMESPACE
+#define TW_END_NAMESPACE }
+#endif // TW_END_NAMESPACE
+// clang-format on
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+TW_BEGIN_NAMESPACE
+
+// Identifies a scheduled timer. Stays unique when the timer's node is reused.
+class TimerId
+{
+  public:
+    TimerId() noexcept = default;
+
+    [[nodiscard]] explicit operator bool() const noexcept
+    {
+        return generation_ != 0;
+    }
+
+    [[nodiscard]] bool operator==(TimerId const&) const noexcept = default;
+
+  private:
+    template<typename T, std::size_t Capacity, std::size_t Levels, std::size_t SlotBits>
+    friend class TimingWheel;
+
+    std::uint32_t index_{};
+    std::uint32_t generation_{};
+
+    TimerId(std::uint32_t index, std::uint32_t generation) noexcept
+        : index_{index}
+        , generation_{generation}
+    {
+    }
+};
+
+// Up to Capacity timers, each carrying a value of type T, which expire at a
+// deadline given in ticks of an arbitrary clock (e.g. DefaultTickClock or
+// nanoseconds since the epoch). schedule() and cancel() are O(1), tick(now)
+// calls fn(T&) for all timers with a deadline up to now:
+//
+//   auto timeouts = std::make_unique<TimingWheel<OrderId, 1 << 20>>(now);
+//   auto id = timeouts->schedule(now + timeout, orderId);
+//   ...
+//   timeouts->cancel(id); // Order filled in time
+//   ...
+//   timeouts->tick(now, [](OrderId& orderId) { expire(orderId); });
+//
+// Timers live in Levels wheels of 2^SlotBits buckets each; the bucket of a
+// timer is indexed by SlotBits bits of its deadline like RingBuffer indexes
+// slots. Level l holds timers whose deadline differs from the current time in
+// bits l * SlotBits to (l + 1) * SlotBits - 1 at most. When the current time
+// crosses a level l boundary, the timers of the bucket reached are moved to
+// lower levels, hence each timer is touched at most Levels times before it
+// fires. Timers beyond the range of all levels, 2^(Levels * SlotBits) ticks,
+// wait in an overflow list. Empty buckets are skipped
+// by means of per level occupancy bitmaps, so tick() costs no more than the
+// number of buckets holding timers, regardless of the time elapsed.
+//
+// Timer nodes are kept in an intrusive pool inline, there are no allocations
+// after construction.
+template<typename T, std::size_t Capacity, std::size_t Levels = 5, std::size_t SlotBits = 8>
+class TimingWheel
+{
+  public:
+    static_assert(Capacity > 0, "Template argument Capacity must not be zero");
+    static_assert(Capacity < std::numeric_limits<std::uint32_t>::max(), "Template argument Capacity is too large");
+    static_assert(Levels > 0, "Template argument Levels must not be zero");
+    static_assert(SlotBits > 0 && Levels * SlotBits < 64, "Levels * SlotBits must be less than 64");
+
+    using value_type = T;
+    using size_type = std::size_t;
+    using time_type = std::uint64_t;
+
+    static constexpr std::size_t slotBits = SlotBits;
+    static constexpr std::size_t slots = std::size_t{1} << slotBits;
+
+    explicit TimingWheel(time_type now = 0) noexcept
+        : now_{now}
+    {
+        std::fill(std::begin(heads_), std::end(heads_), npos);
+    }
+
+    TimingWheel(TimingWheel&&) = delete;
+    TimingWheel(TimingWheel const&) = delete;
+    TimingWheel& operator=(TimingWheel&&) = delete;
+    TimingWheel& operator=(TimingWheel const&) = delete;
+
+    ~TimingWheel() noexcept
+    {
+        for (std::uint32_t index = 0; index < fresh_; ++index)
+        {
+            if (nodes_[index].bucket != npos)
+            {
+                std::destroy_at(objectAt(index));
+            }
+        }
+    }
+
+    // Schedules a timer carrying a T constructed from args. A deadline which
+    // has passed already fires on the next tick. Returns an empty TimerId if
+    // Capacity timers are scheduled.
+    template<typename... Args>
+    TimerId schedule(time_type deadline, Args&&... args)
+    {
+        auto const index = allocate();
+        if (index == npos)
+        {
+            return {};
+        }
+        try
+        {
+            std::construct_at(static_cast<T*>(storageAt(index)), std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            deallocate(index);
+            throw;
+        }
+        nodes_[index].deadline = deadline;
+        insert(index, now_ + 1);
+        ++size_;
+        return {index, nodes_[index].generation};
+    }
+
+    // Removes a timer without firing it. Returns false if it has fired or
+    // has been cancelled already.
+    bool cancel(TimerId id) noexcept
+    {
+        if (!id || id.index_ >= fresh_ || nodes_[id.index_].generation != id.generation_ ||
+            nodes_[id.index_].bucket == npos)
+        {
+            return false;
+        }
+        unlink(id.index_);
+        release(id.index_);
+        return true;
+    }
+
+    // Advances the current time to now and calls fn(T&) for every timer with
+    // a deadline up to now, in order of deadlines. fn may schedule and cancel
+    // timers. Returns the number of timers fired.
+    template<typename Fn>
+    std::size_t tick(time_type now, Fn&& fn)
+    {
+        std::size_t fired = 0;
+        while (now_ < now)
+        {
+            auto const next = nextEvent();
+            if (next > now)
+            {
+                now_ = now;
+                break;
+            }
+            now_ = next;
+            if ((next & (rangeOf(Levels) - 1)) == 0)
+            {
+                cascade(overflowBucket, next);
+            }
+            for (auto level = Levels - 1; level > 0; --level)
+            {
+                if ((next & (rangeOf(level) - 1)) == 0)
+                {
+                    cascade(bucketOf(level, next), next);
+                }
+            }
+            fired += fire(bucketOf(0, next), fn);
+        }
+        return fired;
+    }
+
+    // The time passed to the constructor or the last tick()
+    [[nodiscard]] time_type now() const noexcept
+    {
+        return now_;
+    }
+
+    [[nodiscard]] size_type size() const noexcept
+    {
+        return size_;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    [[nodiscard]] size_type capacity() const noexcept
+    {
+        return Capacity;
+    }
+
+  private:
+    static constexpr std::uint32_t npos = std::numeric_limits<std::uint32_t>::max();
+    static constexpr std::uint32_t overflowBucket = Levels * slots;
+    static constexpr std::uint32_t firingBucket = overflowBucket + 1;
+    static constexpr time_type never = std::numeric_limits<time_type>::max();
+
+    struct Node
+    {
+        time_type deadline;
+        std::uint32_t prev;
+        std::uint32_t next;
+        std::uint32_t generation;
+        std::uint32_t bucket; // npos if the node is free
+        std::aligned_storage_t<sizeof(T), alignof(T)> storage;
+    };
+
+    time_type now_;
+    std::size_t size_{};
+    std::uint32_t freeHead_{npos};
+    std::uint32_t fresh_{}; // Nodes from fresh_ on have never been used
+    std::uint64_t occupied_[(Levels * slots + 63) / 64]{}; // One bit per bucket
+    std::uint32_t heads_[firingBucket + 1];
+    Node nodes_[Capacity];
+
+    static constexpr time_type rangeOf(std::size_t level) noexcept
+    {
+        return time_type{1} << (slotBits * level);
+    }
+
+    static constexpr std::uint32_t bucketOf(std::size_t level, time_type time) noexcept
+    {
+        return static_cast<std::uint32_t>(level * slots + ((time >> (slotBits * level)) & (slots - 1)));
+    }
+
+    T* objectAt(std::uint32_t index) noexcept
+    {
+        return std::launder(static_cast<T*>(static_cast<void*>(&nodes_[index].storage)));
+    }
+
+    void* storageAt(std::uint32_t index) noexcept
+    {
+        return static_cast<void*>(&nodes_[index].storage);
+    }
+
+    std::uint32_t allocate() noexcept
+    {
+        if (freeHead_ != npos)
+        {
+            return std::exchange(freeHead_, nodes_[freeHead_].next);
+        }
+        if (fresh_ == Capacity)
+        {
+            return npos;
+        }
+        nodes_[fresh_].generation = 1;
+        return fresh_++;
+    }
+
+    void deallocate(std::uint32_t index) noexcept
+    {
+        auto& node = nodes_[index];
+        node.bucket = npos;
+        node.generation = node.generation == std::numeric_limits<std::uint32_t>::max() ? 1 : node.generation + 1;
+        node.next = std::exchange(freeHead_, index);
+    }
+
+    // Destroys the value of an unlinked timer and returns its node
+    void release(std::uint32_t index) noexcept
+    {
+        std::destroy_at(objectAt(index));
+        deallocate(index);
+        --size_;
+    }
+
+    void link(std::uint32_t index, std::uint32_t bucket) noexcept
+    {
+        auto& node = nodes_[index];
+        node.bucket = bucket;
+        node.prev = npos;
+        node.next = heads_[bucket];
+        if (node.next != npos)
+        {
+            nodes_[node.next].prev = index;
+        }
+        heads_[bucket] = index;
+    }
+
+    void unlink(std::uint32_t index) noexcept
+    {
+        auto const& node = nodes_[index];
+        if (node.prev != npos)
+        {
+            nodes_[node.prev].next = node.next;
+        }
+        else
+        {
+            heads_[node.bucket] = node.next;
+            if (node.next == npos)
+            {
+                markEmpty(node.bucket);
+            }
+        }
+        if (node.next != npos)
+        {
+            nodes_[node.next].prev = node.prev;
+        }
+    }
+
+    // Puts a timer into the bucket of the lowest level which covers its
+    // deadline. Timers due before earliest are put into the bucket of earliest.
+    void insert(std::uint32_t index, time_type earliest) noexcept
+    {
+        auto const deadline = std::max(nodes_[index].deadline, earliest);
+        auto const difference = deadline ^ now_;
+        if (difference >= rangeOf(Levels))
+        {
+            link(index, overflowBucket);
+            return;
+        }
+        auto const level = difference < slots ? 0 : static_cast<std::size_t>(std::bit_width(difference) - 1) / slotBits;
+        auto const bucket = bucketOf(level, deadline);
+        occupied_[bucket / 64] |= std::uint64_t{1} << (bucket % 64);
+        link(index, bucket);
+    }
+
+    // Moves all timers of a bucket to where they belong relative to now_
+    void cascade(std::uint32_t bucket, time_type earliest) noexcept
+    {
+        auto index = std::exchange(heads_[bucket], npos);
+        markEmpty(bucket);
+        while (index != npos)
+        {
+            auto const next = nodes_[index].next;
+#if defined(__GNUC__)
+            // Overlap the cache miss on the next node with inserting this one
+            if (next != npos)
+            {
+                __builtin_prefetch(&nodes_[next]);
+            }
+#endif // __GNUC__
+            insert(index, earliest);
+            index = next;
+        }
+    }
+
+    // The earliest time at which a non-empty bucket is reached
+    time_type nextEvent() const noexcept
+    {
+        if (size_ == 0)
+        {
+            return never;
+        }
+        for (std::size_t level = 0; level < Levels; ++level)
+        {
+            auto const current = (now_ >> (slotBits * level)) & (slots - 1);
+            if (auto const digit = nextOccupied(level, current + 1); digit != slots)
+            {
+                // Buckets of lower levels are reached earlier than any of a higher level
+                auto const base = now_ & ~(rangeOf(level + 1) - 1);
+                return base | (static_cast<time_type>(digit) << (slotBits * level));
+            }
+        }
+        if (heads_[overflowBucket] != npos)
+        {
+            return (now_ & ~(rangeOf(Levels) - 1)) + rangeOf(Levels);
+        }
+        return never;
+    }
+
+    void markEmpty(std::uint32_t bucket) noexcept
+    {
+        if (bucket < overflowBucket)
+        {
+            occupied_[bucket / 64] &= ~(std::uint64_t{1} << (bucket % 64));
+        }
+    }
+
+    // The first occupied bucket of a level from digit on, slots if there is none
+    std::size_t nextOccupied(std::size_t level, std::size_t digit) const noexcept
+    {
+        auto bit = level * slots + digit;
+        auto const end = (level + 1) * slots;
+        while (bit < end)
+        {
+            auto const word = occupied_[bit / 64] >> (bit % 64);
+            if (word != 0)
+            {
+                bit += static_cast<std::size_t>(std::countr_zero(word));
+                return bit < end ? bit - level * slots : slots;
+            }
+            bit = (bit / 64 + 1) * 64;
+        }
+        return slots;
+    }
+
+    template<typename Fn>
+    std::size_t fire(std::uint32_t bucket, Fn& fn)
+    {
+        // Detach the bucket first, fn may schedule into it again
+        auto index = std::exchange(heads_[bucket], npos);
+        markEmpty(bucket);
+        while (index != npos)
+        {
+            auto const next = nodes_[index].next;
+            link(index, firingBucket);
+            index = next;
+        }
+
+        std::size_t fired = 0;
+        while ((index = heads_[firingBucket]) != npos)
+        {
+            unlink(index);
+            try
+            {
+                fn(*objectAt(index));
+            }
+            catch (...)
+            {
+                release(index);
+                cascade(firingBucket, now_ + 1);
+                throw;
+            }
+            release(index);
+            ++fired;
+        }
+        return fired;
+    }
+};
+
+TW_END_NAMESPACE
+
+#endif // TW_TIMING_WHEEL_HPP_INCLUDED
@@ -24,6 +24,7 @@
 // clang-format on
 
 #include <memory_resource>
+#include <utility>
 #include <bit>
 
 UB_BEGIN_NAMESPACE
@@ -121,7 +122,7 @@ class UniqueBuffer
     {
         if (memres_ != nullptr)
         {
-            memres_->deallocate(buffer_, alignment_);
+            memres_->deallocate(buffer_, size_, alignment_);
         }
     }
 };
@@ -0,0 +1,487 @@
+//
+// Incrementally maintained aggregates over a sliding window of a RingBuffer
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#ifndef WA_WINDOWED_AGGREGATE_HPP_INCLUDED
+#define WA_WINDOWED_AGGREGATE_HPP_INCLUDED
+
+// Configure namespace preference for WindowedAggregate.
+// By default namespace utl is used.
+#define WA_NAMESPACE_NAME utl
+
+// clang-format off
+#ifndef WA_BEGIN_NAMESPACE
+#define WA_BEGIN_NAMESPACE namespace WA_NAMESPACE_NAME {
+#endif // WA_BEGIN_NAMESPAC
+#ifndef WA_END_NAMESPACE
+#define WA_END_NAMESPACE }
+#endif // WA_END_NAMESPACE
+// clang-format on
+
+#include "ring_buffer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <tuple>
+#include <type_traits>
+
+WA_BEGIN_NAMESPACE
+
+// Aggregates maintained by WindowedAggregate. Each aggregate is notified of
+// every element entering and leaving the window:
+//
+//   void push(T const& value, std::uint64_t sequence, std::size_t count);
+//   void pop(T const& value, std::uint64_t sequence, std::size_t count);
+//   result_type value(std::size_t count) const;
+//   void clear();
+//
+// sequence numbers the elements pushed, count is the size of the window after
+// the element entered or left. All operations are O(1) amortized.
+
+namespace detail
+{
+    // Kahan-Babuska (Neumaier) compensated sum. Unlike Kahan's original
+    // algorithm it stays exact when a term is larger than the running sum,
+    // which happens regularly when elements leave the window.
+    class CompensatedSum
+    {
+      public:
+        void add(double value) noexcept
+        {
+            auto const sum = sum_ + value;
+            if (std::abs(sum_) >= std::abs(value))
+            {
+                compensation_ += (sum_ - sum) + value;
+            }
+            else
+            {
+                compensation_ += (value - sum) + sum_;
+            }
+            sum_ = sum;
+        }
+
+        [[nodiscard]] double value() const noexcept
+        {
+            return sum_ + compensation_;
+        }
+
+        void clear() noexcept
+        {
+            sum_ = compensation_ = 0.0;
+        }
+
+      private:
+        double sum_{};
+        double compensation_{};
+    };
+
+    // Queue of window elements in monotonic order of Compare. The front is the
+    // extreme of the window, elements which can never become the extreme are
+    // dropped from the back on push.
+    template<typename T, std::size_t N, typename Compare>
+    class MonotonicQueue
+    {
+      public:
+        void push(T const& value, std::uint64_t sequence) noexcept(std::is_nothrow_copy_assignable_v<T>)
+        {
+            while (size_ != 0 && !Compare{}(entries_[(head_ + size_ - 1) % N].value, value))
+            {
+                --size_;
+            }
+            auto& entry = entries_[(head_ + size_) % N];
+            entry.value = value;
+            entry.sequence = sequence;
+            ++size_;
+        }
+
+        void pop(std::uint64_t sequence) noexcept
+        {
+            if (size_ != 0 && entries_[head_].sequence == sequence)
+            {
+                head_ = (head_ + 1) % N;
+                --size_;
+            }
+        }
+
+        // Removes all elements numbered below sequence
+        void evict(std::uint64_t sequence) noexcept
+        {
+            while (size_ != 0 && entries_[head_].sequence < sequence)
+            {
+                head_ = (head_ + 1) % N;
+                --size_;
+            }
+        }
+
+        [[nodiscard]] T const& front() const noexcept
+        {
+            return entries_[head_].value;
+        }
+
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return size_ == 0;
+        }
+
+        void clear() noexcept
+        {
+            head_ = size_ = 0;
+        }
+
+      private:
+        struct Entry
+        {
+            T value;
+            std::uint64_t sequence;
+        };
+
+        std::size_t head_{};
+        std::size_t size_{};
+        Entry entries_[N]{};
+    };
+} // namespace detail
+
+// Sum of the window. Floating point sums are compensated, so adding and
+// removing elements does not accumulate rounding errors.
+template<typename T, std::size_t N>
+class WindowSum
+{
+  public:
+    using result_type = std::conditional_t<std::is_floating_point_v<T>, double, T>;
+
+    void push(T const& value, std::uint64_t, std::size_t) noexcept
+    {
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            sum_.add(static_cast<double>(value));
+        }
+        else
+        {
+            sum_ += value;
+        }
+    }
+
+    void pop(T const& value, std::uint64_t, std::size_t count) noexcept
+    {
+        if (count == 0)
+        {
+            clear();
+        }
+        else if constexpr (std::is_floating_point_v<T>)
+        {
+            sum_.add(-static_cast<double>(value));
+        }
+        else
+        {
+            sum_ -= value;
+        }
+    }
+
+    [[nodiscard]] result_type value(std::size_t) const noexcept
+    {
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            return sum_.value();
+        }
+        else
+        {
+            return sum_;
+        }
+    }
+
+    void clear() noexcept
+    {
+        sum_ = {};
+    }
+
+  private:
+    std::conditional_t<std::is_floating_point_v<T>, detail::CompensatedSum, T> sum_{};
+};
+
+// Arithmetic mean of the window, 0 if the window is empty
+template<typename T, std::size_t N>
+class WindowMean
+{
+  public:
+    using result_type = double;
+
+    void push(T const& value, std::uint64_t, std::size_t) noexcept
+    {
+        sum_.add(static_cast<double>(value));
+    }
+
+    void pop(T const& value, std::uint64_t, std::size_t count) noexcept
+    {
+        if (count == 0)
+        {
+            clear();
+        }
+        else
+        {
+            sum_.add(-static_cast<double>(value));
+        }
+    }
+
+    [[nodiscard]] result_type value(std::size_t count) const noexcept
+    {
+        return count == 0 ? 0.0 : sum_.value() / static_cast<double>(count);
+    }
+
+    void clear() noexcept
+    {
+        sum_.clear();
+    }
+
+  private:
+    detail::CompensatedSum sum_;
+};
+
+// Population variance of the window by Welford's algorithm, extended to
+// remove elements. 0 if the window is empty.
+template<typename T, std::size_t N>
+class WindowVariance
+{
+  public:
+    using result_type = double;
+
+    void push(T const& value, std::uint64_t, std::size_t count) noexcept
+    {
+        auto const x = static_cast<double>(value);
+        auto const delta = x - mean_;
+        mean_ += delta / static_cast<double>(count);
+        m2_ += delta * (x - mean_);
+    }
+
+    void pop(T const& value, std::uint64_t, std::size_t count) noexcept
+    {
+        if (count == 0)
+        {
+            clear();
+            return;
+        }
+        auto const x = static_cast<double>(value);
+        auto const delta = x - mean_;
+        mean_ -= delta / static_cast<double>(count);
+        m2_ = std::max(0.0, m2_ - delta * (x - mean_));
+    }
+
+    [[nodiscard]] result_type value(std::size_t count) const noexcept
+    {
+        return count == 0 ? 0.0 : m2_ / static_cast<double>(count);
+    }
+
+    // Unbiased estimate of the variance of the population sampled
+    [[nodiscard]] double sampleVariance(std::size_t count) const noexcept
+    {
+        return count < 2 ? 0.0 : m2_ / static_cast<double>(count - 1);
+    }
+
+    void clear() noexcept
+    {
+        mean_ = m2_ = 0.0;
+    }
+
+  private:
+    double mean_{};
+    double m2_{}; // Sum of squared differences from the mean
+};
+
+// Minimum of the window, the window must not be empty
+template<typename T, std::size_t N>
+class WindowMin
+{
+  public:
+    using result_type = T;
+
+    void push(T const& value, std::uint64_t sequence, std::size_t)
+    {
+        queue_.push(value, sequence);
+    }
+
+    void pop(T const&, std::uint64_t sequence, std::size_t) noexcept
+    {
+        queue_.pop(sequence);
+    }
+
+    [[nodiscard]] result_type value(std::size_t) const
+    {
+        return queue_.front();
+    }
+
+    void clear() noexcept
+    {
+        queue_.clear();
+    }
+
+  private:
+    detail::MonotonicQueue<T, N, std::less<T>> queue_;
+};
+
+// Maximum of the window, the window must not be empty
+template<typename T, std::size_t N>
+class WindowMax
+{
+  public:
+    using result_type = T;
+
+    void push(T const& value, std::uint64_t sequence, std::size_t)
+    {
+        queue_.push(value, sequence);
+    }
+
+    void pop(T const&, std::uint64_t sequence, std::size_t) noexcept
+    {
+        queue_.pop(sequence);
+    }
+
+    [[nodiscard]] result_type value(std::size_t) const
+    {
+        return queue_.front();
+    }
+
+    void clear() noexcept
+    {
+        queue_.clear();
+    }
+
+  private:
+    detail::MonotonicQueue<T, N, std::greater<T>> queue_;
+};
+
+// RingBuffer of the last window() elements pushed, which maintains aggregates
+// of the window as elements enter and leave it instead of iterating the ring
+// buffer on every query:
+//
+//   WindowedAggregate<double, 1024, WindowMean, WindowVariance, WindowMax> latency;
+//   latency.push(sample);
+//   auto const mean = latency.value<WindowMean>();
+//   auto const stddev = std::sqrt(latency.value<WindowVariance>());
+//
+// When the window is full, push() evicts the oldest element, like
+// RingBuffer::emplace() overwrites it. The window length can be reduced below
+// N at runtime with window(n) and elements can be evicted explicitly with pop(),
+// e.g. to keep a window by other criteria than the number of elements.
+template<typename T, std::size_t N, template<typename, std::size_t> class... Ops>
+class WindowedAggregate
+{
+  public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using const_reference = T const&;
+    using ring_buffer_type = ::RB_NAMESPACE_NAME::RingBuffer<T, N>;
+
+    WindowedAggregate() = default;
+    WindowedAggregate(WindowedAggregate&&) = delete;
+    WindowedAggregate(WindowedAggregate const&) = delete;
+    WindowedAggregate& operator=(WindowedAggregate&&) = delete;
+    WindowedAggregate& operator=(WindowedAggregate const&) = delete;
+
+    // Adds value to the window, evicting the oldest element if the window is full
+    void push(T const& value)
+    {
+        if (size() == window_)
+        {
+            pop();
+        }
+        samples_.push(value);
+        auto const sequence = pushed_++;
+        std::apply([&](auto&... ops) { (ops.push(value, sequence, size()), ...); }, ops_);
+    }
+
+    // Evicts the oldest element, the window must not be empty
+    void pop() noexcept
+    {
+        auto const sequence = pushed_ - size();
+        auto const& value = samples_.front();
+        std::apply([&](auto&... ops) { (ops.pop(value, sequence, size() - 1), ...); }, ops_);
+        samples_.pop();
+    }
+
+    void clear() noexcept
+    {
+        samples_.clear();
+        std::apply([](auto&... ops) { (ops.clear(), ...); }, ops_);
+    }
+
+    // The aggregate Op of the current window
+    template<template<typename, std::size_t> class Op>
+    [[nodiscard]] auto value() const
+    {
+        return aggregate<Op>().value(size());
+    }
+
+    template<template<typename, std::size_t> class Op>
+    [[nodiscard]] Op<T, N> const& aggregate() const noexcept
+    {
+        return std::get<Op<T, N>>(ops_);
+    }
+
+    // Sets the maximum number of elements in the window, at most N. Evicts
+    // the oldest elements if the window holds more.
+    void window(size_type length) noexcept
+    {
+        window_ = std::clamp(length, size_type{1}, N);
+        while (size() > window_)
+        {
+            pop();
+        }
+    }
+
+    [[nodiscard]] size_type window() const noexcept
+    {
+        return window_;
+    }
+
+    // The elements of the window, oldest first
+    [[nodiscard]] ring_buffer_type const& samples() const noexcept
+    {
+        return samples_;
+    }
+
+    [[nodiscard]] const_reference front() const noexcept
+    {
+        return samples_.front();
+    }
+
+    [[nodiscard]] const_reference back() const noexcept
+    {
+        return samples_.back();
+    }
+
+    [[nodiscard]] size_type size() const noexcept
+    {
+        return samples_.size();
+    }
+
+    [[nodiscard]] size_type capacity() const noexcept
+    {
+        return N;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return samples_.empty();
+    }
+
+    [[nodiscard]] bool full() const noexcept
+    {
+        return size() == window_;
+    }
+
+  private:
+    ring_buffer_type samples_;
+    std::tuple<Ops<T, N>...> ops_;
+    std::uint64_t pushed_{};
+    size_type window_{N};
+};
+
+WA_END_NAMESPACE
+
+#endif // WA_WINDOWED_AGGREGATE_HPP_INCLUDED
@@ -0,0 +1,313 @@
+//
+// Rolling quantiles over a sliding window of a RingBuffer
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#ifndef WQ_WINDOWED_QUANTILE_HPP_INCLUDED
+#define WQ_WINDOWED_QUANTILE_HPP_INCLUDED
+
+// Configure namespace preference for WindowedQuantile.
+// By default namespace utl is used.
+#define WQ_NAMESPACE_NAME utl
+
+// clang-format off
+#ifndef WQ_BEGIN_NAMESPACE
+#define WQ_BEGIN_NAMESPACE namespace WQ_NAMESPACE_NAME {
+#endif // WQ_BEGIN_NAMESPAC
+#ifndef WQ_END_NAMESPACE
+#define WQ_END_NAMESPACE }
+#endif // WQ_END_NAMESPACE
+// clang-format on
+
+#include "ring_buffer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+WQ_BEGIN_NAMESPACE
+
+// The last window() samples pushed, at most N, with any quantile of them
+// available in O(log N):
+//
+//   auto latency = std::make_unique<WindowedQuantile<std::uint32_t, 65536>>();
+//   latency->push(sample);
+//   auto const median = latency->median();
+//   auto const p95 = latency->quantile(0.95);
+//
+// The RingBuffer decides which sample leaves the window, an order statistic
+// tree (a treap whose nodes know the size of their subtree) keeps the samples
+// sorted. Samples are keyed by value and sequence number, so equal values are
+// told apart on eviction. Inserting and evicting cost O(log N) expected, as
+// does a quantile query. The nodes live in inline storage, node i holds the
+// sample with a sequence number congruent to i modulo N.
+template<typename T, std::size_t N>
+class WindowedQuantile
+{
+  public:
+    static_assert(N > 0, "Template argument N must not be zero");
+    static_assert(N < std::numeric_limits<std::uint32_t>::max(), "Template argument N is too large");
+    static_assert(std::is_trivially_copyable_v<T>, "WindowedQuantile requires trivially copyable samples");
+
+    using value_type = T;
+    using size_type = std::size_t;
+    using const_reference = T const&;
+    using ring_buffer_type = ::RB_NAMESPACE_NAME::RingBuffer<T, N>;
+
+    WindowedQuantile() = default;
+    WindowedQuantile(WindowedQuantile&&) = delete;
+    WindowedQuantile(WindowedQuantile const&) = delete;
+    WindowedQuantile& operator=(WindowedQuantile&&) = delete;
+    WindowedQuantile& operator=(WindowedQuantile const&) = delete;
+
+    // Adds value to the window, evicting the oldest sample if the window is full
+    void push(T const& value) noexcept
+    {
+        if (size() == window_)
+        {
+            pop();
+        }
+        auto const index = static_cast<std::uint32_t>(pushed_ % N);
+        auto& node = nodes_[index];
+        node.value = value;
+        node.sequence = pushed_++;
+        node.left = node.right = npos;
+        node.size = 1;
+        node.priority = random();
+        root_ = insert(root_, index);
+        samples_.push(value);
+    }
+
+    // Evicts the oldest sample, the window must not be empty
+    void pop() noexcept
+    {
+        auto const sequence = pushed_ - size();
+        root_ = erase(root_, samples_.front(), sequence);
+        samples_.pop();
+    }
+
+    void clear() noexcept
+    {
+        samples_.clear();
+        root_ = npos;
+    }
+
+    // The rank-th smallest sample starting at 0, rank must be less than size()
+    [[nodiscard]] const_reference nth(size_type rank) const noexcept
+    {
+        auto index = root_;
+        for (;;)
+        {
+            auto const& node = nodes_[index];
+            auto const left = sizeOf(node.left);
+            if (rank < left)
+            {
+                index = node.left;
+            }
+            else if (rank == left)
+            {
+                return node.value;
+            }
+            else
+            {
+                rank -= left + 1;
+                index = node.right;
+            }
+        }
+    }
+
+    // Quantile q in [0, 1] by the nearest rank method: the smallest sample
+    // which is not less than q * size() samples. The window must not be empty.
+    [[nodiscard]] const_reference quantile(double q) const noexcept
+    {
+        auto const rank = static_cast<size_type>(std::ceil(std::clamp(q, 0.0, 1.0) * static_cast<double>(size())));
+        return nth(rank == 0 ? 0 : rank - 1);
+    }
+
+    // Lower median of the window, the window must not be empty
+    [[nodiscard]] const_reference median() const noexcept
+    {
+        return quantile(0.5);
+    }
+
+    // Sets the maximum number of samples in the window, at most N. Evicts
+    // the oldest samples if the window holds more.
+    void window(size_type length) noexcept
+    {
+        window_ = std::clamp(length, size_type{1}, N);
+        while (size() > window_)
+        {
+            pop();
+        }
+    }
+
+    [[nodiscard]] size_type window() const noexcept
+    {
+        return window_;
+    }
+
+    // The samples of the window, oldest first
+    [[nodiscard]] ring_buffer_type const& samples() const noexcept
+    {
+        return samples_;
+    }
+
+    [[nodiscard]] size_type size() const noexcept
+    {
+        return samples_.size();
+    }
+
+    [[nodiscard]] size_type capacity() const noexcept
+    {
+        return N;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return samples_.empty();
+    }
+
+  private:
+    static constexpr std::uint32_t npos = std::numeric_limits<std::uint32_t>::max();
+
+    struct Node
+    {
+        T value;
+        std::uint64_t sequence;
+        std::uint32_t left;
+        std::uint32_t right;
+        std::uint32_t size; // Number of nodes in this subtree
+        std::uint32_t priority;
+    };
+
+    ring_buffer_type samples_;
+    std::uint64_t pushed_{}; // Sequence number of the next sample
+    size_type window_{N};
+    std::uint32_t root_{npos};
+    std::uint32_t seed_{0x9E3779B9};
+    Node nodes_[N];
+
+    std::uint32_t random() noexcept
+    {
+        seed_ ^= seed_ << 13;
+        seed_ ^= seed_ >> 17;
+        seed_ ^= seed_ << 5;
+        return seed_;
+    }
+
+    std::uint32_t sizeOf(std::uint32_t index) const noexcept
+    {
+        return index == npos ? 0 : nodes_[index].size;
+    }
+
+    void update(std::uint32_t index) noexcept
+    {
+        auto& node = nodes_[index];
+        node.size = 1 + sizeOf(node.left) + sizeOf(node.right);
+    }
+
+    bool less(T const& value, std::uint64_t sequence, Node const& node) const noexcept
+    {
+        return value < node.value || (!(node.value < value) && sequence < node.sequence);
+    }
+
+    // Splits the subtree at root into nodes ordered before and after the key of node index
+    std::pair<std::uint32_t, std::uint32_t> split(std::uint32_t root, std::uint32_t index) noexcept
+    {
+        if (root == npos)
+        {
+            return {npos, npos};
+        }
+        auto& node = nodes_[root];
+        if (less(nodes_[index].value, nodes_[index].sequence, node))
+        {
+            auto const [left, right] = split(node.left, index);
+            node.left = right;
+            update(root);
+            return {left, root};
+        }
+        auto const [left, right] = split(node.right, index);
+        node.right = left;
+        update(root);
+        return {root, right};
+    }
+
+    // Joins two subtrees where all keys of left are ordered before those of right
+    std::uint32_t merge(std::uint32_t left, std::uint32_t right) noexcept
+    {
+        if (left == npos)
+        {
+            return right;
+        }
+        if (right == npos)
+        {
+            return left;
+        }
+        if (nodes_[left].priority > nodes_[right].priority)
+        {
+            nodes_[left].right = merge(nodes_[left].right, right);
+            update(left);
+            return left;
+        }
+        nodes_[right].left = merge(left, nodes_[right].left);
+        update(right);
+        return right;
+    }
+
+    std::uint32_t insert(std::uint32_t root, std::uint32_t index) noexcept
+    {
+        if (root == npos)
+        {
+            return index;
+        }
+        auto& node = nodes_[root];
+        if (nodes_[index].priority > node.priority)
+        {
+            auto const [left, right] = split(root, index);
+            nodes_[index].left = left;
+            nodes_[index].right = right;
+            update(index);
+            return index;
+        }
+        if (less(nodes_[index].value, nodes_[index].sequence, node))
+        {
+            node.left = insert(node.left, index);
+        }
+        else
+        {
+            node.right = insert(node.right, index);
+        }
+        ++node.size;
+        return root;
+    }
+
+    std::uint32_t erase(std::uint32_t root, T const& value, std::uint64_t sequence) noexcept
+    {
+        auto& node = nodes_[root];
+        if (node.sequence == sequence)
+        {
+            return merge(node.left, node.right);
+        }
+        if (less(value, sequence, node))
+        {
+            node.left = erase(node.left, value, sequence);
+        }
+        else
+        {
+            node.right = erase(node.right, value, sequence);
+        }
+        --node.size;
+        return root;
+    }
+};
+
+WQ_END_NAMESPACE
+
+#endif // WQ_WINDOWED_QUANTILE_HPP_INCLUDED
@@ -0,0 +1,192 @@
+//
+// Test harnesses for AsyncLogger
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#define CATCH_CONFIG_MAIN
+
+#include "async_logger.hpp"
+#include "catch.hpp"
+
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace AL_NAMESPACE_NAME;
+
+namespace
+{
+    // Temporary file the logger writes to
+    struct LogFile
+    {
+        std::FILE* file{std::tmpfile()};
+
+        ~LogFile()
+        {
+            std::fclose(file);
+        }
+
+        int fd() const noexcept
+        {
+            return ::fileno(file);
+        }
+
+        std::string contents() const
+        {
+            std::string result;
+            char buffer[4096];
+            for (off_t offset = 0;;)
+            {
+                auto const count = ::pread(fd(), buffer, sizeof buffer, offset);
+                if (count <= 0)
+                {
+                    return result;
+                }
+                result.append(buffer, static_cast<std::size_t>(count));
+                offset += count;
+            }
+        }
+    };
+
+    std::vector<std::string> lines(std::string const& text)
+    {
+        std::vector<std::string> result;
+        std::istringstream stream{text};
+        for (std::string line; std::getline(stream, line);)
+        {
+            result.push_back(line);
+        }
+        return result;
+    }
+} // namespace
+
+TEST_CASE("utl.async_logger. Formatting")
+{
+    LogFile log;
+    AsyncLogger<> logger{log.fd()};
+    AsyncLogger<>::Producer producer{logger};
+
+    SECTION("Arguments of all kinds")
+    {
+        REQUIRE(producer("plain message\n"));
+        REQUIRE(producer("100%% literal\n"));
+        REQUIRE(producer("%d %u %lld %c %.2f %.1f\n", -1, 2u, 3ll, 'x', 4.5, 6.25f));
+        {
+            std::string const temporary{"copied"};
+            char buffer[] = "mutable";
+            REQUIRE(producer("%s %s %s %s %s\n", "literal", temporary, std::string_view{temporary}.substr(1, 3), buffer,
+                             static_cast<char const*>(nullptr)));
+        }
+        logger.flush();
+        REQUIRE(lines(log.contents()) == std::vector<std::string>{"plain message", "100% literal", "-1 2 3 x 4.50 6.2",
+                                                                   "literal copied opi mutable (null)"});
+    }
+
+    SECTION("Messages larger than the batch")
+    {
+        std::string const large(200'000, 'a');
+        AsyncLogger<64> small{log.fd(), AsyncLogFull::block, 1 << 20};
+        AsyncLogger<64>::Producer p{small};
+        REQUIRE(p("<%s>\n", large));
+        REQUIRE(p("%d\n", 42));
+        small.flush();
+        REQUIRE(log.contents() == "<" + large + ">\n42\n");
+    }
+
+    SECTION("Messages larger than the ring are dropped")
+    {
+        std::string const large(100'000, 'a');
+        REQUIRE(!producer("%s\n", large));
+        REQUIRE(producer.dropped() == 1);
+        REQUIRE(logger.dropped() == 1);
+    }
+}
+
+TEST_CASE("utl.async_logger. Full rings")
+{
+    LogFile log;
+
+    SECTION("Dropping")
+    {
+        // The background thread sleeps until flush() wakes it
+        AsyncLogger<> logger{log.fd(), AsyncLogFull::drop, 256, std::chrono::hours{1}};
+        AsyncLogger<>::Producer producer{logger};
+        std::size_t accepted = 0;
+        for (int i = 0; i < 100; ++i)
+        {
+            accepted += producer("%d\n", i);
+        }
+        REQUIRE(accepted > 0);
+        REQUIRE(accepted < 100);
+        REQUIRE(producer.dropped() == 100 - accepted);
+
+        logger.flush();
+        auto const written = lines(log.contents());
+        REQUIRE(written.size() == accepted);
+        for (std::size_t i = 0; i < accepted; ++i)
+        {
+            REQUIRE(written[i] == std::to_string(i));
+        }
+        REQUIRE(producer("%d\n", 100));
+    }
+
+    SECTION("Blocking drops messages which never fit")
+    {
+        AsyncLogger<> logger{log.fd(), AsyncLogFull::block, 1024, std::chrono::microseconds{10}};
+        AsyncLogger<>::Producer producer{logger};
+        REQUIRE(producer("%s\n", std::string(483, 'a')));
+        logger.flush();
+
+        // Larger than half the ring: the tail is past the middle, so it would never fit
+        REQUIRE_FALSE(producer("%s\n", std::string(560, 'b')));
+        REQUIRE(producer.dropped() == 1);
+        REQUIRE(producer("%s\n", std::string(470, 'c')));
+        logger.flush();
+        REQUIRE(lines(log.contents()) == std::vector<std::string>{std::string(483, 'a'), std::string(470, 'c')});
+    }
+
+    SECTION("Blocking keeps every message in order")
+    {
+        constexpr int threads = 4;
+        constexpr int messages = 5000;
+        {
+            AsyncLogger<> logger{log.fd(), AsyncLogFull::block, 256, std::chrono::microseconds{10}};
+            std::vector<std::thread> producers;
+            for (int t = 0; t < threads; ++t)
+            {
+                producers.emplace_back([&, t] {
+                    AsyncLogger<>::Producer producer{logger};
+                    for (int i = 0; i < messages; ++i)
+                    {
+                        producer("%d %d\n", t, i);
+                    }
+                });
+            }
+            for (auto& producer : producers)
+            {
+                producer.join();
+            }
+            REQUIRE(logger.dropped() == 0);
+        }
+        // The destructor has written the rest
+        auto const written = lines(log.contents());
+        REQUIRE(written.size() == threads * messages);
+        std::vector<int> next(threads);
+        for (auto const& line : written)
+        {
+            int t = 0;
+            int i = 0;
+            REQUIRE(std::sscanf(line.c_str(), "%d %d", &t, &i) == 2);
+            REQUIRE(i == next[t]++);
+        }
+    }
+}
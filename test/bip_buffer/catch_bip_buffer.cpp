@@ -0,0 +1,212 @@
+//
+// Test harnesses for BipBuffer<T, N>
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#define CATCH_CONFIG_MAIN
+
+#include "bip_buffer.hpp"
+#include "catch.hpp"
+
+#include <numeric>
+#include <string>
+
+using namespace BB_NAMESPACE_NAME;
+
+// Element class counting live instances
+struct Element
+{
+    static inline int instances = 0;
+    unsigned int val;
+
+    Element(unsigned int val)
+        : val{val}
+    {
+        ++instances;
+    }
+
+    ~Element()
+    {
+        val = 0xDEADDEAD;
+        --instances;
+    }
+};
+
+TEST_CASE("utl.bip_buffer. Reserve, commit, read and release")
+{
+    BipBuffer<char, 10> bb;
+
+    REQUIRE(bb.capacity() == 10);
+    REQUIRE(bb.empty());
+    REQUIRE(bb.size() == 0);
+    REQUIRE(bb.contiguous_free() == 10);
+    REQUIRE(bb.read().empty());
+
+    auto const write = [&](std::string const& s) {
+        auto out = bb.reserve(s.size());
+        if (out.size() != s.size())
+        {
+            return false;
+        }
+        std::copy(s.begin(), s.end(), out.begin());
+        bb.commit(s.size());
+        return true;
+    };
+    auto const contents = [&] { return std::string(bb.read().begin(), bb.read().end()); };
+
+    REQUIRE(write("abcdef"));
+    REQUIRE(bb.size() == 6);
+    REQUIRE(contents() == "abcdef");
+    REQUIRE(bb.contiguous_free() == 4);
+    REQUIRE_FALSE(write("12345"));
+
+    SECTION("Reservations which do not fit after region A go to region B")
+    {
+        bb.release(5);
+        REQUIRE(contents() == "f");
+        REQUIRE(bb.contiguous_free() == 5);
+
+        // 5 contiguous slots are available at the front
+        REQUIRE(write("12345"));
+        REQUIRE(bb.size() == 6);
+        REQUIRE(contents() == "f");
+        REQUIRE(bb.contiguous_free() == 0);
+        REQUIRE_FALSE(write("x"));
+
+        // Region B becomes region A
+        bb.release(1);
+        REQUIRE(contents() == "12345");
+        REQUIRE(bb.contiguous_free() == 5);
+        REQUIRE(write("ghijk"));
+        REQUIRE(contents() == "12345ghijk");
+        bb.release(10);
+        REQUIRE(bb.empty());
+        REQUIRE(bb.contiguous_free() == 10);
+    }
+
+    SECTION("Commit less than reserved")
+    {
+        auto out = bb.reserve(4);
+        REQUIRE(out.size() == 4);
+        out[0] = 'g';
+        bb.commit(1);
+        REQUIRE(contents() == "abcdefg");
+
+        // Committing without a reservation does nothing
+        bb.commit(3);
+        REQUIRE(bb.size() == 7);
+    }
+
+    SECTION("Region A is released while a reservation is pending")
+    {
+        auto out = bb.reserve(3);
+        REQUIRE(out.size() == 3);
+        bb.release(6);
+        REQUIRE(bb.empty());
+        std::copy_n("xyz", 3, out.begin());
+        bb.commit(3);
+        REQUIRE(contents() == "xyz");
+        REQUIRE(bb.contiguous_free() == 6);
+    }
+
+    SECTION("Region A is released while a reservation in region B is pending")
+    {
+        bb.release(5);
+        auto out = bb.reserve(5);
+        REQUIRE(out.data() == &bb.read()[0] - 5);
+        bb.release(1);
+        REQUIRE(bb.empty());
+        REQUIRE(bb.contiguous_free() == 10);
+        std::copy_n("12345", 5, out.begin());
+        bb.commit(5);
+        REQUIRE(bb.size() == 5);
+        REQUIRE_FALSE(bb.empty());
+        REQUIRE(contents() == "12345");
+        REQUIRE(bb.contiguous_free() == 5);
+        REQUIRE(write("67890"));
+        REQUIRE(contents() == "1234567890");
+    }
+}
+
+TEST_CASE("utl.bip_buffer. Non trivial elements are constructed in place and destroyed on release")
+{
+    {
+        BipBuffer<Element, 8> bb;
+        for (unsigned int i = 0; i < 8; ++i)
+        {
+            REQUIRE(bb.emplace(i));
+        }
+        REQUIRE_FALSE(bb.emplace(8u));
+        REQUIRE(Element::instances == 8);
+
+        auto in = bb.read();
+        REQUIRE(in.size() == 8);
+        for (unsigned int i = 0; i < 8; ++i)
+        {
+            REQUIRE(in[i].val == i);
+        }
+
+        bb.release(3);
+        REQUIRE(Element::instances == 5);
+
+        auto out = bb.reserve(3);
+        REQUIRE(out.size() == 3);
+        for (unsigned int i = 0; i < 3; ++i)
+        {
+            std::construct_at(&out[i], 100 + i);
+        }
+        bb.commit(3);
+        REQUIRE(Element::instances == 8);
+        REQUIRE(bb.read().size() == 5);
+        REQUIRE(bb.read().front().val == 3);
+    }
+    REQUIRE(Element::instances == 0);
+}
+
+TEST_CASE("utl.bip_buffer. Stream of variable sized frames")
+{
+    BipBuffer<unsigned int, 64> bb;
+    unsigned int next = 0;
+    unsigned int expected = 0;
+    for (unsigned int frame = 1; frame < 500; ++frame)
+    {
+        auto const size = frame % 17 + 1;
+        auto out = bb.reserve(size);
+        if (out.empty())
+        {
+            // Drain everything readable to make room
+            for (auto value : bb.read())
+            {
+                REQUIRE(value == expected++);
+            }
+            bb.release(bb.read().size());
+            out = bb.reserve(size);
+            if (out.empty())
+            {
+                for (auto value : bb.read())
+                {
+                    REQUIRE(value == expected++);
+                }
+                bb.release(bb.read().size());
+                out = bb.reserve(size);
+            }
+        }
+        REQUIRE(out.size() == size);
+        std::iota(out.begin(), out.end(), next);
+        next += size;
+        bb.commit(size);
+    }
+    while (!bb.empty())
+    {
+        for (auto value : bb.read())
+        {
+            REQUIRE(value == expected++);
+        }
+        bb.release(bb.read().size());
+    }
+    REQUIRE(expected == next);
+}
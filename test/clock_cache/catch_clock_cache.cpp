@@ -0,0 +1,231 @@
+//
+// Test harnesses for ClockCache<K, V, N>
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#define CATCH_CONFIG_MAIN
+
+#include "clock_cache.hpp"
+#include "catch.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace CC_NAMESPACE_NAME;
+
+namespace
+{
+    // Value class counting live instances
+    struct Element
+    {
+        static inline int instances = 0;
+
+        std::string text;
+
+        Element(std::string t)
+            : text{std::move(t)}
+        {
+            ++instances;
+        }
+
+        Element(Element const& other)
+            : text{other.text}
+        {
+            ++instances;
+        }
+
+        Element& operator=(Element const&) = default;
+
+        ~Element()
+        {
+            --instances;
+        }
+    };
+
+    // Hash which maps all keys to a few positions, forcing long probe sequences
+    struct CollidingHash
+    {
+        std::size_t operator()(int key) const noexcept
+        {
+            return static_cast<std::size_t>(key % 3);
+        }
+    };
+} // namespace
+
+TEST_CASE("utl.clock_cache. Insert, find and erase")
+{
+    {
+        auto cache = std::make_unique<ClockCache<int, Element, 4>>();
+        REQUIRE(cache->empty());
+        REQUIRE(cache->capacity() == 4);
+        REQUIRE(cache->find(1) == nullptr);
+
+        REQUIRE(cache->insert_or_assign(1, Element{"one"}));
+        REQUIRE(cache->insert_or_assign(2, Element{"two"}));
+        REQUIRE(cache->size() == 2);
+        REQUIRE(Element::instances == 2);
+        REQUIRE(cache->find(1)->text == "one");
+        REQUIRE(cache->get(2)->text == "two");
+        REQUIRE(!cache->get(3).has_value());
+        REQUIRE(cache->contains(2));
+
+        REQUIRE(!cache->insert_or_assign(2, Element{"deux"}));
+        REQUIRE(cache->size() == 2);
+        REQUIRE(cache->find(2)->text == "deux");
+
+        REQUIRE(cache->erase(1));
+        REQUIRE(!cache->erase(1));
+        REQUIRE(!cache->contains(1));
+        REQUIRE(cache->size() == 1);
+        REQUIRE(Element::instances == 1);
+
+        cache->insert_or_assign(3, Element{"three"});
+        cache->insert_or_assign(4, Element{"four"});
+        cache->insert_or_assign(5, Element{"five"});
+        REQUIRE(cache->size() == 4);
+        REQUIRE(Element::instances == 4);
+
+        cache->clear();
+        REQUIRE(cache->empty());
+        REQUIRE(Element::instances == 0);
+        cache->insert_or_assign(6, Element{"six"});
+    }
+    REQUIRE(Element::instances == 0);
+}
+
+TEST_CASE("utl.clock_cache. Referenced entries survive eviction")
+{
+    ClockCache<int, int, 4> cache;
+    for (int key = 0; key < 4; ++key)
+    {
+        cache.insert_or_assign(key, key);
+    }
+
+    // 0 and 2 are referenced, the hand passes them and evicts 1, then 3
+    REQUIRE(cache.find(0) != nullptr);
+    REQUIRE(cache.find(2) != nullptr);
+    cache.insert_or_assign(10, 10);
+    REQUIRE(cache.contains(0));
+    REQUIRE(!cache.contains(1));
+    REQUIRE(cache.contains(2));
+    cache.insert_or_assign(11, 11);
+    REQUIRE(!cache.contains(3));
+
+    // The hand cleared the bits of 0 and 2 on its way, so they go next
+    cache.insert_or_assign(12, 12);
+    REQUIRE(!cache.contains(0));
+    REQUIRE(cache.contains(2));
+    REQUIRE(cache.size() == 4);
+}
+
+TEST_CASE("utl.clock_cache. Random operations")
+{
+    auto cache = std::make_unique<ClockCache<int, int, 64, CollidingHash>>();
+    std::map<int, int> model; // Every value ever assigned and not erased
+    std::mt19937 random{42};
+    for (int i = 0; i < 200000; ++i)
+    {
+        auto const key = static_cast<int>(random() % 200);
+        switch (random() % 4)
+        {
+        case 0:
+            cache->insert_or_assign(key, i);
+            model[key] = i;
+            REQUIRE(*cache->find(key) == i);
+            break;
+        case 1:
+            if (cache->erase(key))
+            {
+                REQUIRE(model.count(key) == 1);
+            }
+            model.erase(key);
+            REQUIRE(!cache->contains(key));
+            break;
+        default:
+            if (auto const value = cache->find(key))
+            {
+                REQUIRE(model.count(key) == 1);
+                REQUIRE(*value == model[key]);
+            }
+            break;
+        }
+        REQUIRE(cache->size() <= 64);
+    }
+
+    std::size_t cached = 0;
+    for (auto const& [key, value] : model)
+    {
+        if (auto const hit = cache->get(key))
+        {
+            REQUIRE(*hit == value);
+            ++cached;
+        }
+    }
+    REQUIRE(cached == cache->size());
+}
+
+TEST_CASE("utl.clock_cache. Concurrent readers")
+{
+    struct Value
+    {
+        std::uint64_t key;
+        std::uint64_t check;
+    };
+
+    auto cache = std::make_unique<ShardedClockCache<std::uint64_t, Value, 1024, 4>>();
+    REQUIRE(cache->capacity() == 1024);
+    std::atomic<bool> done{false};
+    std::atomic<int> failures{0};
+    std::atomic<std::uint64_t> hits{0};
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r)
+    {
+        readers.emplace_back([&, r] {
+            std::mt19937_64 random{static_cast<std::uint64_t>(r)};
+            while (!done.load())
+            {
+                auto const key = random() % 4096;
+                if (auto const value = cache->get(key))
+                {
+                    if (value->key != key || value->check != ~key * 31)
+                    {
+                        ++failures;
+                    }
+                    ++hits;
+                }
+            }
+        });
+    }
+
+    std::mt19937_64 random{99};
+    for (int i = 0; i < 200000; ++i)
+    {
+        auto const key = random() % 4096;
+        if (i % 5 == 0)
+        {
+            cache->erase(key);
+        }
+        else
+        {
+            cache->insert_or_assign(key, Value{key, ~key * 31});
+        }
+    }
+    done = true;
+    for (auto& reader : readers)
+    {
+        reader.join();
+    }
+    REQUIRE(failures == 0);
+    REQUIRE(cache->size() <= 1024);
+}
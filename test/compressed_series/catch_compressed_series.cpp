@@ -0,0 +1,136 @@
+//
+// Test harnesses for CompressedSeries<BlockSize, Blocks>
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#define CATCH_CONFIG_MAIN
+
+#include "compressed_series.hpp"
+#include "catch.hpp"
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace CS_NAMESPACE_NAME;
+
+namespace
+{
+    template<typename Series>
+    std::vector<CompressedPoint> decode(Series const& series)
+    {
+        return std::vector<CompressedPoint>(series.begin(), series.end());
+    }
+
+    bool same(CompressedPoint const& a, CompressedPoint const& b)
+    {
+        return a.time == b.time && std::bit_cast<std::uint64_t>(a.value) == std::bit_cast<std::uint64_t>(b.value);
+    }
+} // namespace
+
+TEST_CASE("utl.compressed_series. Points round trip")
+{
+    auto series = std::make_unique<CompressedSeries<256, 4>>();
+    REQUIRE(series->empty());
+    REQUIRE(series->begin() == series->end());
+    REQUIRE(series->encoded_bytes() == 0);
+    REQUIRE(series->capacity() == 4);
+    REQUIRE(series->block_size() == 256);
+
+    std::vector<CompressedPoint> const points{
+        {1000, 1.5},
+        {1010, 1.5},
+        {1020, 2.5},
+        {1030, -2.5},
+        {1031, 0.0},
+        {900, std::numeric_limits<double>::infinity()},
+        {std::numeric_limits<std::int64_t>::max(), std::numeric_limits<double>::denorm_min()},
+        {std::numeric_limits<std::int64_t>::min(), -0.0},
+        {0, std::numeric_limits<double>::quiet_NaN()},
+        {5000, 1e300},
+    };
+    for (auto const& point : points)
+    {
+        series->push(point.time, point.value);
+    }
+    REQUIRE(series->size() == points.size());
+    REQUIRE(series->blocks() == 1);
+    REQUIRE(same(series->back(), points.back()));
+
+    auto const decoded = decode(*series);
+    REQUIRE(decoded.size() == points.size());
+    for (std::size_t i = 0; i < points.size(); ++i)
+    {
+        REQUIRE(same(decoded[i], points[i]));
+    }
+
+    series->clear();
+    REQUIRE(series->empty());
+    REQUIRE(series->blocks() == 0);
+    REQUIRE(decode(*series).empty());
+}
+
+TEST_CASE("utl.compressed_series. Regular samples compress well")
+{
+    auto series = std::make_unique<CompressedSeries<4096, 16>>();
+    std::mt19937 random{42};
+    std::int64_t time = 1'600'000'000;
+    double value = 50.0;
+    std::vector<CompressedPoint> points;
+    for (int i = 0; i < 20000; ++i)
+    {
+        time += random() % 50 == 0 ? 2 : 1; // Occasional jitter
+        if (random() % 8 == 0)
+        {
+            value += static_cast<double>(static_cast<int>(random() % 5) - 2);
+        }
+        series->push(time, value);
+        points.push_back({time, value});
+    }
+    REQUIRE(series->size() == points.size());
+    REQUIRE(series->blocks() < 16);
+    // At least 8x smaller than 16 bytes per point
+    REQUIRE(series->encoded_bytes() * 8 <= points.size() * 16);
+
+    auto const decoded = decode(*series);
+    REQUIRE(decoded.size() == points.size());
+    for (std::size_t i = 0; i < points.size(); ++i)
+    {
+        REQUIRE(same(decoded[i], points[i]));
+    }
+}
+
+TEST_CASE("utl.compressed_series. Oldest blocks are evicted")
+{
+    auto series = std::make_unique<CompressedSeries<128, 4>>();
+    std::mt19937_64 random{7};
+    std::vector<CompressedPoint> points;
+    std::int64_t time = 0;
+    for (int i = 0; i < 5000; ++i)
+    {
+        time += static_cast<std::int64_t>(random() % 5000);
+        auto const value = std::bit_cast<double>(random() & 0x7FEFFFFFFFFFFFFF);
+        series->push(time, value);
+        points.push_back({time, value});
+
+        REQUIRE(series->blocks() <= 4);
+        auto const decoded = decode(*series);
+        REQUIRE(decoded.size() == series->size());
+        auto const first = points.size() - decoded.size();
+        for (std::size_t j = 0; j < decoded.size(); ++j)
+        {
+            REQUIRE(same(decoded[j], points[first + j]));
+        }
+    }
+    REQUIRE(series->blocks() == 4);
+    REQUIRE(series->size() < 5000);
+    REQUIRE(series->encoded_bytes() <= 4 * 128);
+}
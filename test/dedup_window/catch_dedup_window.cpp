@@ -0,0 +1,96 @@
+//
+// Test harnesses for DedupWindow<Key, N>
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#define CATCH_CONFIG_MAIN
+
+#include "dedup_window.hpp"
+#include "catch.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <random>
+#include <unordered_set>
+
+using namespace DW_NAMESPACE_NAME;
+
+namespace
+{
+    // Hash which maps all keys to a few positions, forcing long probe sequences
+    struct CollidingHash
+    {
+        std::size_t operator()(std::uint64_t key) const noexcept
+        {
+            return static_cast<std::size_t>(key % 5);
+        }
+    };
+} // namespace
+
+TEST_CASE("utl.dedup_window. Duplicates within the window are dropped")
+{
+    DedupWindow<std::uint64_t, 3> seen;
+    REQUIRE(seen.empty());
+    REQUIRE(seen.capacity() == 3);
+
+    REQUIRE(seen.insert(1));
+    REQUIRE(seen.insert(2));
+    REQUIRE(!seen.insert(1));
+    REQUIRE(seen.insert(3));
+    REQUIRE(seen.full());
+    REQUIRE(!seen.insert(2));
+
+    // 1 leaves the window
+    REQUIRE(seen.insert(4));
+    REQUIRE(!seen.contains(1));
+    REQUIRE(seen.contains(2));
+    REQUIRE(seen.keys().front() == 2);
+    REQUIRE(seen.keys().back() == 4);
+    REQUIRE(seen.insert(1));
+    REQUIRE(!seen.contains(2));
+    REQUIRE(seen.size() == 3);
+
+    seen.clear();
+    REQUIRE(seen.empty());
+    REQUIRE(!seen.contains(4));
+    REQUIRE(seen.insert(4));
+}
+
+TEST_CASE("utl.dedup_window. Matches ring buffer and set")
+{
+    constexpr std::size_t window = 100;
+    auto seen = std::make_unique<DedupWindow<std::uint64_t, window, CollidingHash>>();
+    std::deque<std::uint64_t> order;
+    std::unordered_set<std::uint64_t> set;
+
+    std::mt19937_64 random{42};
+    for (int i = 0; i < 200000; ++i)
+    {
+        auto const key = random() % 300;
+        auto const expected = set.count(key) == 0;
+        REQUIRE(seen->insert(key) == expected);
+        if (expected)
+        {
+            if (order.size() == window)
+            {
+                set.erase(order.front());
+                order.pop_front();
+            }
+            order.push_back(key);
+            set.insert(key);
+        }
+        REQUIRE(seen->size() == order.size());
+        if (i % 1000 == 0)
+        {
+            for (std::uint64_t k = 0; k < 300; ++k)
+            {
+                REQUIRE(seen->contains(k) == (set.count(k) == 1));
+            }
+        }
+    }
+}
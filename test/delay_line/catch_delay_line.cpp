@@ -0,0 +1,149 @@
+//
+// Test harnesses for DelayLine<T, N> and FirFilter<N>
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#define CATCH_CONFIG_MAIN
+
+#include "delay_line.hpp"
+#include "catch.hpp"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace DL_NAMESPACE_NAME;
+
+namespace
+{
+    std::vector<SimdLevel> supportedLevels()
+    {
+        std::vector<SimdLevel> result;
+        for (auto level : {SimdLevel::scalar, SimdLevel::sse, SimdLevel::avx2, SimdLevel::avx512})
+        {
+            if (level <= simd_level())
+            {
+                result.push_back(level);
+            }
+        }
+        return result;
+    }
+} // namespace
+
+TEST_CASE("utl.delay_line. Contiguous windows")
+{
+    DelayLine<int, 5> line;
+    REQUIRE(std::vector<int>(line.window().begin(), line.window().end()) == std::vector<int>{0, 0, 0, 0, 0});
+
+    for (int i = 1; i <= 13; ++i)
+    {
+        line.push(i);
+        auto const window = line.window();
+        for (int k = 0; k < 5; ++k)
+        {
+            REQUIRE(window[static_cast<std::size_t>(k)] == std::max(i - 4 + k, 0));
+        }
+        REQUIRE(line[0] == i);
+        REQUIRE(line[4] == std::max(i - 4, 0));
+    }
+    auto const last = line.last(3);
+    REQUIRE(std::vector<int>(last.begin(), last.end()) == std::vector<int>{11, 12, 13});
+    REQUIRE(line.last(0).empty());
+
+    line.fill(7);
+    REQUIRE(std::vector<int>(line.window().begin(), line.window().end()) == std::vector<int>{7, 7, 7, 7, 7});
+}
+
+TEST_CASE("utl.delay_line. Dot product kernels")
+{
+    std::mt19937 gen{42};
+    std::uniform_real_distribution<float> dist{-1.0f, 1.0f};
+    std::vector<float> a(600);
+    std::vector<float> b(600);
+    for (std::size_t i = 0; i < a.size(); ++i)
+    {
+        a[i] = dist(gen);
+        b[i] = dist(gen);
+    }
+
+    for (auto level : supportedLevels())
+    {
+        // Every remainder of the unrolled loops
+        for (std::size_t n = 0; n <= 600; n += n < 70 ? 1 : 53)
+        {
+            double expected = 0.0;
+            double magnitude = 0.0;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                expected += static_cast<double>(a[i]) * static_cast<double>(b[i]);
+                magnitude += std::abs(static_cast<double>(a[i]) * static_cast<double>(b[i]));
+            }
+            auto const result = dot(level, std::span{a}.first(n), std::span{b}.first(n));
+            REQUIRE(std::abs(result - expected) <= 1e-6 * (magnitude + 1.0));
+        }
+    }
+
+    // Exact for integers
+    std::vector<float> ones(100, 1.0f);
+    std::vector<float> counts(100);
+    for (std::size_t i = 0; i < counts.size(); ++i)
+    {
+        counts[i] = static_cast<float>(i);
+    }
+    for (auto level : supportedLevels())
+    {
+        REQUIRE(dot(level, ones, counts) == 4950.0f);
+    }
+    REQUIRE(dot(ones, counts) == 4950.0f);
+}
+
+TEST_CASE("utl.delay_line. FIR filter")
+{
+    SECTION("Impulse response")
+    {
+        std::vector<float> const coefficients{0.5f, 0.25f, 0.125f, 0.0625f};
+        FirFilter<16> filter{coefficients};
+        REQUIRE(filter.taps() == 4);
+        REQUIRE(filter.process(1.0f) == 0.5f);
+        REQUIRE(filter.process(0.0f) == 0.25f);
+        REQUIRE(filter.process(0.0f) == 0.125f);
+        REQUIRE(filter.process(0.0f) == 0.0625f);
+        REQUIRE(filter.process(0.0f) == 0.0f);
+        REQUIRE(filter.process(2.0f) == 1.0f);
+        filter.reset();
+        REQUIRE(filter.process(0.0f) == 0.0f);
+    }
+
+    SECTION("Matches the direct form for every kernel")
+    {
+        std::mt19937 gen{7};
+        std::uniform_real_distribution<float> dist{-1.0f, 1.0f};
+        std::vector<float> coefficients(37);
+        for (auto& c : coefficients)
+        {
+            c = dist(gen);
+        }
+        std::vector<float> input(1000);
+        for (auto& x : input)
+        {
+            x = dist(gen);
+        }
+        for (auto level : supportedLevels())
+        {
+            FirFilter<64> filter{coefficients};
+            for (std::size_t n = 0; n < input.size(); ++n)
+            {
+                double expected = 0.0;
+                for (std::size_t k = 0; k < coefficients.size() && k <= n; ++k)
+                {
+                    expected += static_cast<double>(coefficients[k]) * static_cast<double>(input[n - k]);
+                }
+                REQUIRE(std::abs(filter.process(level, input[n]) - expected) <= 1e-5);
+            }
+        }
+    }
+}
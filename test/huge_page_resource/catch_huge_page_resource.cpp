@@ -0,0 +1,83 @@
+//
+// Test harnesses for HugePageResource
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#define CATCH_CONFIG_MAIN
+
+#include "huge_page_resource.hpp"
+#include "unique_buffer.hpp"
+#include "ring_buffer.hpp"
+#include "catch.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+using namespace HP_NAMESPACE_NAME;
+
+TEST_CASE("utl.huge_page_resource. UniqueBuffer")
+{
+    HugePageResource memres;
+    REQUIRE(memres.pageSize() == (2u << 20));
+
+    constexpr std::size_t count = 1'000'000;
+    {
+        UniqueBuffer ub{sizeof(int) * count, memres};
+        REQUIRE(ub.size() == sizeof(int) * count);
+        REQUIRE(reinterpret_cast<std::uintptr_t>(ub.get()) % memres.pageSize() == 0);
+
+        std::iota(ub.as<int>(), ub.as<int>() + count, 0);
+        REQUIRE(ub.as<int>()[count - 1] == static_cast<int>(count - 1));
+    }
+    REQUIRE(memres.hugetlbAllocations() + memres.fallbackAllocations() == 1);
+
+    SECTION("Several buffers at once")
+    {
+        UniqueBuffer ub1{100, memres};
+        UniqueBuffer ub2{memres.pageSize() + 1, memres};
+        REQUIRE(ub1.get() != ub2.get());
+        std::fill_n(ub1.as<std::byte>(), ub1.size(), std::byte{1});
+        std::fill_n(ub2.as<std::byte>(), ub2.size(), std::byte{2});
+        REQUIRE(ub1.as<std::byte>()[99] == std::byte{1});
+        REQUIRE(ub2.as<std::byte>()[memres.pageSize()] == std::byte{2});
+        REQUIRE(memres.hugetlbAllocations() + memres.fallbackAllocations() == 3);
+    }
+
+    SECTION("Memory resources compare by identity")
+    {
+        HugePageResource other;
+        REQUIRE(memres.is_equal(memres));
+        REQUIRE_FALSE(memres.is_equal(other));
+    }
+}
+
+TEST_CASE("utl.huge_page_resource. Prefaulted ring buffer")
+{
+    using Ring = RingBuffer<std::uint64_t, 1 << 20>;
+
+    HugePageResource memres{{HugePageSize::Size2MB, true}};
+    UniqueBuffer ub{sizeof(Ring), memres, alignof(Ring)};
+
+    // New mappings are zero filled, also after prefaulting
+    REQUIRE(std::all_of(ub.as<std::byte>(), ub.as<std::byte>() + ub.size(), [](auto b) { return b == std::byte{}; }));
+
+    auto rb = std::construct_at(static_cast<Ring*>(ub.get()));
+    for (std::uint64_t i = 0; i < 3 * rb->capacity() / 2; ++i)
+    {
+        rb->push(i);
+    }
+    REQUIRE(rb->full());
+    REQUIRE(rb->front() == rb->capacity() / 2);
+    REQUIRE(rb->back() == 3 * rb->capacity() / 2 - 1);
+    std::destroy_at(rb);
+}
+
+TEST_CASE("utl.huge_page_resource. Alignment larger than a huge page")
+{
+    HugePageResource memres;
+    REQUIRE_THROWS_AS(memres.allocate(100, 2 * memres.pageSize()), std::bad_alloc);
+}
@@ -0,0 +1,187 @@
+//
+// Test harnesses for LatencyHistogram and RingBufferLatency
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#define CATCH_CONFIG_MAIN
+
+#include "latency_histogram.hpp"
+#include "ring_buffer.hpp"
+#include "catch.hpp"
+
+#include <thread>
+#include <vector>
+
+using namespace LH_NAMESPACE_NAME;
+
+// Clock advanced manually by the tests
+struct ManualClock
+{
+    static inline std::uint64_t ticks = 0;
+
+    static std::uint64_t now() noexcept
+    {
+        return ticks;
+    }
+
+    static double nanosecondsPerTick() noexcept
+    {
+        return 2.0;
+    }
+};
+
+template<std::size_t Slots>
+using ManualLatency = RingBufferLatency<Slots, ManualClock>;
+
+TEST_CASE("utl.latency_histogram. Bucket layout")
+{
+    // Small values are exact
+    for (std::uint64_t value = 0; value < LatencyHistogram::subBucketCount; ++value)
+    {
+        REQUIRE(LatencyHistogram::bucketIndex(value) == value);
+        REQUIRE(LatencyHistogram::upperBound(value) == value);
+    }
+
+    // Buckets are contiguous and every value falls into the bucket whose bounds contain it
+    std::uint64_t lower = 0;
+    for (std::size_t index = 0; index < LatencyHistogram::bucketCount; ++index)
+    {
+        auto const upper = LatencyHistogram::upperBound(index);
+        REQUIRE(upper >= lower);
+        REQUIRE(LatencyHistogram::bucketIndex(lower) == index);
+        REQUIRE(LatencyHistogram::bucketIndex(upper) == index);
+        // Relative error bound
+        REQUIRE(static_cast<double>(upper - lower) <= static_cast<double>(lower) / LatencyHistogram::subBucketCount);
+        lower = upper + 1;
+    }
+    REQUIRE(lower == 0); // Wrapped around after the last bucket
+    REQUIRE(LatencyHistogram::bucketIndex(~std::uint64_t{}) == LatencyHistogram::bucketCount - 1);
+}
+
+TEST_CASE("utl.latency_histogram. Percentiles")
+{
+    LatencyHistogram histogram;
+
+    auto empty = histogram.snapshot();
+    REQUIRE(empty.count() == 0);
+    REQUIRE(empty.percentile(50.0) == 0.0);
+    REQUIRE(empty.min() == 0.0);
+
+    for (std::uint64_t value = 1; value <= 1000; ++value)
+    {
+        histogram.record(value);
+    }
+
+    auto const snapshot = histogram.snapshot();
+    REQUIRE(snapshot.count() == 1000);
+    REQUIRE(snapshot.min() == 1.0);
+    REQUIRE(snapshot.max() == 1000.0);
+    REQUIRE(snapshot.mean() == Approx(500.5));
+    REQUIRE(snapshot.percentile(0.0) == 1.0);
+    REQUIRE(snapshot.percentile(50.0) == Approx(500.0).epsilon(1.0 / 32));
+    REQUIRE(snapshot.percentile(99.0) == Approx(990.0).epsilon(1.0 / 32));
+    REQUIRE(snapshot.percentile(100.0) == 1000.0);
+
+    SECTION("Scaled snapshot")
+    {
+        auto const scaled = histogram.snapshot(0.5);
+        REQUIRE(scaled.max() == 500.0);
+        REQUIRE(scaled.mean() == Approx(250.25));
+    }
+
+    SECTION("Read and reset")
+    {
+        auto const taken = histogram.takeSnapshot();
+        REQUIRE(taken.count() == 1000);
+        REQUIRE(taken.percentile(100.0) == 1000.0);
+        REQUIRE(histogram.snapshot().count() == 0);
+
+        histogram.record(7);
+        auto const next = histogram.snapshot();
+        REQUIRE(next.count() == 1);
+        REQUIRE(next.min() == 7.0);
+        REQUIRE(next.max() == 7.0);
+    }
+}
+
+TEST_CASE("utl.latency_histogram. Concurrent recording")
+{
+    LatencyHistogram histogram;
+    constexpr std::uint64_t perThread = 100000;
+
+    std::vector<std::thread> threads;
+    for (std::uint64_t t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&histogram, t] {
+            for (std::uint64_t i = 0; i < perThread; ++i)
+            {
+                histogram.record(t * perThread + i);
+            }
+        });
+    }
+    std::uint64_t taken = 0;
+    while (taken < 1000)
+    {
+        taken += histogram.takeSnapshot().count();
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    taken += histogram.takeSnapshot().count();
+
+    REQUIRE(taken == 4 * perThread);
+}
+
+TEST_CASE("utl.latency_histogram. RingBuffer sojourn time")
+{
+    static_assert(sizeof(RingBuffer<int, 16>) == sizeof(RingBuffer<int, 16, RingBufferNullPolicy>));
+
+    RingBuffer<int, 4, ManualLatency> rb;
+    ManualClock::ticks = 100;
+
+    rb.push(1); // enqueued at 100
+    ManualClock::ticks = 110;
+    rb.push(2); // enqueued at 110
+    ManualClock::ticks = 150;
+    rb.pop(); // 50 ticks
+    ManualClock::ticks = 200;
+    rb.pop(); // 90 ticks
+
+    auto snapshot = rb.policy().snapshot();
+    REQUIRE(snapshot.count() == 2);
+    REQUIRE(snapshot.min() == 100.0); // 2 ns per tick
+    REQUIRE(snapshot.max() == 180.0);
+
+    SECTION("Overwritten elements are not recorded")
+    {
+        for (int i = 0; i < 10; ++i)
+        {
+            rb.push(i);
+        }
+        REQUIRE(rb.full());
+        ManualClock::ticks = 300;
+        rb.clear();
+        snapshot = rb.policy().takeSnapshot();
+        REQUIRE(snapshot.count() == 2 + rb.capacity());
+        REQUIRE(snapshot.max() == 200.0);
+        REQUIRE(rb.policy().snapshot().count() == 0);
+    }
+
+    SECTION("Wrap around reuses the stamp of the slot")
+    {
+        for (int i = 0; i < 20; ++i)
+        {
+            rb.push(i);
+            ManualClock::ticks += 3;
+            rb.pop();
+        }
+        snapshot = rb.policy().snapshot();
+        REQUIRE(snapshot.count() == 22);
+        REQUIRE(snapshot.percentile(50.0) == 6.0);
+    }
+}
@@ -0,0 +1,190 @@
+//
+// Test harnesses for ObjectPool and LockFreeObjectPool
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#define CATCH_CONFIG_MAIN
+
+#include "object_pool.hpp"
+#include "catch.hpp"
+
+#include <atomic>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace OP_NAMESPACE_NAME;
+
+// Element class counting live instances
+struct Element
+{
+    static constexpr unsigned int throwing = 0xBADBAD;
+    static inline std::atomic<int> instances = 0;
+    unsigned int val;
+
+    Element(unsigned int val)
+        : val{val}
+    {
+        if (val == throwing)
+        {
+            throw std::runtime_error("bad value");
+        }
+        ++instances;
+    }
+
+    ~Element()
+    {
+        val = 0xDEADDEAD;
+        --instances;
+    }
+};
+
+TEMPLATE_TEST_CASE("utl.object_pool. Acquire and release", "", (ObjectPool<Element, 4>), (LockFreeObjectPool<Element, 4>))
+{
+    auto pool = std::make_unique<TestType>();
+    REQUIRE(pool->capacity() == 4);
+    {
+        std::vector<typename TestType::handle_type> handles;
+        for (unsigned int i = 0; i < 4; ++i)
+        {
+            auto handle = pool->acquire(i);
+            REQUIRE(handle);
+            REQUIRE(handle->val == i);
+            REQUIRE(pool->owns(handle.get()));
+            handles.push_back(std::move(handle));
+        }
+        REQUIRE(Element::instances == 4);
+
+        // Exhausted
+        REQUIRE_FALSE(pool->acquire(4u));
+        REQUIRE(Element::instances == 4);
+
+        // Slots are reused
+        auto const p = handles[1].get();
+        handles[1].reset();
+        REQUIRE(Element::instances == 3);
+        auto handle = pool->acquire(5u);
+        REQUIRE(handle.get() == p);
+        REQUIRE(handle->val == 5);
+        handles[1] = std::move(handle);
+    }
+    REQUIRE(Element::instances == 0);
+
+    Element outside{1};
+    REQUIRE_FALSE(pool->owns(&outside));
+}
+
+TEMPLATE_TEST_CASE("utl.object_pool. Raw pointers", "", (ObjectPool<Element, 2>), (LockFreeObjectPool<Element, 2>))
+{
+    auto pool = std::make_unique<TestType>();
+    auto a = pool->construct(1u);
+    auto b = pool->acquire(2u).release();
+    REQUIRE(a != nullptr);
+    REQUIRE(b != nullptr);
+    REQUIRE(pool->construct(3u) == nullptr);
+    REQUIRE(Element::instances == 2);
+    pool->release(a);
+    pool->release(b);
+    pool->release(nullptr);
+    REQUIRE(Element::instances == 0);
+}
+
+TEMPLATE_TEST_CASE("utl.object_pool. Throwing constructor returns the slot", "", (ObjectPool<Element, 1>), (LockFreeObjectPool<Element, 1>))
+{
+    auto pool = std::make_unique<TestType>();
+    REQUIRE_THROWS_AS(pool->acquire(Element::throwing), std::runtime_error);
+    REQUIRE(Element::instances == 0);
+    auto handle = pool->acquire(1u);
+    REQUIRE(handle);
+}
+
+TEST_CASE("utl.object_pool. Release from another thread")
+{
+    constexpr std::size_t slots = 64;
+    constexpr std::size_t count = 100000;
+    auto pool = std::make_unique<LockFreeObjectPool<Element, slots>>();
+    std::vector<std::atomic<Element*>> mailbox(slots);
+    std::size_t failures = 0;
+
+    std::thread consumer{[&] {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            auto& slot = mailbox[i % slots];
+            Element* p;
+            while ((p = slot.exchange(nullptr, std::memory_order_acquire)) == nullptr)
+            {
+                std::this_thread::yield();
+            }
+            if (p->val != i)
+            {
+                ++failures;
+            }
+            pool->release(p);
+        }
+    }};
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        Element* p;
+        while ((p = pool->construct(static_cast<unsigned int>(i))) == nullptr)
+        {
+            std::this_thread::yield();
+        }
+        auto& slot = mailbox[i % slots];
+        while (slot.load(std::memory_order_relaxed) != nullptr)
+        {
+            std::this_thread::yield();
+        }
+        slot.store(p, std::memory_order_release);
+    }
+    consumer.join();
+    REQUIRE(failures == 0);
+    REQUIRE(Element::instances == 0);
+
+    // All slots are available again
+    std::set<Element*> distinct;
+    for (std::size_t i = 0; i < slots; ++i)
+    {
+        distinct.insert(pool->construct(0u));
+    }
+    REQUIRE(distinct.size() == slots);
+    REQUIRE_FALSE(distinct.contains(nullptr));
+    for (auto p : distinct)
+    {
+        pool->release(p);
+    }
+}
+
+TEST_CASE("utl.object_pool. Concurrent acquire and release")
+{
+    constexpr std::size_t slots = 16;
+    auto pool = std::make_unique<LockFreeObjectPool<Element, slots>>();
+    std::atomic<int> failures{0};
+    std::vector<std::thread> threads;
+    for (unsigned int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&, t] {
+            for (unsigned int i = 0; i < 50000; ++i)
+            {
+                auto const value = t * 1000000 + i;
+                if (auto handle = pool->acquire(value))
+                {
+                    if (handle->val != value)
+                    {
+                        failures.fetch_add(1);
+                    }
+                }
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    REQUIRE(failures == 0);
+}
@@ -0,0 +1,166 @@
+//
+// Test harnesses for OverwriteRing<T, N>
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#define CATCH_CONFIG_MAIN
+
+#include "overwrite_ring.hpp"
+#include "catch.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace OW_NAMESPACE_NAME;
+
+namespace
+{
+    // All words equal, so a torn copy shows as words which differ
+    struct Sample
+    {
+        std::uint64_t words[7];
+    };
+
+    Sample sampleOf(std::uint64_t producer, std::uint64_t sequence) noexcept
+    {
+        Sample result;
+        for (auto& word : result.words)
+        {
+            word = producer << 32 | sequence;
+        }
+        return result;
+    }
+
+    // Checks the samples a reader sees: none torn, each producer's in order
+    struct Checker
+    {
+        std::vector<std::uint64_t> next;
+        std::uint64_t read = 0;
+        std::uint64_t torn = 0;
+        std::uint64_t unordered = 0;
+
+        explicit Checker(std::size_t producers)
+            : next(producers)
+        {
+        }
+
+        void operator()(Sample const& sample)
+        {
+            ++read;
+            for (auto const word : sample.words)
+            {
+                torn += word != sample.words[0];
+            }
+            auto const producer = sample.words[0] >> 32;
+            auto const sequence = sample.words[0] & 0xFFFFFFFF;
+            unordered += producer >= next.size() || sequence < next[producer];
+            if (producer < next.size())
+            {
+                next[producer] = sequence + 1;
+            }
+        }
+    };
+} // namespace
+
+TEST_CASE("utl.overwrite_ring. Single thread")
+{
+    OverwriteRing<std::uint64_t, 8> ring;
+    REQUIRE(ring.capacity() == 8);
+
+    OverwriteRing<std::uint64_t, 8>::Reader reader{ring};
+    std::uint64_t value = 0;
+    REQUIRE(!reader.try_read(value));
+
+    ring.push(1);
+    ring.push(2);
+    REQUIRE(reader.try_read(value));
+    REQUIRE(value == 1);
+    REQUIRE(reader.try_read(value));
+    REQUIRE(value == 2);
+    REQUIRE(!reader.try_read(value));
+
+    // Overwrites the oldest elements the reader has not read yet
+    for (std::uint64_t i = 3; i <= 20; ++i)
+    {
+        ring.push(i);
+    }
+    std::vector<std::uint64_t> values;
+    REQUIRE(reader.drain([&](std::uint64_t element) { values.push_back(element); }) == 8);
+    REQUIRE(values == std::vector<std::uint64_t>{13, 14, 15, 16, 17, 18, 19, 20});
+    REQUIRE(reader.lost() == 10);
+    REQUIRE(reader.position() == 20);
+    REQUIRE(ring.pushed() == 20);
+    REQUIRE(ring.dropped() == 0);
+
+    // A new reader starts at the oldest element
+    OverwriteRing<std::uint64_t, 8>::Reader late{ring};
+    REQUIRE(late.try_read(value));
+    REQUIRE(value == 13);
+}
+
+TEST_CASE("utl.overwrite_ring. Concurrent producers and readers see no torn elements")
+{
+    constexpr std::size_t producers = 4;
+    constexpr std::uint64_t perProducer = 100000;
+
+    // Small, so the producers overwrite elements while the readers copy them
+    auto ring = std::make_unique<OverwriteRing<Sample, 16>>();
+    OverwriteRing<Sample, 16>::Reader readers[2]{OverwriteRing<Sample, 16>::Reader{*ring}, OverwriteRing<Sample, 16>::Reader{*ring}};
+    std::atomic<std::size_t> running{producers};
+    std::vector<std::thread> threads;
+    for (std::size_t p = 0; p < producers; ++p)
+    {
+        threads.emplace_back([&, p] {
+            for (std::uint64_t i = 0; i < perProducer; ++i)
+            {
+                ring->push(sampleOf(p, i));
+            }
+            --running;
+        });
+    }
+
+    Checker checkers[2]{Checker{producers}, Checker{producers}};
+    std::uint64_t lost[2]{};
+    for (std::size_t r = 0; r < 2; ++r)
+    {
+        threads.emplace_back([&, r] {
+            auto& reader = readers[r];
+            while (running.load() != 0)
+            {
+                if (reader.drain(checkers[r]) == 0)
+                {
+                    std::this_thread::yield();
+                }
+            }
+            reader.drain(checkers[r]);
+            lost[r] = reader.lost() + (ring->pushed() - reader.position());
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    REQUIRE(ring->pushed() == producers * perProducer);
+    for (std::size_t r = 0; r < 2; ++r)
+    {
+        REQUIRE(checkers[r].torn == 0);
+        REQUIRE(checkers[r].unordered == 0);
+        REQUIRE(checkers[r].read > 0);
+        REQUIRE(checkers[r].read + lost[r] == producers * perProducer);
+    }
+
+    // A new reader gets the last 16 tickets, less any a producer dropped
+    OverwriteRing<Sample, 16>::Reader reader{*ring};
+    Checker checker{producers};
+    reader.drain(checker);
+    REQUIRE(checker.torn == 0);
+    REQUIRE(checker.read + reader.lost() + (ring->pushed() - reader.position()) == 16);
+}
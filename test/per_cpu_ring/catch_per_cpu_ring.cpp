@@ -0,0 +1,143 @@
+//
+// Test harnesses for PerCpuRing<T, N>
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#define CATCH_CONFIG_MAIN
+
+#include "per_cpu_ring.hpp"
+#include "catch.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace PC_NAMESPACE_NAME;
+
+namespace
+{
+    struct Sample
+    {
+        std::uint32_t producer;
+        std::uint32_t sequence;
+        std::uint64_t check;
+        double value;
+    };
+} // namespace
+
+TEST_CASE("utl.per_cpu_ring. Single thread")
+{
+    for (bool useRseq : {true, false})
+    {
+        auto ring = std::make_unique<PerCpuRing<Sample, 8>>(useRseq);
+        REQUIRE(ring->cpu_count() >= 1);
+        REQUIRE(ring->capacity() == 8);
+        if (!useRseq)
+        {
+            REQUIRE(!ring->uses_rseq());
+        }
+
+        for (std::uint32_t i = 0; i < 5; ++i)
+        {
+            REQUIRE(ring->push(Sample{0, i, ~std::uint64_t{i}, i * 0.5}));
+        }
+        REQUIRE(ring->size() == 5);
+
+        std::vector<std::uint32_t> sequences;
+        REQUIRE(ring->drain([&](Sample const& sample) {
+            REQUIRE(sample.check == ~std::uint64_t{sample.sequence});
+            REQUIRE(sample.value == sample.sequence * 0.5);
+            sequences.push_back(sample.sequence);
+        }) == 5);
+        REQUIRE(sequences == std::vector<std::uint32_t>{0, 1, 2, 3, 4});
+        REQUIRE(ring->size() == 0);
+        REQUIRE(ring->drain([](Sample const&) {}) == 0);
+    }
+}
+
+TEST_CASE("utl.per_cpu_ring. Full rings reject elements")
+{
+    for (bool useRseq : {true, false})
+    {
+        auto ring = std::make_unique<PerCpuRing<std::uint64_t, 4>>(useRseq);
+        // A migration between the pushes would spread them over several
+        // rings, so only the total is certain
+        std::uint64_t accepted = 0;
+        for (std::uint64_t i = 0; i < 4 * ring->cpu_count() + 10; ++i)
+        {
+            accepted += ring->push(i);
+        }
+        REQUIRE(accepted + ring->dropped() == 4 * ring->cpu_count() + 10);
+        REQUIRE(ring->dropped() >= 10);
+        REQUIRE(ring->drain([](std::uint64_t) {}) == accepted);
+        REQUIRE(ring->push(42));
+    }
+}
+
+TEST_CASE("utl.per_cpu_ring. Concurrent producers and collector")
+{
+    constexpr std::uint32_t producers = 8;
+    constexpr std::uint32_t perProducer = 50000;
+
+    for (bool useRseq : {true, false})
+    {
+        auto ring = std::make_unique<PerCpuRing<Sample, 256>>(useRseq);
+        std::atomic<std::uint32_t> running{producers};
+        std::vector<std::thread> threads;
+        for (std::uint32_t p = 0; p < producers; ++p)
+        {
+            threads.emplace_back([&, p] {
+                for (std::uint32_t i = 0; i < perProducer; ++i)
+                {
+                    // Retries until the collector made room
+                    while (!ring->push(Sample{p, i, ~std::uint64_t{i}, 1.0}))
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+                --running;
+            });
+        }
+
+        // Elements of a producer which migrated may arrive out of order, but
+        // every one exactly once
+        std::vector<std::vector<bool>> seen(producers, std::vector<bool>(perProducer));
+        std::uint64_t collected = 0;
+        std::uint64_t corrupt = 0;
+        std::uint64_t repeated = 0;
+        auto const collect = [&](Sample const& sample) {
+            ++collected;
+            if (sample.producer >= producers || sample.sequence >= perProducer || sample.check != ~std::uint64_t{sample.sequence} ||
+                sample.value != 1.0)
+            {
+                ++corrupt;
+                return;
+            }
+            repeated += seen[sample.producer][sample.sequence];
+            seen[sample.producer][sample.sequence] = true;
+        };
+        while (running.load() != 0)
+        {
+            if (ring->drain(collect) == 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        ring->drain(collect);
+
+        REQUIRE(collected == std::uint64_t{producers} * perProducer);
+        REQUIRE(corrupt == 0);
+        REQUIRE(repeated == 0);
+        REQUIRE(ring->size() == 0);
+    }
+}
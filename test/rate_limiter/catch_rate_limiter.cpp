@@ -0,0 +1,153 @@
+//
+// Test harnesses for SlidingWindowRateLimiter<N> and TokenBucket
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#define CATCH_CONFIG_MAIN
+
+#include "rate_limiter.hpp"
+#include "catch.hpp"
+
+#include <atomic>
+#include <deque>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace RL_NAMESPACE_NAME;
+
+TEST_CASE("utl.rate_limiter. Sliding window")
+{
+    SlidingWindowRateLimiter<3> limiter{100};
+
+    SECTION("At most N events per window")
+    {
+        REQUIRE(limiter.try_acquire(0));
+        REQUIRE(limiter.try_acquire(10));
+        REQUIRE(limiter.try_acquire(10));
+        REQUIRE(!limiter.try_acquire(50));
+        REQUIRE(limiter.next_available(50) == 100);
+        REQUIRE(limiter.next_available(50, 2) == 110);
+        REQUIRE(limiter.size(99) == 3);
+
+        // The event at 0 leaves the window at 100
+        REQUIRE(!limiter.try_acquire(99));
+        REQUIRE(limiter.try_acquire(100));
+        REQUIRE(!limiter.try_acquire(109));
+        REQUIRE(limiter.size(110) == 1);
+        REQUIRE(limiter.try_acquire(110, 2));
+        REQUIRE(!limiter.try_acquire(110));
+    }
+
+    SECTION("Batches are granted entirely or not at all")
+    {
+        REQUIRE(limiter.try_acquire(0, 2));
+        REQUIRE(!limiter.try_acquire(1, 2));
+        REQUIRE(limiter.size(1) == 2);
+        REQUIRE(limiter.try_acquire(1, 1));
+        REQUIRE(!limiter.try_acquire(1, 4));
+        REQUIRE(limiter.next_available(1, 3) == 101);
+    }
+
+    SECTION("Time going backwards")
+    {
+        REQUIRE(limiter.try_acquire(100));
+        REQUIRE(limiter.try_acquire(50));
+        REQUIRE(limiter.times().back() == 100);
+        REQUIRE(limiter.size(199) == 2);
+        REQUIRE(limiter.size(200) == 0);
+    }
+
+    SECTION("Matches counting the events of the window")
+    {
+        SlidingWindowRateLimiter<50> exact{1000};
+        std::deque<std::uint64_t> granted;
+        std::mt19937_64 gen{42};
+        std::uint64_t now = 0;
+        for (int i = 0; i < 100000; ++i)
+        {
+            now += gen() % 40;
+            auto const inWindow = std::count_if(granted.begin(), granted.end(), [&](auto t) { return now - t < 1000; });
+            auto const expected = inWindow < 50;
+            REQUIRE(exact.try_acquire(now) == expected);
+            if (expected)
+            {
+                granted.push_back(now);
+            }
+            if (granted.size() > 50)
+            {
+                granted.pop_front();
+            }
+        }
+    }
+}
+
+TEST_CASE("utl.rate_limiter. Token bucket")
+{
+    TokenBucket bucket{10, 5};
+    REQUIRE(bucket.burst() == 5);
+
+    SECTION("Burst and refill")
+    {
+        REQUIRE(bucket.available(1000) == 5);
+        for (int i = 0; i < 5; ++i)
+        {
+            REQUIRE(bucket.try_acquire(1000));
+        }
+        REQUIRE(!bucket.try_acquire(1000));
+        REQUIRE(bucket.available(1000) == 0);
+        REQUIRE(bucket.next_available(1000) == 1010);
+        REQUIRE(bucket.next_available(1000, 3) == 1030);
+
+        REQUIRE(!bucket.try_acquire(1009));
+        REQUIRE(bucket.try_acquire(1010));
+        REQUIRE(!bucket.try_acquire(1010));
+        REQUIRE(bucket.available(1025) == 1);
+
+        // Never more than burst tokens
+        REQUIRE(bucket.available(5000) == 5);
+        REQUIRE(!bucket.try_acquire(5000, 6));
+        REQUIRE(bucket.try_acquire(5000, 5));
+
+        bucket.reset();
+        REQUIRE(bucket.available(5000) == 5);
+    }
+
+    SECTION("Sustained rate")
+    {
+        std::uint64_t granted = 0;
+        for (std::uint64_t now = 1000; now < 11000; ++now)
+        {
+            granted += bucket.try_acquire(now);
+        }
+        // The burst plus one token every 10 ticks from 1010 to 10990
+        REQUIRE(granted == 5 + 999);
+    }
+
+    SECTION("Shared between threads")
+    {
+        TokenBucket shared{1, 10000};
+        std::atomic<std::uint64_t> granted{};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back([&] {
+                std::uint64_t count = 0;
+                for (int i = 0; i < 10000; ++i)
+                {
+                    count += shared.try_acquire(1000000);
+                }
+                granted += count;
+            });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        REQUIRE(granted == 10000);
+    }
+}
@@ -0,0 +1,231 @@
+//
+// Test harnesses for RecordRing and SpscRecordRing
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#define CATCH_CONFIG_MAIN
+
+#include "record_ring.hpp"
+#include "catch.hpp"
+
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace RR_NAMESPACE_NAME;
+
+namespace
+{
+    std::span<std::byte const> bytesOf(std::string_view s)
+    {
+        return std::as_bytes(std::span{s.data(), s.size()});
+    }
+
+    std::string stringOf(RecordView record)
+    {
+        return {reinterpret_cast<char const*>(record.payload.data()), record.payload.size()};
+    }
+} // namespace
+
+TEST_CASE("utl.record_ring. Push and pop")
+{
+    RecordRing ring{100};
+    REQUIRE(ring.capacity() == 128);
+    REQUIRE(ring.empty());
+    REQUIRE(ring.bytes() == 0);
+
+    REQUIRE(ring.push(1, bytesOf("hello")));
+    REQUIRE(ring.push(2, bytesOf("")));
+    REQUIRE(ring.push(3, bytesOf("a somewhat longer message")));
+    REQUIRE(ring.bytes() == RecordRing::recordSize(5) + RecordRing::recordSize(0) + RecordRing::recordSize(25));
+
+    REQUIRE(ring.front().type == 1);
+    REQUIRE(stringOf(ring.front()) == "hello");
+    REQUIRE(reinterpret_cast<std::uintptr_t>(ring.front().payload.data()) % RecordRing::alignment == 0);
+    ring.pop();
+    REQUIRE(ring.front().type == 2);
+    REQUIRE(ring.front().payload.empty());
+    ring.pop();
+    REQUIRE(stringOf(ring.front()) == "a somewhat longer message");
+    ring.pop();
+    REQUIRE(ring.empty());
+}
+
+TEST_CASE("utl.record_ring. Full ring")
+{
+    RecordRing ring{64};
+
+    // Records larger than the ring are rejected
+    REQUIRE(ring.reserve(ring.maxPayload() + 1).data() == nullptr);
+
+    // 3 records of 16 bytes, 16 bytes remain
+    for (std::uint32_t i = 0; i < 3; ++i)
+    {
+        REQUIRE(ring.push(i, bytesOf("12345678")));
+    }
+    REQUIRE_FALSE(ring.push(3, bytesOf("123456789")));
+    REQUIRE(ring.push(3, bytesOf("1234")));
+    REQUIRE_FALSE(ring.push(4, bytesOf("")));
+    REQUIRE(ring.bytes() == ring.capacity());
+
+    ring.pop();
+    REQUIRE(ring.push(4, bytesOf("")));
+}
+
+TEST_CASE("utl.record_ring. Empty ring with the tail mid-buffer")
+{
+    SECTION("Single threaded ring starts over at offset 0")
+    {
+        RecordRing ring{1024};
+        REQUIRE(ring.maxPayload() == 1016);
+        REQUIRE(ring.push(1, bytesOf(std::string(504, 'a'))));
+        ring.pop();
+        REQUIRE(ring.empty());
+
+        REQUIRE(ring.push(2, bytesOf(std::string(600, 'b'))));
+        REQUIRE(stringOf(ring.front()) == std::string(600, 'b'));
+        ring.pop();
+        REQUIRE(ring.push(3, bytesOf(std::string(ring.maxPayload(), 'c'))));
+        REQUIRE(ring.bytes() == ring.capacity());
+    }
+
+    SECTION("Shared ring limits records to half the capacity")
+    {
+        SpscRecordRing ring{1024};
+        REQUIRE(ring.maxPayload() == 504);
+        REQUIRE(ring.reserve(ring.maxPayload() + 1).data() == nullptr);
+
+        // Any record up to maxPayload() fits into the empty ring wherever the tail is
+        for (std::size_t first = 0; first <= ring.maxPayload(); first += 8)
+        {
+            REQUIRE(ring.push(1, bytesOf(std::string(first, 'a'))));
+            ring.pop();
+            REQUIRE(ring.empty());
+            REQUIRE(ring.push(2, bytesOf(std::string(ring.maxPayload(), 'b'))));
+            ring.pop();
+        }
+    }
+}
+
+TEST_CASE("utl.record_ring. Wrapping records are padded")
+{
+    RecordRing ring{64};
+
+    REQUIRE(ring.push(1, bytesOf(std::string(20, 'a')))); // 32 bytes
+    REQUIRE(ring.push(2, bytesOf(std::string(8, 'b'))));  // 16 bytes, 16 bytes left at the end
+    ring.pop();
+
+    // 24 bytes do not fit into the 16 bytes at the end, they go to the front
+    REQUIRE(ring.push(3, bytesOf(std::string(16, 'c'))));
+    REQUIRE(ring.bytes() == 16 + 16 + 24);
+
+    std::vector<std::uint32_t> types;
+    for (auto record : ring)
+    {
+        types.push_back(record.type);
+        REQUIRE(record.payload.size() == (record.type == 2 ? 8 : 16));
+    }
+    REQUIRE(types == std::vector<std::uint32_t>{2, 3});
+
+    ring.pop();
+    REQUIRE(ring.front().type == 3);
+    REQUIRE(stringOf(ring.front()) == std::string(16, 'c'));
+    ring.pop();
+    REQUIRE(ring.empty());
+}
+
+TEST_CASE("utl.record_ring. Reserve and commit in place")
+{
+    struct Order
+    {
+        std::uint64_t id;
+        double price;
+    };
+
+    RecordRing ring{256};
+    for (std::uint64_t id = 0; id < 100; ++id)
+    {
+        auto space = ring.reserve(sizeof(Order));
+        REQUIRE(space.size() == sizeof(Order));
+        std::construct_at(reinterpret_cast<Order*>(space.data()), Order{id, id * 0.5});
+        ring.commit(7);
+
+        // Reserve more than needed and commit less
+        space = ring.reserve(64);
+        REQUIRE(space.data() != nullptr);
+        space[0] = std::byte{42};
+        ring.commit(8, 1);
+
+        std::size_t consumed = ring.consume([&](RecordView record) {
+            if (record.type == 7)
+            {
+                REQUIRE(record.as<Order>()->id == id);
+                REQUIRE(record.as<Order>()->price == id * 0.5);
+            }
+            else
+            {
+                REQUIRE(record.type == 8);
+                REQUIRE(record.payload.size() == 1);
+                REQUIRE(record.payload[0] == std::byte{42});
+            }
+        });
+        REQUIRE(consumed == 2);
+        REQUIRE(ring.empty());
+    }
+}
+
+TEST_CASE("utl.record_ring. Consume a limited number of records")
+{
+    RecordRing ring{1024};
+    for (std::uint32_t i = 0; i < 10; ++i)
+    {
+        REQUIRE(ring.push(i, bytesOf(std::string(i, 'x'))));
+    }
+    std::uint32_t expected = 0;
+    REQUIRE(ring.consume([&](RecordView record) { REQUIRE(record.type == expected++); }, 4) == 4);
+    REQUIRE(ring.front().type == 4);
+    REQUIRE(ring.consume([&](RecordView record) { REQUIRE(record.type == expected++); }) == 6);
+    REQUIRE(ring.empty());
+}
+
+TEST_CASE("utl.record_ring. SPSC")
+{
+    SpscRecordRing ring{4096};
+    constexpr std::uint32_t count = 200000;
+
+    std::thread producer{[&] {
+        std::vector<std::byte> payload(300);
+        for (std::uint32_t i = 0; i < count; ++i)
+        {
+            auto const length = (i * 7919) % payload.size();
+            std::memcpy(payload.data(), &i, sizeof(i));
+            while (!ring.push(i, std::span{payload.data(), std::max<std::size_t>(length, sizeof(i))}))
+            {
+                std::this_thread::yield();
+            }
+        }
+    }};
+
+    std::uint32_t expected = 0;
+    bool ok = true;
+    while (expected < count)
+    {
+        ring.consume([&](RecordView record) {
+            std::uint32_t value;
+            std::memcpy(&value, record.payload.data(), sizeof(value));
+            ok = ok && record.type == expected && value == expected &&
+                 record.payload.size() == std::max<std::size_t>((expected * 7919) % 300, sizeof(value));
+            ++expected;
+        });
+    }
+    producer.join();
+
+    REQUIRE(ok);
+    REQUIRE(ring.empty());
+}
@@ -0,0 +1,164 @@
+//
+// Test harnesses for ReorderBuffer<T, N>
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#define CATCH_CONFIG_MAIN
+
+#include "reorder_buffer.hpp"
+#include "catch.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace RO_NAMESPACE_NAME;
+
+namespace
+{
+    // Element class counting live instances
+    struct Element
+    {
+        static inline int instances = 0;
+
+        std::uint64_t seq;
+        std::string text;
+
+        Element(std::uint64_t s, std::string t)
+            : seq{s}
+            , text{std::move(t)}
+        {
+            ++instances;
+        }
+
+        Element(Element&& other) noexcept
+            : seq{other.seq}
+            , text{std::move(other.text)}
+        {
+            ++instances;
+        }
+
+        ~Element()
+        {
+            --instances;
+        }
+    };
+} // namespace
+
+TEST_CASE("utl.reorder_buffer. Elements are released in sequence")
+{
+    {
+        ReorderBuffer<Element, 8> buffer{100};
+        REQUIRE(buffer.expected() == 100);
+        REQUIRE(buffer.capacity() == 8);
+        REQUIRE(buffer.empty());
+
+        std::vector<std::uint64_t> released;
+        auto const collect = [&](Element&& e) { released.push_back(e.seq); };
+
+        REQUIRE(buffer.emplace(102, 102, "c") == ReorderStatus::accepted);
+        REQUIRE(buffer.emplace(101, 101, "b") == ReorderStatus::accepted);
+        REQUIRE(buffer.emplace(101, 101, "b") == ReorderStatus::duplicate);
+        REQUIRE(buffer.emplace(108, 108, "i") == ReorderStatus::ahead);
+        REQUIRE(buffer.emplace(99, 99, "x") == ReorderStatus::late);
+        REQUIRE(buffer.size() == 2);
+        REQUIRE(buffer.contains(102));
+        REQUIRE(!buffer.contains(100));
+        REQUIRE(Element::instances == 2);
+
+        // 100 is missing
+        REQUIRE(buffer.drain(collect) == 0);
+        REQUIRE(buffer.push(100, Element{100, "a"}) == ReorderStatus::accepted);
+        REQUIRE(buffer.drain(collect) == 3);
+        REQUIRE(released == std::vector<std::uint64_t>{100, 101, 102});
+        REQUIRE(buffer.expected() == 103);
+        REQUIRE(buffer.empty());
+        REQUIRE(Element::instances == 0);
+
+        // Slots are reused as the window moves
+        REQUIRE(buffer.emplace(110, 110, "k") == ReorderStatus::accepted);
+        REQUIRE(buffer.emplace(105, 105, "f") == ReorderStatus::accepted);
+        buffer.skip_to(106);
+        REQUIRE(buffer.expected() == 106);
+        REQUIRE(buffer.size() == 1);
+        REQUIRE(Element::instances == 1);
+        REQUIRE(buffer.emplace(113, 113, "n") == ReorderStatus::accepted);
+        REQUIRE(buffer.size() == 2);
+    }
+    REQUIRE(Element::instances == 0);
+}
+
+TEST_CASE("utl.reorder_buffer. Gaps time out")
+{
+    ReorderBuffer<int, 100> buffer;
+    std::vector<int> released;
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> gaps;
+    auto const collect = [&](int&& value) { released.push_back(value); };
+    auto const report = [&](std::uint64_t first, std::uint64_t last) { gaps.emplace_back(first, last); };
+
+    buffer.push(0, 0);
+    buffer.push(3, 3);
+    buffer.push(4, 4);
+    buffer.push(90, 90);
+
+    REQUIRE(buffer.drain(1000, 50, collect, report) == 1);
+    REQUIRE(gaps.empty());
+    REQUIRE(buffer.drain(1049, 50, collect, report) == 0);
+
+    // The gap has been open since 1000
+    REQUIRE(buffer.drain(1050, 50, collect, report) == 2);
+    REQUIRE(gaps == std::vector<std::pair<std::uint64_t, std::uint64_t>>{{1, 3}});
+    REQUIRE(buffer.expected() == 5);
+
+    // A new gap starts now
+    REQUIRE(buffer.drain(1051, 50, collect, report) == 0);
+    buffer.push(5, 5);
+    REQUIRE(buffer.drain(1060, 50, collect, report) == 1);
+    REQUIRE(buffer.drain(1100, 50, collect, report) == 0);
+    REQUIRE(buffer.drain(1110, 50, collect, report) == 1);
+    REQUIRE(gaps.back() == std::pair<std::uint64_t, std::uint64_t>{6, 90});
+    REQUIRE(released == std::vector<int>{0, 3, 4, 5, 90});
+    REQUIRE(buffer.empty());
+    REQUIRE(buffer.expected() == 91);
+
+    // With a timeout of 0 everything buffered is released at once
+    buffer.push(95, 95);
+    buffer.push(93, 93);
+    REQUIRE(buffer.drain(0, 0, collect, report) == 2);
+    REQUIRE(gaps.size() == 4);
+}
+
+TEST_CASE("utl.reorder_buffer. Shuffled sequence")
+{
+    constexpr std::size_t depth = 300;
+    auto buffer = std::make_unique<ReorderBuffer<std::uint64_t, 512>>();
+    std::mt19937 random{42};
+
+    // Every element is displaced by up to depth positions
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> arrivals;
+    for (std::uint64_t seq = 0; seq < 100000; ++seq)
+    {
+        arrivals.emplace_back(seq + random() % depth, seq);
+    }
+    std::sort(arrivals.begin(), arrivals.end());
+
+    std::uint64_t next = 0;
+    std::size_t failures = 0;
+    for (auto const& [key, seq] : arrivals)
+    {
+        REQUIRE(buffer->push(seq, seq) == ReorderStatus::accepted);
+        buffer->drain([&](std::uint64_t value) { failures += value != next++; });
+        REQUIRE(buffer->size() <= depth);
+    }
+    REQUIRE(failures == 0);
+    REQUIRE(next == 100000);
+    REQUIRE(buffer->empty());
+}
@@ -15,6 +15,7 @@
 #include <algorithm>
 #include <numeric>
 #include <array>
+#include <vector>
 
 using namespace RB_NAMESPACE_NAME;
 
@@ -204,4 +205,339 @@ TEST_CASE("utl.ring_buffer. Iteration")
             REQUIRE(it[index].val == (index + 1));
         }
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("utl.ring_buffer. Contiguous segments and bulk pop")
+{
+    RingBuffer<int, 5> rb;
+    REQUIRE(rb.array_one().empty());
+    REQUIRE(rb.array_two().empty());
+
+    for (int i = 1; i <= 4; ++i)
+    {
+        rb.push(i);
+    }
+    REQUIRE(std::vector<int>(rb.array_one().begin(), rb.array_one().end()) == std::vector<int>{1, 2, 3, 4});
+    REQUIRE(rb.array_two().empty());
+
+    rb.pop(3);
+    REQUIRE(rb.size() == 1);
+    REQUIRE(rb.front() == 4);
+
+    // Wrap around the end of the storage
+    for (int i = 5; i <= 8; ++i)
+    {
+        rb.push(i);
+    }
+    REQUIRE(rb.full());
+    REQUIRE(rb.array_one().size() + rb.array_two().size() == 5);
+    REQUIRE(std::vector<int>(rb.array_one().begin(), rb.array_one().end()) == std::vector<int>{4, 5, 6});
+    REQUIRE(std::vector<int>(rb.array_two().begin(), rb.array_two().end()) == std::vector<int>{7, 8});
+
+    rb.pop(4);
+    REQUIRE(rb.size() == 1);
+    REQUIRE(rb.front() == 8);
+    REQUIRE(rb.array_one().size() == 1);
+    REQUIRE(rb.array_two().empty());
+
+    // At most size() elements are removed
+    rb.pop(10);
+    REQUIRE(rb.empty());
+
+    RingBuffer<Element, 3> elements;
+    elements.push(1);
+    elements.push(2);
+    elements.push(3);
+    elements.pop(2);
+    REQUIRE(elements.size() == 1);
+    REQUIRE(elements.front().val == 3);
+}
+
+TEST_CASE("utl.ring_buffer. Sequenced mode")
+{
+    static_assert(!RingBuffer<int, 4>::sequenced);
+
+    RingBuffer<int, 4, RingBufferSequence> rb;
+    REQUIRE(rb.at_seq(0) == nullptr);
+    REQUIRE(rb.iterate_from(0) == rb.end());
+
+    for (int i = 0; i < 3; ++i)
+    {
+        rb.push(i * 10);
+    }
+    REQUIRE(rb.policy().tail_seq() == 0);
+    REQUIRE(rb.policy().head_seq() == 3);
+    REQUIRE(*rb.at_seq(2) == 20);
+    REQUIRE(rb.at_seq(3) == nullptr);
+
+    // Sequence numbers survive pops and overwrites
+    rb.pop();
+    for (int i = 3; i < 7; ++i)
+    {
+        rb.push(i * 10);
+    }
+    REQUIRE(rb.full());
+    REQUIRE(rb.policy().tail_seq() == 3);
+    REQUIRE(rb.policy().head_seq() == 7);
+    REQUIRE(rb.at_seq(2) == nullptr);
+    REQUIRE(*rb.at_seq(3) == 30);
+    REQUIRE(*rb.at_seq(6) == 60);
+    *rb.at_seq(4) = 41;
+
+    std::vector<int> const resumed(rb.iterate_from(4), rb.end());
+    REQUIRE(resumed == std::vector<int>{41, 50, 60});
+    auto const& crb = rb;
+    REQUIRE(*crb.iterate_from(0) == 30);
+    REQUIRE(crb.iterate_from(100) == crb.end());
+    REQUIRE(*crb.at_seq(5) == 50);
+
+    rb.pop(2);
+    REQUIRE(rb.at_seq(4) == nullptr);
+    REQUIRE(*rb.at_seq(5) == 50);
+
+    rb.policy().renumber(1000);
+    REQUIRE(rb.policy().head_seq() == 1002);
+    REQUIRE(*rb.at_seq(1001) == 60);
+
+    rb.clear();
+    REQUIRE(rb.policy().tail_seq() == 1002);
+    rb.push(70);
+    REQUIRE(*rb.at_seq(1002) == 70);
+}
+
+#ifdef RB_HAS_VECTORED_IO
+#include <unistd.h>
+#include <fcntl.h>
+#include <string>
+#include <cstdio>
+
+TEST_CASE("utl.ring_buffer. Vectored I/O")
+{
+    int fds[2];
+    REQUIRE(::pipe(fds) == 0);
+    ::fcntl(fds[0], F_SETFL, O_NONBLOCK);
+
+    auto const sendToRing = [&](std::string const& s) {
+        REQUIRE(::write(fds[1], s.data(), s.size()) == static_cast<ssize_t>(s.size()));
+    };
+    auto const receiveFromRing = [&](std::size_t count) {
+        std::string s(count, '\0');
+        REQUIRE(::read(fds[0], s.data(), count) == static_cast<ssize_t>(count));
+        return s;
+    };
+
+    RingBuffer<char, 8> rb;
+
+    SECTION("Partial read into an empty ring buffer")
+    {
+        sendToRing("abc");
+        REQUIRE(rb.read_from(fds[0]) == 3);
+        REQUIRE(rb.size() == 3);
+        REQUIRE(std::string(rb.begin(), rb.end()) == "abc");
+
+        // Nothing left in the pipe
+        REQUIRE(rb.read_from(fds[0]) == -1);
+        REQUIRE(errno == EAGAIN);
+        REQUIRE(rb.size() == 3);
+    }
+
+    SECTION("Read is limited by max and the free space")
+    {
+        sendToRing("0123456789");
+        REQUIRE(rb.read_from(fds[0], 2) == 2);
+        REQUIRE(rb.read_from(fds[0]) == 6);
+        REQUIRE(rb.full());
+        REQUIRE(rb.read_from(fds[0]) == 0);
+        REQUIRE(std::string(rb.begin(), rb.end()) == "01234567");
+
+        // The remaining bytes stay in the pipe
+        rb.clear();
+        REQUIRE(rb.read_from(fds[0]) == 2);
+        REQUIRE(std::string(rb.begin(), rb.end()) == "89");
+    }
+
+    SECTION("Read and write across the end of the storage")
+    {
+        for (char c : std::string{"uvwxyz"})
+        {
+            rb.push(c);
+        }
+        for (int i = 0; i < 5; ++i)
+        {
+            rb.pop();
+        }
+        REQUIRE(rb.front() == 'z');
+
+        sendToRing("0123456789");
+        REQUIRE(rb.read_from(fds[0]) == 7);
+        REQUIRE(rb.full());
+        REQUIRE(std::string(rb.begin(), rb.end()) == "z0123456");
+
+        REQUIRE(rb.write_to(fds[1], 3) == 3);
+        REQUIRE(rb.size() == 5);
+        REQUIRE(rb.write_to(fds[1]) == 5);
+        REQUIRE(rb.empty());
+        REQUIRE(rb.write_to(fds[1]) == 0);
+
+        REQUIRE(receiveFromRing(3) == "789"); // left over from sendToRing
+        REQUIRE(receiveFromRing(8) == "z0123456");
+    }
+
+    SECTION("End of file")
+    {
+        ::close(fds[1]);
+        fds[1] = -1;
+        REQUIRE(rb.read_from(fds[0]) == 0);
+        REQUIRE(rb.empty());
+    }
+
+    SECTION("std::byte ring buffer")
+    {
+        RingBuffer<std::byte, 4> bytes;
+        sendToRing("\x01\x02\x03");
+        REQUIRE(bytes.read_from(fds[0]) == 3);
+        REQUIRE(bytes.front() == std::byte{1});
+        REQUIRE(bytes.back() == std::byte{3});
+        REQUIRE(bytes.write_to(fds[1], 1) == 1);
+        REQUIRE(bytes.front() == std::byte{2});
+        REQUIRE(receiveFromRing(1) == "\x01");
+    }
+
+    ::close(fds[0]);
+    if (fds[1] != -1)
+    {
+        ::close(fds[1]);
+    }
+}
+TEST_CASE("utl.ring_buffer. Snapshots")
+{
+    auto const file = std::tmpfile();
+    REQUIRE(file != nullptr);
+    auto const fd = ::fileno(file);
+    auto const rewind = [&] { REQUIRE(::lseek(fd, 0, SEEK_SET) == 0); };
+
+    // Wrapped around the end of the storage
+    RingBuffer<int, 8> rb;
+    for (int i = 0; i < 7; ++i)
+    {
+        rb.push(i);
+    }
+    rb.pop(5);
+    for (int i = 7; i < 11; ++i)
+    {
+        rb.push(i);
+    }
+    REQUIRE(!rb.array_two().empty());
+
+    SECTION("Round trip")
+    {
+        REQUIRE(rb.save_to(fd));
+        REQUIRE(rb.size() == 6);
+        rewind();
+
+        RingBuffer<int, 16> restored;
+        restored.push(99);
+        REQUIRE(restored.restore_from(fd));
+        REQUIRE(std::vector<int>(restored.begin(), restored.end()) == std::vector<int>{5, 6, 7, 8, 9, 10});
+        REQUIRE(restored.array_two().empty());
+        restored.push(11);
+        REQUIRE(restored.back() == 11);
+        REQUIRE(restored.size() == 7);
+    }
+
+    SECTION("Empty ring buffer")
+    {
+        rb.clear();
+        REQUIRE(rb.save_to(fd));
+        rewind();
+        RingBuffer<int, 8> restored;
+        restored.push(1);
+        REQUIRE(restored.restore_from(fd));
+        REQUIRE(restored.empty());
+    }
+
+    SECTION("Mismatching snapshots are rejected")
+    {
+        REQUIRE(rb.save_to(fd));
+
+        rewind();
+        RingBuffer<int, 4> small;
+        REQUIRE(!small.restore_from(fd));
+        REQUIRE(errno == EINVAL);
+
+        rewind();
+        RingBuffer<long long, 8> wide;
+        REQUIRE(!wide.restore_from(fd));
+        REQUIRE(errno == EINVAL);
+
+        // A flipped payload byte fails the checksum
+        char byte;
+        REQUIRE(::pread(fd, &byte, 1, sizeof(RingBufferSnapshotHeader) + 5) == 1);
+        byte ^= 0x10;
+        REQUIRE(::pwrite(fd, &byte, 1, sizeof(RingBufferSnapshotHeader) + 5) == 1);
+        rewind();
+        RingBuffer<int, 8> restored;
+        REQUIRE(!restored.restore_from(fd));
+        REQUIRE(errno == EINVAL);
+        REQUIRE(restored.empty());
+
+        // Truncated
+        REQUIRE(::ftruncate(fd, sizeof(RingBufferSnapshotHeader) + 4) == 0);
+        rewind();
+        REQUIRE(!restored.restore_from(fd));
+        REQUIRE(restored.empty());
+    }
+
+    SECTION("Serialized elements")
+    {
+        RingBuffer<std::string, 4> strings;
+        for (auto const s : {"zero", "", "two", "three", "four"})
+        {
+            strings.push(s);
+        }
+        auto const serialize = [](std::string const& s) { return std::as_bytes(std::span{s}); };
+        REQUIRE(strings.save_to(fd, serialize));
+        rewind();
+
+        RingBuffer<std::string, 4> restored;
+        REQUIRE(restored.restore_from(fd, [](std::span<std::byte const> bytes) {
+            return std::string(reinterpret_cast<char const*>(bytes.data()), bytes.size());
+        }));
+        REQUIRE(std::vector<std::string>(restored.begin(), restored.end()) == std::vector<std::string>{"", "two", "three", "four"});
+
+        // Raw and serialized snapshots do not mix
+        rewind();
+        RingBuffer<int, 8> raw;
+        REQUIRE(!raw.restore_from(fd));
+        REQUIRE(errno == EINVAL);
+    }
+
+    SECTION("Corrupt headers are rejected before allocating")
+    {
+        auto const deserialize = [](std::span<std::byte const> bytes) { return bytes.size(); };
+        auto const writeHeader = [&](RingBufferSnapshotHeader const& header) {
+            REQUIRE(::ftruncate(fd, 0) == 0);
+            REQUIRE(::pwrite(fd, &header, sizeof header, 0) == sizeof header);
+            rewind();
+        };
+
+        RingBuffer<std::size_t, 8> restored;
+        writeHeader({RingBufferSnapshotHeader::signature, 16, 0, 0, 0, 0});
+        REQUIRE(!restored.restore_from(fd, deserialize));
+        REQUIRE(errno == EINVAL);
+
+        writeHeader({RingBufferSnapshotHeader::signature, 8, 0, 2, std::uint64_t{1} << 60, 0});
+        REQUIRE(!restored.restore_from(fd, deserialize));
+        REQUIRE(errno == EINVAL);
+
+        RingBuffer<int, 8> raw;
+        writeHeader({RingBufferSnapshotHeader::signature, 16, sizeof(int), 4, 4 * sizeof(int), 0});
+        REQUIRE(!raw.restore_from(fd));
+        REQUIRE(errno == EINVAL);
+        REQUIRE(restored.empty());
+        REQUIRE(raw.empty());
+    }
+
+    std::fclose(file);
+}
+#endif // RB_HAS_VECTORED_IO
@@ -0,0 +1,124 @@
+//
+// Test harnesses for RingBufferStats
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#define CATCH_CONFIG_MAIN
+
+#include "ring_buffer_stats.hpp"
+#include "ring_buffer.hpp"
+#include "catch.hpp"
+
+using namespace RS_NAMESPACE_NAME;
+
+// Clock advanced manually by the tests
+struct ManualClock
+{
+    static inline std::uint64_t ticks = 0;
+
+    static std::uint64_t now() noexcept
+    {
+        return ticks;
+    }
+
+    static double nanosecondsPerTick() noexcept
+    {
+        return 1.0;
+    }
+};
+
+template<std::size_t Slots>
+using ManualStats = RingBufferStats<Slots, ManualClock>;
+
+TEST_CASE("utl.ring_buffer_stats. Counters")
+{
+    RingBuffer<int, 4, ManualStats> rb;
+
+    auto stats = rb.policy().snapshot();
+    REQUIRE(stats.pushes == 0);
+    REQUIRE(stats.pops == 0);
+    REQUIRE(stats.overwrites == 0);
+    REQUIRE(stats.size == 0);
+    REQUIRE(stats.highWaterMark == 0);
+    REQUIRE(stats.capacity == 4);
+
+    SECTION("Push and pop")
+    {
+        rb.push(1);
+        rb.push(2);
+        rb.push(3);
+        rb.pop();
+        stats = rb.policy().snapshot();
+        REQUIRE(stats.pushes == 3);
+        REQUIRE(stats.pops == 1);
+        REQUIRE(stats.overwrites == 0);
+        REQUIRE(stats.size == rb.size());
+        REQUIRE(stats.highWaterMark == 3);
+    }
+
+    SECTION("Overwrites are counted")
+    {
+        for (int i = 0; i < 10; ++i)
+        {
+            rb.push(i);
+        }
+        stats = rb.policy().snapshot();
+        REQUIRE(stats.pushes == 10);
+        REQUIRE(stats.overwrites == 6);
+        REQUIRE(stats.size == 4);
+        REQUIRE(stats.highWaterMark == 4);
+
+        rb.clear();
+        stats = rb.policy().snapshot();
+        REQUIRE(stats.pops == 4);
+        REQUIRE(stats.size == 0);
+        REQUIRE(stats.highWaterMark == 4);
+    }
+
+    SECTION("Reset")
+    {
+        rb.push(1);
+        rb.push(2);
+        rb.push(3);
+        rb.pop();
+        rb.policy().reset();
+        stats = rb.policy().snapshot();
+        REQUIRE(stats.pushes == 0);
+        REQUIRE(stats.pops == 0);
+        REQUIRE(stats.size == 2);
+        REQUIRE(stats.highWaterMark == 2);
+    }
+}
+
+TEST_CASE("utl.ring_buffer_stats. Time-weighted occupancy")
+{
+    ManualClock::ticks = 1000;
+    RingBuffer<int, 8, ManualStats> rb;
+
+    // 0 elements for 10 ticks, 1 for 10 ticks, 3 for 20 ticks
+    ManualClock::ticks += 10;
+    rb.push(1);
+    ManualClock::ticks += 10;
+    rb.push(2);
+    rb.push(3);
+    ManualClock::ticks += 20;
+
+    auto stats = rb.policy().snapshot();
+    REQUIRE(stats.averageOccupancy == Approx((0.0 * 10 + 1.0 * 10 + 3.0 * 20) / 40));
+    REQUIRE(stats.averageUtilization() == Approx(stats.averageOccupancy / 8));
+
+    // Empty for another 40 ticks halves the average
+    rb.clear();
+    ManualClock::ticks += 40;
+    stats = rb.policy().snapshot();
+    REQUIRE(stats.averageOccupancy == Approx(70.0 / 80));
+
+    rb.policy().reset();
+    rb.push(1);
+    ManualClock::ticks += 5;
+    REQUIRE(rb.policy().snapshot().averageOccupancy == Approx(1.0));
+}
@@ -0,0 +1,175 @@
+//
+// Test harnesses for the ring_simd kernels
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#define CATCH_CONFIG_MAIN
+
+#include "ring_simd.hpp"
+#include "catch.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace RV_NAMESPACE_NAME;
+
+namespace
+{
+    std::vector<SimdLevel> supportedLevels()
+    {
+        std::vector<SimdLevel> result;
+        for (auto level : {SimdLevel::scalar, SimdLevel::sse, SimdLevel::avx2, SimdLevel::avx512})
+        {
+            if (level <= simd_level())
+            {
+                result.push_back(level);
+            }
+        }
+        return result;
+    }
+
+    // Fills ring with values, starting at slot front so that they wrap around
+    template<std::size_t N>
+    void fillWrapped(RingBuffer<double, N>& ring, std::vector<double> const& values, std::size_t front)
+    {
+        for (std::size_t i = 0; i < front; ++i)
+        {
+            ring.push(0.0);
+        }
+        ring.pop(front);
+        for (auto const value : values)
+        {
+            ring.push(value);
+        }
+    }
+
+    template<typename Predicate>
+    std::size_t expectedFind(std::vector<double> const& values, Predicate predicate)
+    {
+        return static_cast<std::size_t>(std::find_if(values.begin(), values.end(), predicate) - values.begin());
+    }
+} // namespace
+
+TEST_CASE("utl.ring_simd. Reductions and searches agree with std algorithms")
+{
+    std::mt19937_64 gen{42};
+    std::uniform_int_distribution<int> values{-500, 500};
+    for (auto const level : supportedLevels())
+    {
+        for (std::size_t size : {0, 1, 3, 4, 7, 8, 15, 16, 17, 31, 32, 33, 63, 100, 1000})
+        {
+            std::vector<double> data(size);
+            for (auto& value : data)
+            {
+                value = values(gen) / 4.0;
+            }
+            for (std::size_t front : {0, 1, 5, 999})
+            {
+                auto ring = std::make_unique<RingBuffer<double, 1000>>();
+                fillWrapped(*ring, data, front);
+                REQUIRE(ring->size() == size);
+
+                // Quarters are exact, so is their sum in any order
+                REQUIRE(ring_simd::sum(*ring, level) == std::accumulate(data.begin(), data.end(), 0.0));
+                auto const minimum = std::min_element(data.begin(), data.end());
+                auto const maximum = std::max_element(data.begin(), data.end());
+                REQUIRE(ring_simd::min(*ring, level) == (size == 0 ? std::numeric_limits<double>::infinity() : *minimum));
+                REQUIRE(ring_simd::max(*ring, level) == (size == 0 ? -std::numeric_limits<double>::infinity() : *maximum));
+                REQUIRE(ring_simd::argmin(*ring, level) == static_cast<std::size_t>(minimum - data.begin()));
+                REQUIRE(ring_simd::argmax(*ring, level) == static_cast<std::size_t>(maximum - data.begin()));
+
+                for (double threshold : {-200.0, 0.0, 12.25, 124.75})
+                {
+                    using ring_simd::Compare;
+                    auto const check = [&](Compare compare, auto predicate) {
+                        auto const matches = [&](double x) { return predicate(x, threshold); };
+                        REQUIRE(ring_simd::find_if(*ring, compare, threshold, level) == expectedFind(data, matches));
+                        REQUIRE(ring_simd::count_if(*ring, compare, threshold, level) ==
+                                static_cast<std::size_t>(std::count_if(data.begin(), data.end(), matches)));
+                    };
+                    check(Compare::less, std::less<>{});
+                    check(Compare::less_equal, std::less_equal<>{});
+                    check(Compare::greater, std::greater<>{});
+                    check(Compare::greater_equal, std::greater_equal<>{});
+                    check(Compare::equal, std::equal_to<>{});
+                    check(Compare::not_equal, std::not_equal_to<>{});
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("utl.ring_simd. Sums of arbitrary values")
+{
+    std::mt19937_64 gen{7};
+    std::uniform_real_distribution<double> values{-1.0, 1.0};
+    std::vector<double> data(4099);
+    for (auto& value : data)
+    {
+        value = values(gen);
+    }
+    auto const expected = std::accumulate(data.begin(), data.end(), 0.0);
+    for (auto const level : supportedLevels())
+    {
+        REQUIRE(std::abs(ring_simd::sum(data, level) - expected) < 1e-9);
+    }
+}
+
+TEST_CASE("utl.ring_simd. Histograms")
+{
+    std::mt19937_64 gen{3};
+    std::uniform_real_distribution<double> values{-2.0, 12.0};
+    std::vector<double> data(1001);
+    for (auto& value : data)
+    {
+        value = values(gen);
+    }
+    // Bin boundaries and both ends of the range
+    data[10] = 0.0;
+    data[11] = 10.0;
+    data[12] = 2.5;
+    data[13] = std::nextafter(10.0, 0.0);
+
+    double const low = 0.0;
+    double const high = 10.0;
+    std::vector<std::uint64_t> expected(4);
+    std::size_t inside = 0;
+    for (auto const value : data)
+    {
+        if (value >= low && value < high)
+        {
+            ++expected[std::min(static_cast<std::size_t>((value - low) * (4 / (high - low))), std::size_t{3})];
+            ++inside;
+        }
+    }
+    REQUIRE(std::accumulate(expected.begin(), expected.end(), std::uint64_t{}) == inside);
+
+    for (auto const level : supportedLevels())
+    {
+        auto ring = std::make_unique<RingBuffer<double, 1024>>();
+        fillWrapped(*ring, data, 700);
+
+        std::vector<std::uint64_t> bins(4);
+        REQUIRE(ring_simd::histogram(*ring, low, high, bins, level) == inside);
+        REQUIRE(bins == expected);
+
+        // Adds to the counts
+        REQUIRE(ring_simd::histogram(data, low, high, bins, level) == inside);
+        REQUIRE(bins[0] == 2 * expected[0]);
+
+        // Nothing to count into
+        REQUIRE(ring_simd::histogram(data, low, high, {}, level) == 0);
+        REQUIRE(ring_simd::histogram(data, high, low, bins, level) == 0);
+    }
+}
@@ -0,0 +1,251 @@
+//
+// Test harnesses for RoundRobinStore<T, N, Levels>
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#define CATCH_CONFIG_MAIN
+
+#include "round_robin_store.hpp"
+#include "catch.hpp"
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace RD_NAMESPACE_NAME;
+
+namespace
+{
+    template<typename T>
+    std::vector<RoundRobinRow<T>> rowsOf(RoundRobinRange<T> const& range)
+    {
+        std::vector<RoundRobinRow<T>> result(range.first.begin(), range.first.end());
+        result.insert(result.end(), range.second.begin(), range.second.end());
+        return result;
+    }
+} // namespace
+
+TEST_CASE("utl.round_robin_store. Levels consolidate the level below")
+{
+    RoundRobinStore<int, 64, 3> rrd{{1, 10, 100}};
+    REQUIRE(rrd.levels() == 3);
+    REQUIRE(rrd.capacity() == 64);
+    REQUIRE(rrd.step(1) == 10);
+    REQUIRE(rrd.level(0).empty());
+    REQUIRE(rrd.open(0).count == 0);
+
+    for (int t = 0; t < 250; ++t)
+    {
+        rrd.push(static_cast<std::uint64_t>(t), t);
+    }
+
+    // The newest step of every level is still open
+    REQUIRE(rrd.level(0).size() == 64);
+    REQUIRE(rrd.level(0).back().time == 248);
+    REQUIRE(rrd.open(0).time == 249);
+    REQUIRE(rrd.level(1).size() == 24);
+    REQUIRE(rrd.level(1).back().time == 230);
+    REQUIRE(rrd.open(1).time == 240);
+    REQUIRE(rrd.level(2).size() == 2);
+    REQUIRE(rrd.open(2).time == 200);
+
+    auto const& minute = rrd.level(1)[3];
+    REQUIRE(minute.time == 30);
+    REQUIRE(minute.min == 30);
+    REQUIRE(minute.max == 39);
+    REQUIRE(minute.last == 39);
+    REQUIRE(minute.count == 10);
+    REQUIRE(minute.average() == 34.5);
+
+    auto const& hour = rrd.level(2)[1];
+    REQUIRE(hour.time == 100);
+    REQUIRE(hour.min == 100);
+    REQUIRE(hour.max == 199);
+    REQUIRE(hour.last == 199);
+    REQUIRE(hour.count == 100);
+    REQUIRE(hour.sum == 14950.0);
+
+    rrd.flush();
+    REQUIRE(rrd.open(0).count == 0);
+    REQUIRE(rrd.open(2).count == 0);
+    REQUIRE(rrd.level(0).back().time == 249);
+    REQUIRE(rrd.level(1).back().time == 240);
+    REQUIRE(rrd.level(2).back().time == 200);
+    REQUIRE(rrd.level(2).back().count == 50);
+    REQUIRE(rrd.level(2).back().min == 200);
+    REQUIRE(rrd.level(2).back().max == 249);
+}
+
+TEST_CASE("utl.round_robin_store. Flushing a step twice")
+{
+    RoundRobinStore<double, 16, 3> rrd{{1, 60, 120}};
+    rrd.push(0, 0.0);
+    rrd.push(1, 1.0);
+    rrd.flush();
+    REQUIRE(rrd.level(1).size() == 1);
+    REQUIRE(rrd.level(1).back().average() == 0.5);
+
+    rrd.push(2, 2.0);
+    rrd.push(3, 3.0);
+    rrd.flush();
+
+    // The step of the finest level closes anew, the coarser levels extend their last row
+    REQUIRE(rrd.level(0).size() == 4);
+    for (std::size_t level = 1; level < rrd.levels(); ++level)
+    {
+        auto const& ring = rrd.level(level);
+        REQUIRE(ring.size() == 1);
+        REQUIRE(ring.back().time == 0);
+        REQUIRE(ring.back().count == 4);
+        REQUIRE(ring.back().average() == 1.5);
+        REQUIRE(ring.back().min == 0.0);
+        REQUIRE(ring.back().max == 3.0);
+        REQUIRE(ring.back().last == 3.0);
+    }
+
+    rrd.push(60, 60.0);
+    rrd.flush();
+    REQUIRE(rrd.level(1).size() == 2);
+    REQUIRE(rrd.level(1).back().time == 60);
+    REQUIRE(rrd.level(2).size() == 1);
+    REQUIRE(rrd.level(2).back().count == 5);
+}
+
+TEST_CASE("utl.round_robin_store. Queries pick the resolution")
+{
+    RoundRobinStore<double, 16, 3> rrd{{1, 4, 16}};
+    for (std::uint64_t t = 0; t < 200; ++t)
+    {
+        rrd.push(t, static_cast<double>(t % 7));
+    }
+    rrd.flush();
+
+    // The finest level still holds 184 and later
+    auto range = rrd.query(190, 195);
+    REQUIRE(range.level == 0);
+    REQUIRE(range.size() == 5);
+    auto rows = rowsOf(range);
+    REQUIRE(rows.front().time == 190);
+    REQUIRE(rows.back().time == 194);
+
+    // Level 1 holds 136 and later
+    range = rrd.query(150, 200);
+    REQUIRE(range.level == 1);
+    rows = rowsOf(range);
+    REQUIRE(rows.size() == 12);
+    REQUIRE(rows.front().time == 152);
+    REQUIRE(rows.back().time == 196);
+
+    // Nothing reaches back to 0, the coarsest level is used
+    range = rrd.query(0, 1000);
+    REQUIRE(range.level == 2);
+    REQUIRE(range.size() == 13);
+
+    // In [184, 200) level 0 has 16 rows, level 1 has 4 and level 2 has 1
+    range = rrd.query(184, 200, 3);
+    REQUIRE(range.level == 2);
+    REQUIRE(range.size() == 1);
+    range = rrd.query(184, 200, 4);
+    REQUIRE(range.level == 1);
+    REQUIRE(range.size() == 4);
+
+    // A level can be queried explicitly
+    range = rrd.rows(0, 0, 1000);
+    REQUIRE(range.level == 0);
+    REQUIRE(range.size() == 16);
+    range = rrd.rows(1, 0, 140);
+    REQUIRE(range.size() == 1);
+    REQUIRE(range.first.size() + range.second.size() == 1);
+    REQUIRE(rrd.rows(2, 500, 1000).empty());
+}
+
+TEST_CASE("utl.round_robin_store. Gaps")
+{
+    RoundRobinStore<int, 8, 2> rrd{{10, 100}};
+    rrd.push(5, 1);
+    rrd.push(7, 2);
+    rrd.push(35, 3);
+    rrd.push(250, 4);
+    rrd.push(251, -4);
+
+    // Steps without samples have no row
+    REQUIRE(rrd.level(0).size() == 2);
+    REQUIRE(rrd.level(0)[0].time == 0);
+    REQUIRE(rrd.level(0)[0].count == 2);
+    REQUIRE(rrd.level(0)[1].time == 30);
+    REQUIRE(rrd.open(0).time == 250);
+    REQUIRE(rrd.open(0).min == -4);
+    REQUIRE(rrd.open(0).last == -4);
+
+    // The step of level 1 starting at 0 is open until a row of a later step arrives
+    REQUIRE(rrd.level(1).empty());
+    REQUIRE(rrd.open(1).time == 0);
+    REQUIRE(rrd.open(1).count == 3);
+
+    rrd.push(262, 7);
+    REQUIRE(rrd.level(1).size() == 1);
+    REQUIRE(rrd.level(1)[0].time == 0);
+    REQUIRE(rrd.level(1)[0].min == 1);
+    REQUIRE(rrd.level(1)[0].max == 3);
+    REQUIRE(rrd.level(1)[0].last == 3);
+    REQUIRE(rrd.open(1).time == 200);
+    REQUIRE(rrd.open(1).count == 2);
+}
+
+TEST_CASE("utl.round_robin_store. Matches consolidation of the raw samples")
+{
+    constexpr std::size_t capacity = 32;
+    std::array<std::uint64_t, 3> const steps{5, 30, 300};
+    auto rrd = std::make_unique<RoundRobinStore<int, capacity, 3>>(steps);
+
+    std::mt19937 random{42};
+    std::vector<std::pair<std::uint64_t, int>> samples;
+    std::uint64_t time = 0;
+    for (int i = 0; i < 20000; ++i)
+    {
+        time += random() % 4 == 0 ? random() % 50 : random() % 3;
+        auto const value = static_cast<int>(random() % 1000) - 500;
+        samples.emplace_back(time, value);
+        rrd->push(time, value);
+    }
+    rrd->flush();
+
+    for (std::size_t level = 0; level < steps.size(); ++level)
+    {
+        std::map<std::uint64_t, RoundRobinRow<int>> expected;
+        for (auto const& [t, value] : samples)
+        {
+            auto const start = t - t % steps[level];
+            auto const [it, inserted] = expected.try_emplace(start, RoundRobinRow<int>{start, value, value, value, 0.0, 0});
+            auto& row = it->second;
+            row.min = std::min(row.min, value);
+            row.max = std::max(row.max, value);
+            row.last = value;
+            row.sum += value;
+            ++row.count;
+        }
+
+        auto const& rows = rrd->level(level);
+        REQUIRE(rows.size() == std::min(capacity, expected.size()));
+        auto it = std::prev(expected.end(), static_cast<std::ptrdiff_t>(rows.size()));
+        for (auto const& row : rows)
+        {
+            auto const& want = (it++)->second;
+            REQUIRE(row.time == want.time);
+            REQUIRE(row.min == want.min);
+            REQUIRE(row.max == want.max);
+            REQUIRE(row.last == want.last);
+            REQUIRE(row.sum == want.sum);
+            REQUIRE(row.count == want.count);
+        }
+    }
+}
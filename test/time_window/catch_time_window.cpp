@@ -0,0 +1,128 @@
+//
+// Test harnesses for TimeWindow<T, N>
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#define CATCH_CONFIG_MAIN
+
+#include "time_window.hpp"
+#include "catch.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <random>
+#include <utility>
+
+using namespace TM_NAMESPACE_NAME;
+
+TEST_CASE("utl.time_window. Samples expire")
+{
+    TimeWindow<int, 8> tw{100};
+    REQUIRE(tw.window() == 100);
+    REQUIRE(tw.capacity() == 8);
+    REQUIRE(tw.empty());
+    REQUIRE(tw.statistics(1000).count == 0);
+
+    tw.push(1000, 5);
+    tw.push(1010, 3);
+    tw.push(1050, 9);
+    auto s = tw.statistics();
+    REQUIRE(s.count == 3);
+    REQUIRE(s.sum == 17);
+    REQUIRE(s.min == 3);
+    REQUIRE(s.max == 9);
+
+    // The sample at 1000 leaves the window at 1100
+    s = tw.statistics(1099);
+    REQUIRE(s.count == 3);
+    s = tw.statistics(1100);
+    REQUIRE(s.count == 2);
+    REQUIRE(s.sum == 12);
+    REQUIRE(s.min == 3);
+    REQUIRE(s.mean() == 6.0);
+
+    // Pushing expires as well
+    tw.push(1120, 4);
+    s = tw.statistics();
+    REQUIRE(s.count == 2);
+    REQUIRE(s.sum == 13);
+    REQUIRE(s.min == 4);
+    REQUIRE(s.max == 9);
+
+    s = tw.statistics(10000);
+    REQUIRE(s.count == 0);
+    REQUIRE(s.sum == 0);
+    REQUIRE(tw.empty());
+}
+
+TEST_CASE("utl.time_window. Capacity bound")
+{
+    TimeWindow<int, 4> tw{1000};
+    for (int i = 1; i <= 6; ++i)
+    {
+        tw.push(static_cast<std::uint64_t>(i), i);
+    }
+    auto const s = tw.statistics(6);
+    REQUIRE(s.count == 4);
+    REQUIRE(s.sum == 3 + 4 + 5 + 6);
+    REQUIRE(s.min == 3);
+    REQUIRE(s.max == 6);
+}
+
+TEST_CASE("utl.time_window. Time does not go backwards")
+{
+    TimeWindow<int, 4> tw{10};
+    tw.push(100, 1);
+    tw.push(50, 2);
+    REQUIRE(tw.samples().back().time == 100);
+    REQUIRE(tw.statistics(109).count == 2);
+    REQUIRE(tw.statistics(110).count == 0);
+}
+
+TEST_CASE("utl.time_window. Agrees with recomputing the window")
+{
+    constexpr std::size_t N = 64;
+    TimeWindow<double, N> tw{1000};
+    TimeWindow<std::int64_t, N> integral{1000};
+    std::deque<std::pair<std::uint64_t, double>> reference;
+    std::mt19937 gen{42};
+    std::uniform_real_distribution<double> value{-100.0, 100.0};
+    std::geometric_distribution<int> gap{0.05};
+
+    std::uint64_t now = 0;
+    for (int i = 0; i < 20000; ++i)
+    {
+        now += static_cast<std::uint64_t>(gap(gen));
+        auto const x = value(gen);
+        tw.push(now, x);
+        integral.push(now, static_cast<std::int64_t>(x));
+        reference.emplace_back(now, x);
+        while (reference.size() > N || (now >= 1000 && reference.front().first <= now - 1000))
+        {
+            reference.pop_front();
+        }
+
+        auto const s = tw.statistics();
+        REQUIRE(s.count == reference.size());
+        double sum = 0.0;
+        std::int64_t integralSum = 0;
+        auto min = reference.front().second;
+        auto max = min;
+        for (auto const& [time, v] : reference)
+        {
+            sum += v;
+            integralSum += static_cast<std::int64_t>(v);
+            min = std::min(min, v);
+            max = std::max(max, v);
+        }
+        REQUIRE(s.sum == Approx(sum).margin(1e-9));
+        REQUIRE(s.min == min);
+        REQUIRE(s.max == max);
+        REQUIRE(integral.statistics().sum == integralSum);
+        REQUIRE(integral.statistics().count == reference.size());
+    }
+}
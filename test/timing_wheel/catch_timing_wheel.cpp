@@ -0,0 +1,211 @@
+//
+// Test harnesses for TimingWheel
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#define CATCH_CONFIG_MAIN
+
+#include "timing_wheel.hpp"
+#include "catch.hpp"
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace TW_NAMESPACE_NAME;
+
+// Element class counting live instances
+struct Element
+{
+    static inline int instances = 0;
+    unsigned int val;
+
+    Element(unsigned int val)
+        : val{val}
+    {
+        ++instances;
+    }
+
+    Element(Element const& other)
+        : val{other.val}
+    {
+        ++instances;
+    }
+
+    ~Element()
+    {
+        val = 0xDEADDEAD;
+        --instances;
+    }
+};
+
+TEST_CASE("utl.timing_wheel. Schedule and fire")
+{
+    auto wheel = std::make_unique<TimingWheel<Element, 16>>(1000);
+    REQUIRE(wheel->now() == 1000);
+    REQUIRE(wheel->empty());
+    REQUIRE(wheel->capacity() == 16);
+
+    std::vector<unsigned int> fired;
+    auto const collect = [&](Element& e) { fired.push_back(e.val); };
+
+    REQUIRE(wheel->schedule(1010, 1u));
+    REQUIRE(wheel->schedule(1005, 2u));
+    REQUIRE(wheel->schedule(1100, 3u));
+    REQUIRE(wheel->schedule(5000, 4u));
+    REQUIRE(wheel->size() == 4);
+    REQUIRE(Element::instances == 4);
+
+    REQUIRE(wheel->tick(1004, collect) == 0);
+    REQUIRE(wheel->now() == 1004);
+    REQUIRE(wheel->tick(1005, collect) == 1);
+    REQUIRE(fired == std::vector<unsigned int>{2});
+
+    REQUIRE(wheel->tick(1200, collect) == 2);
+    REQUIRE(fired == std::vector<unsigned int>{2, 1, 3});
+    REQUIRE(wheel->size() == 1);
+
+    // Going back in time does nothing
+    REQUIRE(wheel->tick(100, collect) == 0);
+    REQUIRE(wheel->now() == 1200);
+
+    // A deadline in the past fires on the next tick
+    REQUIRE(wheel->schedule(10, 5u));
+    REQUIRE(wheel->tick(1200, collect) == 0);
+    REQUIRE(wheel->tick(1201, collect) == 1);
+    REQUIRE(fired.back() == 5);
+
+    REQUIRE(wheel->tick(4999, collect) == 0);
+    REQUIRE(wheel->tick(5000, collect) == 1);
+    REQUIRE(fired.back() == 4);
+    REQUIRE(wheel->empty());
+    REQUIRE(Element::instances == 0);
+}
+
+TEST_CASE("utl.timing_wheel. Cancel")
+{
+    auto wheel = std::make_unique<TimingWheel<Element, 2>>();
+    std::vector<unsigned int> fired;
+    auto const collect = [&](Element& e) { fired.push_back(e.val); };
+
+    REQUIRE_FALSE(wheel->cancel(TimerId{}));
+
+    auto a = wheel->schedule(10, 1u);
+    auto b = wheel->schedule(10, 2u);
+    REQUIRE(a != b);
+
+    // Exhausted
+    REQUIRE_FALSE(wheel->schedule(10, 3u));
+    REQUIRE(Element::instances == 2);
+
+    REQUIRE(wheel->cancel(a));
+    REQUIRE_FALSE(wheel->cancel(a));
+    REQUIRE(Element::instances == 1);
+
+    // The node is reused, the old id stays invalid
+    auto c = wheel->schedule(20, 3u);
+    REQUIRE(c);
+    REQUIRE(c != a);
+    REQUIRE_FALSE(wheel->cancel(a));
+
+    REQUIRE(wheel->tick(10, collect) == 1);
+    REQUIRE(fired == std::vector<unsigned int>{2});
+    REQUIRE_FALSE(wheel->cancel(b));
+    REQUIRE(wheel->cancel(c));
+    REQUIRE(wheel->tick(100, collect) == 0);
+    REQUIRE(Element::instances == 0);
+}
+
+TEST_CASE("utl.timing_wheel. Timers are destroyed with the wheel")
+{
+    {
+        auto wheel = std::make_unique<TimingWheel<Element, 8>>();
+        for (unsigned int i = 0; i < 8; ++i)
+        {
+            REQUIRE(wheel->schedule(i * 1000, i));
+        }
+        wheel->tick(2500, [](Element&) {});
+        REQUIRE(Element::instances == 5);
+    }
+    REQUIRE(Element::instances == 0);
+}
+
+TEST_CASE("utl.timing_wheel. Callbacks schedule and cancel timers")
+{
+    auto wheel = std::make_unique<TimingWheel<unsigned int, 8>>();
+    std::vector<std::uint64_t> fired;
+    TimerId victim = wheel->schedule(105, 0u);
+    wheel->schedule(100, 1u);
+
+    // Periodic timer every 30 ticks which cancels the victim on its first run
+    auto const periodic = [&](unsigned int& val) {
+        fired.push_back(wheel->now());
+        wheel->cancel(victim);
+        if (val == 1 && fired.size() < 4)
+        {
+            wheel->schedule(wheel->now() + 30, 1u);
+        }
+    };
+    REQUIRE(wheel->tick(1000, periodic) == 4);
+    REQUIRE(fired == std::vector<std::uint64_t>{100, 130, 160, 190});
+    REQUIRE(wheel->empty());
+}
+
+TEST_CASE("utl.timing_wheel. Random deadlines fire exactly once and on time")
+{
+    // 2 levels cover 4096 ticks, later deadlines go through the overflow list
+    auto wheel = std::make_unique<TimingWheel<unsigned int, 4096, 2>>();
+    std::mt19937_64 gen{42};
+    std::multimap<std::uint64_t, unsigned int> expected;
+    std::vector<TimerId> ids;
+    unsigned int next = 0;
+    std::uint64_t now = 0;
+    for (int round = 0; round < 200; ++round)
+    {
+        for (int i = 0; i < 16; ++i)
+        {
+            auto const range = std::uint64_t{1} << std::uniform_int_distribution<int>{0, 20}(gen);
+            auto const deadline = now + std::uniform_int_distribution<std::uint64_t>{0, range}(gen);
+            auto id = wheel->schedule(deadline, next);
+            REQUIRE(id);
+            expected.emplace(std::max(deadline, now + 1), next++);
+            ids.push_back(id);
+        }
+
+        // Cancel some
+        for (int i = 0; i < 4; ++i)
+        {
+            auto const index = std::uniform_int_distribution<std::size_t>{0, ids.size() - 1}(gen);
+            if (wheel->cancel(ids[index]))
+            {
+                auto const val = static_cast<unsigned int>(index);
+                auto it = std::find_if(expected.begin(), expected.end(), [&](auto const& e) { return e.second == val; });
+                REQUIRE(it != expected.end());
+                expected.erase(it);
+            }
+        }
+
+        auto const previous = now;
+        now += std::uniform_int_distribution<std::uint64_t>{0, 1 << 16}(gen);
+        std::vector<std::pair<std::uint64_t, unsigned int>> fired;
+        wheel->tick(now, [&](unsigned int val) { fired.emplace_back(wheel->now(), val); });
+
+        // Timers fire in order of deadlines, in any order for equal deadlines
+        REQUIRE(std::is_sorted(fired.begin(), fired.end(), [](auto const& a, auto const& b) { return a.first < b.first; }));
+        std::sort(fired.begin(), fired.end());
+        std::vector<std::pair<std::uint64_t, unsigned int>> due{expected.begin(), expected.upper_bound(now)};
+        std::sort(due.begin(), due.end());
+        expected.erase(expected.begin(), expected.upper_bound(now));
+        REQUIRE(fired == due);
+        if (!fired.empty())
+        {
+            REQUIRE(fired.front().first > previous);
+        }
+        REQUIRE(wheel->size() == expected.size());
+    }
+}
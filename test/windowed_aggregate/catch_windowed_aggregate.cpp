@@ -0,0 +1,152 @@
+//
+// Test harnesses for WindowedAggregate<T, N, Ops...>
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#define CATCH_CONFIG_MAIN
+
+#include "windowed_aggregate.hpp"
+#include "catch.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <numeric>
+#include <random>
+
+using namespace WA_NAMESPACE_NAME;
+
+TEST_CASE("utl.windowed_aggregate. Overwrite on full")
+{
+    WindowedAggregate<int, 4, WindowSum, WindowMean, WindowMin, WindowMax> wa;
+    REQUIRE(wa.empty());
+    REQUIRE(wa.capacity() == 4);
+    REQUIRE(wa.window() == 4);
+    REQUIRE(wa.value<WindowSum>() == 0);
+    REQUIRE(wa.value<WindowMean>() == 0.0);
+
+    wa.push(3);
+    REQUIRE(wa.value<WindowSum>() == 3);
+    REQUIRE(wa.value<WindowMin>() == 3);
+    REQUIRE(wa.value<WindowMax>() == 3);
+
+    wa.push(1);
+    wa.push(4);
+    wa.push(1);
+    REQUIRE(wa.full());
+    REQUIRE(wa.value<WindowSum>() == 9);
+    REQUIRE(wa.value<WindowMean>() == 2.25);
+    REQUIRE(wa.value<WindowMin>() == 1);
+    REQUIRE(wa.value<WindowMax>() == 4);
+
+    // 3 is evicted
+    wa.push(5);
+    REQUIRE(wa.size() == 4);
+    REQUIRE(wa.front() == 1);
+    REQUIRE(wa.back() == 5);
+    REQUIRE(wa.value<WindowSum>() == 11);
+    REQUIRE(wa.value<WindowMax>() == 5);
+
+    // 1, 4 are evicted
+    wa.push(0);
+    wa.push(2);
+    REQUIRE(std::vector<int>(wa.samples().begin(), wa.samples().end()) == std::vector<int>{1, 5, 0, 2});
+    REQUIRE(wa.value<WindowSum>() == 8);
+    REQUIRE(wa.value<WindowMin>() == 0);
+    REQUIRE(wa.value<WindowMax>() == 5);
+
+    wa.clear();
+    REQUIRE(wa.empty());
+    REQUIRE(wa.value<WindowSum>() == 0);
+    wa.push(7);
+    REQUIRE(wa.value<WindowMin>() == 7);
+    REQUIRE(wa.value<WindowMax>() == 7);
+}
+
+TEST_CASE("utl.windowed_aggregate. Window length and explicit eviction")
+{
+    WindowedAggregate<int, 8, WindowSum, WindowMin> wa;
+    for (int i = 1; i <= 8; ++i)
+    {
+        wa.push(i);
+    }
+    REQUIRE(wa.value<WindowSum>() == 36);
+
+    wa.window(3);
+    REQUIRE(wa.window() == 3);
+    REQUIRE(wa.size() == 3);
+    REQUIRE(wa.value<WindowSum>() == 21);
+    REQUIRE(wa.value<WindowMin>() == 6);
+
+    wa.push(9);
+    REQUIRE(wa.size() == 3);
+    REQUIRE(wa.value<WindowSum>() == 24);
+
+    wa.pop();
+    REQUIRE(wa.size() == 2);
+    REQUIRE(wa.value<WindowSum>() == 17);
+    REQUIRE(wa.value<WindowMin>() == 8);
+    wa.pop();
+    wa.pop();
+    REQUIRE(wa.empty());
+    REQUIRE(wa.value<WindowSum>() == 0);
+
+    wa.window(100);
+    REQUIRE(wa.window() == 8);
+}
+
+TEST_CASE("utl.windowed_aggregate. Agrees with recomputing the window")
+{
+    constexpr std::size_t N = 100;
+    WindowedAggregate<double, N, WindowSum, WindowMean, WindowVariance, WindowMin, WindowMax> wa;
+    std::deque<double> reference;
+    std::mt19937 gen{42};
+    std::normal_distribution<double> dist{1000.0, 50.0};
+    std::uniform_int_distribution<std::size_t> window{1, N};
+
+    for (int i = 0; i < 20000; ++i)
+    {
+        if (i % 5000 == 4999)
+        {
+            wa.window(window(gen));
+        }
+        auto const x = dist(gen);
+        wa.push(x);
+        reference.push_back(x);
+        while (reference.size() > wa.window())
+        {
+            reference.pop_front();
+        }
+
+        auto const n = static_cast<double>(reference.size());
+        auto const sum = std::accumulate(reference.begin(), reference.end(), 0.0);
+        auto const mean = sum / n;
+        auto const variance =
+            std::accumulate(reference.begin(), reference.end(), 0.0, [&](double a, double v) { return a + (v - mean) * (v - mean); }) / n;
+
+        REQUIRE(wa.value<WindowSum>() == Approx(sum).epsilon(1e-12));
+        REQUIRE(wa.value<WindowMean>() == Approx(mean).epsilon(1e-12));
+        REQUIRE(wa.value<WindowVariance>() == Approx(variance).epsilon(1e-6).margin(1e-9));
+        REQUIRE(wa.value<WindowMin>() == *std::min_element(reference.begin(), reference.end()));
+        REQUIRE(wa.value<WindowMax>() == *std::max_element(reference.begin(), reference.end()));
+    }
+    REQUIRE(wa.aggregate<WindowVariance>().sampleVariance(wa.size()) > wa.value<WindowVariance>());
+}
+
+TEST_CASE("utl.windowed_aggregate. Compensated sum does not drift")
+{
+    WindowedAggregate<double, 3, WindowSum> wa;
+    for (int i = 0; i < 100000; ++i)
+    {
+        wa.push(i % 3 == 0 ? 1e16 : 1.0);
+    }
+    // The window holds 1e16 and two times 1.0 in some order
+    REQUIRE(wa.value<WindowSum>() == 1e16 + 2.0);
+    wa.push(0.1);
+    wa.push(0.2);
+    wa.push(0.3);
+    REQUIRE(wa.value<WindowSum>() == Approx(0.6).epsilon(1e-15));
+}
@@ -0,0 +1,118 @@
+//
+// Test harnesses for WindowedQuantile<T, N>
+//
+// Copyright(c) 2020 Chronimal. All rights reserved.
+//
+// Licensed under the MIT license; A copy of the license that can be
+// found in the LICENSE file.
+//
+
+#define CATCH_CONFIG_MAIN
+
+#include "windowed_quantile.hpp"
+#include "catch.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace WQ_NAMESPACE_NAME;
+
+TEST_CASE("utl.windowed_quantile. Median and percentiles")
+{
+    WindowedQuantile<int, 5> wq;
+    REQUIRE(wq.empty());
+    REQUIRE(wq.capacity() == 5);
+
+    wq.push(7);
+    REQUIRE(wq.median() == 7);
+    REQUIRE(wq.quantile(0.0) == 7);
+    REQUIRE(wq.quantile(1.0) == 7);
+
+    for (int value : {3, 9, 1, 5})
+    {
+        wq.push(value);
+    }
+    // Window 7 3 9 1 5, sorted 1 3 5 7 9
+    REQUIRE(wq.size() == 5);
+    REQUIRE(wq.nth(0) == 1);
+    REQUIRE(wq.nth(4) == 9);
+    REQUIRE(wq.median() == 5);
+    REQUIRE(wq.quantile(0.2) == 1);
+    REQUIRE(wq.quantile(0.21) == 3);
+    REQUIRE(wq.quantile(0.95) == 9);
+
+    // 7 is evicted, sorted 1 3 5 8 9
+    wq.push(8);
+    REQUIRE(wq.median() == 5);
+    REQUIRE(wq.quantile(0.8) == 8);
+
+    // 3 and 9 are evicted, sorted 1 5 8
+    wq.window(3);
+    REQUIRE(wq.size() == 3);
+    REQUIRE(wq.nth(0) == 1);
+    REQUIRE(wq.median() == 5);
+    REQUIRE(wq.nth(2) == 8);
+
+    wq.pop();
+    wq.pop();
+    REQUIRE(wq.size() == 1);
+    REQUIRE(wq.median() == 8);
+
+    wq.clear();
+    REQUIRE(wq.empty());
+    wq.push(2);
+    REQUIRE(wq.median() == 2);
+}
+
+TEST_CASE("utl.windowed_quantile. Equal values")
+{
+    WindowedQuantile<int, 4> wq;
+    for (int i = 0; i < 100; ++i)
+    {
+        wq.push(i % 8 < 4 ? 1 : 2);
+        auto const ones = static_cast<std::size_t>(std::count(wq.samples().begin(), wq.samples().end(), 1));
+        for (std::size_t rank = 0; rank < wq.size(); ++rank)
+        {
+            REQUIRE(wq.nth(rank) == (rank < ones ? 1 : 2));
+        }
+    }
+}
+
+TEST_CASE("utl.windowed_quantile. Agrees with sorting the window")
+{
+    constexpr std::size_t N = 257;
+    auto wq = std::make_unique<WindowedQuantile<double, N>>();
+    std::deque<double> reference;
+    std::mt19937 gen{42};
+    std::lognormal_distribution<double> dist{3.0, 1.0};
+    std::uniform_int_distribution<std::size_t> window{1, N};
+
+    for (int i = 0; i < 20000; ++i)
+    {
+        if (i % 3000 == 2999)
+        {
+            wq->window(window(gen));
+        }
+        // Rounding produces duplicates
+        auto const x = std::round(dist(gen));
+        wq->push(x);
+        reference.push_back(x);
+        while (reference.size() > wq->window())
+        {
+            reference.pop_front();
+        }
+        REQUIRE(wq->size() == reference.size());
+
+        std::vector<double> sorted(reference.begin(), reference.end());
+        std::sort(sorted.begin(), sorted.end());
+        auto const n = static_cast<double>(sorted.size());
+        for (double q : {0.0, 0.25, 0.5, 0.9, 0.95, 0.99, 1.0})
+        {
+            auto const rank = static_cast<std::size_t>(std::ceil(q * n));
+            REQUIRE(wq->quantile(q) == sorted[rank == 0 ? 0 : rank - 1]);
+        }
+    }
+}